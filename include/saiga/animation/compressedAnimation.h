@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include <saiga/config.h>
+#include <saiga/util/glm.h>
+#include <saiga/time/time.h>
+#include <saiga/animation/skeleton.h>
+#include <vector>
+
+namespace Saiga {
+
+class Animation;
+
+//The current key of every track. One cursor per playing instance.
+struct SAIGA_GLOBAL AnimationCursor{
+    std::vector<int> keys;
+    double lastTime = 0;
+};
+
+struct SAIGA_GLOBAL AnimationCompressionSettings{
+    //A key is removed, if the interpolation of its neighbours is closer than the tolerance.
+    //0 keeps all keys. The rotation tolerance is the maximum difference of a quaternion component.
+    float positionTolerance = 0.0005f;
+    float rotationTolerance = 0.0005f;
+    float scaleTolerance = 0.0005f;
+    //16 bit per component instead of float
+    bool quantize = true;
+};
+
+/**
+ * Every channel (position, rotation, scale) of every keyframed node is an independent track with its own keys.
+ * Keys that can be interpolated from their neighbours are removed, so constant channels only have one key.
+ * The remaining values are quantized to 16 bit relative to the range of the track.
+ *
+ * The tracks are sampled with an AnimationCursor, which stores the current key of every track.
+ * For a playing animation the lookup is O(1), because the cursor only moves forward.
+ */
+class SAIGA_GLOBAL CompressedAnimation{
+public:
+    Skeleton skeleton;
+    animationtime_t duration = animationtime_t(1);
+
+    void create(const Animation& animation, const AnimationCompressionSettings& settings = AnimationCompressionSettings());
+
+    void initCursor(AnimationCursor& cursor) const;
+
+    //Writes the local transformations at 'time' to 'pose'.
+    void sample(animationtime_t time, AnimationCursor& cursor, SkeletonPose& pose) const;
+
+    //sample + Skeleton::evaluate
+    void evaluate(animationtime_t time, AnimationCursor& cursor, SkeletonPose& pose, mat4* out, std::vector<mat4>& worldMatrices) const;
+
+    //Memory of the keys and tracks in bytes, without the skeleton.
+    size_t memoryUsage() const;
+    int numKeys() const { return keyTimes.size(); }
+
+private:
+    enum Channel{
+        Position = 0,
+        Rotation = 1,
+        Scaling = 2
+    };
+
+    struct Track{
+        int firstKey = 0;
+        int keyCount = 0;
+        //dequantization: value = offset + scale * q
+        vec4 offset;
+        vec4 scale;
+    };
+
+    //3 tracks per keyframed node
+    std::vector<Track> tracks;
+    //the keys of all tracks, 'firstKey' is the index in these arrays
+    std::vector<float> keyTimes;
+    std::vector<vec4> values;
+    struct QuantizedValue{
+        int16_t v[4];
+    };
+    std::vector<QuantizedValue> quantizedValues;
+    bool quantized = false;
+
+    vec4 getValue(const Track& track, int key) const;
+};
+
+}
@@ -0,0 +1,96 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include <saiga/config.h>
+#include <saiga/util/glm.h>
+#include <saiga/animation/boneVertex.h>
+
+#include <vector>
+#include <algorithm>
+
+namespace Saiga {
+
+//Positions and normals in SoA layout.
+struct SAIGA_GLOBAL VertexStreams{
+    std::vector<float> px, py, pz;
+    std::vector<float> nx, ny, nz;
+
+    int size() const { return px.size(); }
+    void resize(int n);
+};
+
+//The bind pose and bone weights of a mesh in SoA layout for CPU skinning.
+struct SAIGA_GLOBAL SkinnedMesh{
+    VertexStreams bindPose;
+    std::vector<int32_t> boneIndices[MAX_BONES_PER_VERTEX];
+    std::vector<float> boneWeights[MAX_BONES_PER_VERTEX];
+    int maxBoneIndex = -1;
+
+    int size() const { return bindPose.size(); }
+
+    //vertex_t must be derived from BoneVertex
+    template<typename vertex_t>
+    void create(const std::vector<vertex_t>& vertices);
+};
+
+/**
+ * The bone matrices as 3x4 matrices (the last row of an affine transformation is always 0,0,0,1).
+ * Stored row major with 12 floats per bone, so one row is a single 16 byte load.
+ */
+struct SAIGA_GLOBAL BonePalette{
+    std::vector<float> rows;
+
+    int size() const { return rows.size() / 12; }
+    void set(const std::vector<mat4>& boneMatrices);
+};
+
+/**
+ * Skins the vertices [begin,end) of 'mesh' and writes them to 'out' (which must have the size of the mesh).
+ * The bone indices are only checked once per call against maxBoneIndex.
+ * Same result as BoneVertex::apply for affine bone matrices, but 8 (AVX) or 4 (SSE) vertices are processed at once.
+ */
+SAIGA_GLOBAL void skinVertices(const SkinnedMesh& mesh, const BonePalette& palette, VertexStreams& out, int begin, int end);
+
+struct SAIGA_GLOBAL SkinningJob{
+    const SkinnedMesh* mesh = nullptr;
+    const BonePalette* palette = nullptr;
+    VertexStreams* out = nullptr;
+};
+
+//Skins all meshes. Each mesh is split into chunks of 'chunkSize' vertices and every chunk is one task on the default TaskScheduler.
+SAIGA_GLOBAL void skinMeshes(const std::vector<SkinningJob>& jobs, bool parallel = true, int chunkSize = 4096);
+
+
+
+template<typename vertex_t>
+void SkinnedMesh::create(const std::vector<vertex_t> &vertices)
+{
+    int n = vertices.size();
+    bindPose.resize(n);
+    for(int k = 0 ; k < MAX_BONES_PER_VERTEX ; ++k){
+        boneIndices[k].resize(n);
+        boneWeights[k].resize(n);
+    }
+    maxBoneIndex = -1;
+    for(int i = 0 ; i < n ; ++i){
+        const BoneVertex& v = vertices[i];
+        bindPose.px[i] = v.position.x;
+        bindPose.py[i] = v.position.y;
+        bindPose.pz[i] = v.position.z;
+        bindPose.nx[i] = v.normal.x;
+        bindPose.ny[i] = v.normal.y;
+        bindPose.nz[i] = v.normal.z;
+        for(int k = 0 ; k < MAX_BONES_PER_VERTEX ; ++k){
+            boneIndices[k][i] = v.boneIndices[k];
+            boneWeights[k][i] = v.boneWeights[k];
+            maxBoneIndex = std::max(maxBoneIndex,(int)v.boneIndices[k]);
+        }
+    }
+}
+
+}
@@ -32,14 +32,24 @@ struct SAIGA_GLOBAL ObjTriangle{
     GLuint v[3];
 };
 
+/**
+ * Wavefront .obj loader.
+ *
+ * The file is memory mapped, split into chunks at line boundaries and the chunks are parsed in parallel
+ * on the default TaskScheduler. Afterwards the chunks are merged in file order.
+ *
+ * With useBinaryCache the final vertices, triangles and groups are written to file + ".cache".
+ * Following loads read this file instead, if the size and modification time of the .obj file did not change.
+ */
 class SAIGA_GLOBAL ObjLoader2{
 public:
     std::string file;
     bool verbose = false;
+    bool useBinaryCache = false;
 
 public:
     ObjLoader2(){}
-    ObjLoader2(const std::string &file);
+    ObjLoader2(const std::string &file, bool useBinaryCache = false);
 
 
 
@@ -52,29 +62,24 @@ public:
     void separateVerticesByGroup();
     void calculateMissingNormals();
 
+    std::string cacheFile() const { return file + ".cache"; }
 private:
     std::vector<vec3> vertices;
     std::vector<vec3> normals;
     std::vector<vec2> texCoords;
-    std::vector<std::vector<IndexedVertex2>> faces;
+    //3 consecutive entries are one triangle
+    std::vector<IndexedVertex2> faces;
+    std::vector<std::string> materialFiles;
 
     ObjMaterialLoader materialLoader;
 
+    void clear();
+    bool parseFile();
     void createVertexIndexList();
+    void loadMaterialFile(const std::string &name);
 
-    std::vector<std::vector<IndexedVertex2>> triangulateFace(const std::vector<IndexedVertex2> &face);
-
-    void parseLine(const std::string &line);
-
-    void parseV(const std::string &line);
-    void parseVT(const std::string &line);
-    void parseVN(const std::string &line);
-    void parseF(std::string &line);
-    IndexedVertex2 parseIV(std::string &line);
-
-    void parseUM(const std::string &line);
-    void parseM(const std::string &line);
-
+    bool loadCache();
+    void saveCache();
 };
 
 }
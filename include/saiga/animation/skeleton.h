@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include <saiga/config.h>
+#include <saiga/util/glm.h>
+#include <saiga/time/time.h>
+#include <vector>
+
+namespace Saiga {
+
+class Animation;
+
+//The local transformations of all keyframed nodes of a skeleton (indexed by Skeleton::trackIndices).
+struct SAIGA_GLOBAL SkeletonPose{
+    std::vector<vec4> positions;
+    std::vector<quat> rotations;
+    std::vector<vec4> scalings;
+
+    void resize(int animatedCount);
+};
+
+/**
+ * The node tree of an Animation as flat arrays.
+ * The nodes are stored in depth first order, so every parent is stored before its children
+ * and the world matrices can be computed in one linear pass.
+ */
+class SAIGA_GLOBAL Skeleton{
+public:
+    int nodeCount = 0;
+    int boneCount = 0;
+    int animatedCount = 0; //number of keyframed nodes
+
+    std::vector<int> parents;       //-1 for the root
+    std::vector<int> boneIndices;   //-1 for nodes without bone
+    std::vector<int> trackIndices;  //index in the keyframe arrays, -1 if the node is not keyframed
+    std::vector<int> sourceNodes;   //index of the node in AnimationFrame::nodes
+    std::vector<mat4> localMatrices; //constant transformation of nodes that are not keyframed
+    std::vector<mat4> boneOffsets;
+    std::vector<int> unusedBones;   //bones without a node
+
+    void create(const Animation& animation);
+
+    //Computes the bone matrices (including the bone offsets) of a pose. 'worldMatrices' is resized to nodeCount.
+    void evaluate(const SkeletonPose& pose, mat4* out, std::vector<mat4>& worldMatrices) const;
+};
+
+/**
+ * An Animation with flat keyframes (structure of arrays) for fast evaluation.
+ * The result is equal to Animation::getFrame + AnimationFrame::getBoneMatrices without creating any AnimationFrame.
+ */
+class SAIGA_GLOBAL SkeletonAnimation{
+public:
+    Skeleton skeleton;
+    animationtime_t duration = animationtime_t(1);
+    int frameCount = 0;
+    std::vector<tickd_t> times;
+
+    //frameCount x animatedCount
+    std::vector<vec4> positions;
+    std::vector<quat> rotations;
+    std::vector<vec4> scalings;
+
+    void create(const Animation& animation);
+
+    /**
+     * Writes the bone matrices (including the bone offsets) at 'time' to 'out', which must have space for boneCount matrices.
+     * 'worldMatrices' is scratch memory for the node transformations. It is resized to nodeCount.
+     */
+    void evaluate(animationtime_t time, mat4* out, std::vector<mat4>& worldMatrices) const;
+};
+
+struct SAIGA_GLOBAL SkeletonEvaluation{
+    const SkeletonAnimation* animation = nullptr;
+    animationtime_t time = animationtime_t(0);
+    mat4* boneMatrices = nullptr;
+};
+
+//Evaluates many skeletons (for example all characters of a crowd) in parallel on the default TaskScheduler.
+SAIGA_GLOBAL void evaluateSkeletons(const std::vector<SkeletonEvaluation>& evaluations, bool parallel = true);
+
+}
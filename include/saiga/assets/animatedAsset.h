@@ -9,6 +9,7 @@
 #include <saiga/assets/asset.h>
 #include <saiga/opengl/texture/texture.h>
 #include "saiga/opengl/uniformBuffer.h"
+#include "saiga/animation/skeleton.h"
 
 namespace Saiga {
 
@@ -45,6 +46,11 @@ public:
     std::vector<mat4> inverseBoneOffsets;
 
     std::vector<Animation> animations;
+    //flat versions of 'animations' for the evaluation of the bone matrices
+    std::vector<SkeletonAnimation> skeletonAnimations;
+
+    //Has to be called by the loader after 'animations' are complete.
+    void createSkeletonAnimations();
 
 
     void render(Camera *cam, const mat4 &model, UniformBuffer& boneMatrices);
@@ -20,7 +20,9 @@ private:
     animationtime_t animationTimeAtRender = animationtime_t(0);
     int activeAnimation = 0;
 
-    AnimationFrame currentFrame;
+    std::vector<mat4> boneMatrices;
+    //scratch memory of the skeleton evaluation
+    std::vector<mat4> worldMatrices;
 
 
     //it's better to have the buffer here instead of in the asset, because otherwise it has to be uploaded for every render call (multiple times per frame)
@@ -35,6 +37,9 @@ private:
     void updateAnimation(float dt);
     void interpolateAnimation(float dt, float alpha);
 
+    //Same as calling interpolateAnimation on every object, but the bone matrices are computed in parallel.
+    static void interpolateAnimations(const std::vector<AnimatedAssetObject*>& objects, float dt, float alpha);
+
     void render(Camera *cam);
     void renderDepth(Camera *cam);
     void renderWireframe(Camera *cam);
@@ -43,6 +48,10 @@ private:
 private:
     std::shared_ptr<AnimatedAsset> asset = nullptr;
 
+    void updateRenderTime(float dt, float alpha);
+    SkeletonEvaluation getEvaluation();
+    void uploadBoneMatrices();
+
 };
 
 }
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <saiga/opengl/indexedVertexBuffer.h>
+#include <saiga/opengl/instancedBuffer.h>
 #include <saiga/opengl/shader/basic_shaders.h>
 #include <saiga/geometry/triangle_mesh.h>
 #include <saiga/geometry/aabb.h>
@@ -24,6 +25,18 @@ public:
     virtual void renderDepth(Camera *cam, const mat4 &model) = 0;
     virtual void renderWireframe(Camera *cam, const mat4 &model) = 0;
     virtual void renderRaw() = 0;
+
+    //Renders the asset once for every model matrix into the current depth buffer.
+    virtual void renderDepth(Camera *cam, const mat4* models, int count){
+        for(int i = 0 ; i < count ; ++i)
+            renderDepth(cam,models[i]);
+    }
+
+    //Same as render, but for many model matrices. Used by the RenderQueue.
+    virtual void renderInstanced(Camera *cam, const mat4* models, int count){
+        for(int i = 0 ; i < count ; ++i)
+            render(cam,models[i]);
+    }
 };
 
 
@@ -38,9 +51,15 @@ public:
     std::shared_ptr<MVPShader> forwardShader;
     std::shared_ptr<MVPShader> depthshader;
     std::shared_ptr<MVPShader> wireframeshader;
+    //Optional. Reads the model matrix from the vertex attributes 4-7 (see geometry/deferred_mvp_model_instancing.glsl).
+    std::shared_ptr<MVPShader> instancedShader;
+    //Optional. Same for the depth pass (see geometry/deferred_mvp_model_depth_instancing.glsl).
+    std::shared_ptr<MVPShader> instancedDepthShader;
 
     TriangleMesh<vertex_t,index_t> mesh;
     IndexedVertexBuffer<vertex_t,index_t> buffer;
+    InstancedBuffer<mat4> instanceBuffer;
+    int instanceCapacity = 0;
 
     /**
      * Use these for simple inefficient rendering.
@@ -52,6 +71,13 @@ public:
     virtual void renderDepth(Camera *cam, const mat4 &model) override;
     virtual void renderWireframe(Camera *cam, const mat4 &model) override;
 
+    //One instanced draw call with 'instancedDepthShader'.
+    //Without it the depth shader and the vertex buffer are only bound once for all instances.
+    virtual void renderDepth(Camera *cam, const mat4* models, int count) override;
+
+    //One instanced draw call with 'instancedShader'. Falls back to render() if there is no instanced shader.
+    virtual void renderInstanced(Camera *cam, const mat4* models, int count) override;
+
     /**
      * Renders the mesh.
      * This maps to a single glDraw call and nothing else, so the shader
@@ -78,6 +104,9 @@ public:
 
     void ZUPtoYUP();
 
+private:
+    //copies the model matrices to the instance buffer, which is attached to the vao
+    void uploadInstances(const mat4* models, int count);
 };
 
 template<typename vertex_t, typename index_t>
@@ -126,6 +155,58 @@ void BasicAsset<vertex_t,index_t>::renderDepth(Camera *cam, const mat4 &model)
     depthshader->unbind();
 }
 
+template<typename vertex_t, typename index_t>
+void BasicAsset<vertex_t,index_t>::renderDepth(Camera *cam, const mat4 *models, int count)
+{
+    (void)cam;
+    if(instancedDepthShader){
+        uploadInstances(models,count);
+        instancedDepthShader->bind();
+        buffer.bind();
+        buffer.drawInstanced(count);
+        buffer.unbind();
+        instancedDepthShader->unbind();
+        return;
+    }
+
+    depthshader->bind();
+    buffer.bind();
+    for(int i = 0 ; i < count ; ++i){
+        depthshader->uploadModel(models[i]);
+        buffer.draw();
+    }
+    buffer.unbind();
+    depthshader->unbind();
+}
+
+template<typename vertex_t, typename index_t>
+void BasicAsset<vertex_t,index_t>::uploadInstances(const mat4 *models, int count)
+{
+    if(count > instanceCapacity){
+        //the attribute pointers of the vao reference the old buffer
+        instanceCapacity = std::max(count,instanceCapacity * 2);
+        instanceBuffer.createGLBuffer(instanceCapacity);
+        buffer.addInstancedBuffer(instanceBuffer,4);
+    }
+    instanceBuffer.updateBuffer((void*)models,count,0);
+}
+
+template<typename vertex_t, typename index_t>
+void BasicAsset<vertex_t,index_t>::renderInstanced(Camera *cam, const mat4 *models, int count)
+{
+    if(!instancedShader){
+        Asset::renderInstanced(cam,models,count);
+        return;
+    }
+
+    uploadInstances(models,count);
+    instancedShader->bind();
+    buffer.bind();
+    buffer.drawInstanced(count);
+    buffer.unbind();
+    instancedShader->unbind();
+}
+
 template<typename vertex_t, typename index_t>
 void BasicAsset<vertex_t,index_t>::renderWireframe(Camera *cam, const mat4 &model)
 {
@@ -19,6 +19,8 @@ public:
     std::shared_ptr<MVPShader> basicAssetForwardShader;
     std::shared_ptr<MVPShader> basicAssetDepthshader;
     std::shared_ptr<MVPShader> basicAssetWireframeShader;
+    std::shared_ptr<MVPShader> basicAssetInstancedShader;
+    std::shared_ptr<MVPShader> basicAssetInstancedDepthShader;
 
     std::shared_ptr<MVPShader> texturedAssetShader;
     std::shared_ptr<MVPShader> texturedAssetForwardShader;
@@ -26,6 +26,7 @@ public:
 
     virtual void render(Camera *cam, const mat4 &model) override;
     virtual void renderDepth(Camera *cam, const mat4 &model) override;
+    virtual void renderDepth(Camera *cam, const mat4* models, int count) override;
 
 };
 
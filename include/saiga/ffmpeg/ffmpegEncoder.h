@@ -9,7 +9,7 @@
 #include "saiga/config.h"
 #include "saiga/image/image.h"
 #include "saiga/time/timer.h"
-#include "saiga/util/synchronizedBuffer.h"
+#include "saiga/util/lockfreeQueue.h"
 
 
 #include <fstream>
@@ -41,46 +41,61 @@ namespace Saiga {
 class SAIGA_GLOBAL FFMPEGEncoder{
 private:
     int outWidth, outHeight, inWidth, inHeight;
-
-
-
-    RingBuffer<std::shared_ptr<Image>> imageStorage;
-    SynchronizedBuffer<std::shared_ptr<Image>> imageQueue;
-
-    RingBuffer<AVFrame*> frameStorage;
-    SynchronizedBuffer<AVFrame*> frameQueue;
+    int bufferSize;
+    int scaleThreads;
+
+    //A frame that was added by the user. Only one of the members is set.
+    //Both members empty is the signal to stop the scale thread.
+    struct InputFrame{
+        std::shared_ptr<Image> image;
+        AVFrame* frame = nullptr;
+    };
+
+    //The free input buffers are allocated on demand, up to 'bufferSize' of each type.
+    //They are returned by the scale thread.
+    int allocatedImages = 0;
+    int allocatedInputFrames = 0;
+    SPSCQueue<std::shared_ptr<Image>> imageStorage;
+    SPSCQueue<AVFrame*> inputFrameStorage;
+    SPSCQueue<InputFrame> imageQueue;
+
+    //The scaled yuv frames. A nullptr in the frameQueue stops the encode thread.
+    SPSCQueue<AVFrame*> frameStorage;
+    SPSCQueue<AVFrame*> frameQueue;
 
     std::thread scaleThread; //scales and converts the image to the correct size and color format
     std::thread encodeThread; //does the actual encoding
 
-    volatile int currentFrame = 0;
-    volatile int finishedFrames = 0;
-
-    volatile bool running = false;
-    volatile bool finishScale = false;
-    volatile bool finishEncode = false;
-//    AVCodec *codec;
-//    AVCodecContext *c= NULL;
+    int currentFrame = 0;
+    std::atomic<int> finishedFrames;
 
     AVCodecContext *m_codecContext;
     AVFormatContext* m_formatCtx;
     int ticksPerFrame;
-    //AVPacket pkt;
-    SwsContext * ctx = nullptr;
-    Timer timer1, timer2, timer3;
-    void scaleFrame(std::shared_ptr<Image> image, AVFrame *frame);
+
+    //Frames that are waiting at the same time are scaled in parallel, one complete frame per context.
+    //A SwsContext can not be used by multiple threads. Slicing a frame is not exact for YUV420P,
+    //because the chroma filter needs the rows of the neighbour slices.
+    std::vector<SwsContext*> scaleContexts;
+
+    struct ScaleJob{
+        InputFrame input;
+        AVFrame* frame;
+    };
+    std::vector<ScaleJob> scaleJobs;
+
+    void createScaleContexts();
+    void scaleFrame(SwsContext* ctx, const InputFrame& input, AVFrame *frame);
     bool encodeFrame(AVFrame *frame, AVPacket &pkt);
     void writeFrame(AVPacket &pkt);
-    bool encodeFrame();
-    bool scaleFrame();
     void scaleThreadFunc();
     void encodeThreadFunc();
     int64_t getNextFramePts();
+    void freeBuffers();
 public:
-//    std::ofstream  outputStream;
-	//FILE *f;
-
-    FFMPEGEncoder(int bufferSize = 50);
+    //scaleThreads: maximum number of frames that are scaled in parallel.
+    //scaleThreads = -1: one for every thread of the default TaskScheduler
+    FFMPEGEncoder(int bufferSize = 50, int scaleThreads = -1);
 
     //Recommended codecs and container formats:
     //.mp4 AV_CODEC_ID_H264
@@ -88,8 +103,23 @@ public:
     //.avi AV_CODEC_ID_RAWVIDEO
     void startEncoding(const std::string &filename, int outWidth, int outHeight, int inWidth, int inHeight, int outFps, int bitRate,AVCodecID videoCodecId=AV_CODEC_ID_NONE);
     void createBuffers();
-    void addFrame(std::shared_ptr<Image> image);
+
+    //Returns a free RGBA image of the input size. Blocks if all buffers are in use.
+    //The first row is the bottom of the image (OpenGL convention).
     std::shared_ptr<Image> getFrameBuffer();
+    void addFrame(std::shared_ptr<Image> image);
+
+    //Zero copy interface:
+    //Returns a free RGBA AVFrame of the input size. The pixels can be written directly to
+    //frame->data[0] (for example with glReadPixels or from a mapped pixel buffer) and are read
+    //from there by the scaler. Rows are frame->linesize[0] bytes apart and 32 byte aligned.
+    //The first row is the bottom of the image (OpenGL convention).
+    AVFrame* getInputFrame();
+    void addFrame(AVFrame* frame);
+
+    //number of frames that were completely encoded
+    int encodedFrames(){ return finishedFrames; }
+
     void finishEncoding();
 };
 
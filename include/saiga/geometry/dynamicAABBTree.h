@@ -0,0 +1,131 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include <saiga/config.h>
+#include "saiga/util/glm.h"
+#include "saiga/geometry/aabb.h"
+#include "saiga/geometry/frustumCulling.h"
+
+#include <vector>
+
+namespace Saiga {
+
+/**
+ * A bounding volume hierarchy for moving objects.
+ *
+ * Every object (proxy) is stored in a leaf with an enlarged ('fat') bounding box.
+ * Moving an object only changes the tree, if the new box is not contained in the fat box anymore.
+ * In that case the leaf is removed and inserted again at the best sibling (surface area heuristic).
+ * The tree is kept balanced with rotations like an AVL tree.
+ *
+ * Based on the dynamic tree of Box2D (b2DynamicTree) by Erin Catto.
+ */
+class SAIGA_GLOBAL DynamicAABBTree
+{
+public:
+    //the fat boxes are enlarged by this value in every direction
+    float margin = 0.1f;
+
+    //scratch memory of the frustum query
+    struct QueryBuffer{
+        std::vector<std::pair<int,int>> stack;
+        AABBArray candidates;
+        std::vector<int> candidateData;
+        std::vector<unsigned char> candidateVisible;
+    };
+
+    //Returns the proxy id of the new object. 'userData' is returned by the queries.
+    int insert(const AABB& box, int userData);
+    void remove(int proxy);
+
+    //Returns true, if the leaf had to be moved in the tree.
+    bool move(int proxy, const AABB& box);
+
+    int getUserData(int proxy) const { return nodes[proxy].userData; }
+    const AABB& getFatAABB(int proxy) const { return nodes[proxy].box; }
+    const AABB& getAABB(int proxy) const { return nodes[proxy].tight; }
+
+    int size() const { return proxyCount; }
+    int height() const { return root == -1 ? 0 : nodes[root].height; }
+    void clear();
+
+    /**
+     * Appends the user data of all objects that are not culled by the frustum to 'result'.
+     * Subtrees completely inside the frustum are added without further tests.
+     * The exact boxes of the remaining leaves are tested in one batch with FrustumCuller::cullAABBs.
+     * Uses internal scratch memory, so only one query can run at the same time.
+     */
+    void query(const FrustumCuller& culler, std::vector<int>& result) const { query(culler,result,defaultBuffer); }
+
+    //Thread safe version with one QueryBuffer per thread.
+    void query(const FrustumCuller& culler, std::vector<int>& result, QueryBuffer& buffer) const;
+
+    //Calls 'op(userData)' for every object whose box intersects 'box'.
+    template<typename OP>
+    void query(const AABB& box, OP op) const;
+
+private:
+    struct Node{
+        AABB box;
+        //exact box of the object
+        AABB tight;
+        //parent node or next free node
+        int parent = -1;
+        int left = -1, right = -1;
+        //leaf = 0, free node = -1
+        int height = -1;
+        int userData = -1;
+
+        bool isLeaf() const { return left == -1; }
+    };
+
+    std::vector<Node> nodes;
+    int root = -1;
+    int freeList = -1;
+    int proxyCount = 0;
+
+    mutable QueryBuffer defaultBuffer;
+
+    int allocateNode();
+    void freeNode(int node);
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    int balance(int node);
+    void collectLeaves(int node, std::vector<int>& result) const;
+
+    static bool overlap(const AABB& a, const AABB& b){
+        return a.min.x <= b.max.x && a.max.x >= b.min.x
+                && a.min.y <= b.max.y && a.max.y >= b.min.y
+                && a.min.z <= b.max.z && a.max.z >= b.min.z;
+    }
+};
+
+
+template<typename OP>
+void DynamicAABBTree::query(const AABB &box, OP op) const
+{
+    if(root == -1)
+        return;
+    std::vector<int> s;
+    s.push_back(root);
+    while(!s.empty()){
+        const Node& n = nodes[s.back()];
+        s.pop_back();
+        if(!overlap(n.box,box))
+            continue;
+        if(n.isLeaf()){
+            if(overlap(n.tight,box))
+                op(n.userData);
+        }else{
+            s.push_back(n.left);
+            s.push_back(n.right);
+        }
+    }
+}
+
+}
@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include <saiga/config.h>
+#include "saiga/util/glm.h"
+#include "saiga/geometry/aabb.h"
+#include "saiga/geometry/sphere.h"
+#include "saiga/geometry/plane.h"
+
+#include <vector>
+
+namespace Saiga {
+
+//Spheres in SoA layout for the batched culling.
+struct SAIGA_GLOBAL SphereArray{
+    std::vector<float> x, y, z, r;
+
+    int size() const { return x.size(); }
+    void resize(int n){ x.resize(n); y.resize(n); z.resize(n); r.resize(n); }
+    void set(int i, const Sphere& s){ x[i] = s.pos.x; y[i] = s.pos.y; z[i] = s.pos.z; r[i] = s.r; }
+};
+
+//Boxes in SoA layout for the batched culling.
+struct SAIGA_GLOBAL AABBArray{
+    std::vector<float> minx, miny, minz, maxx, maxy, maxz;
+
+    int size() const { return minx.size(); }
+    void resize(int n){ minx.resize(n); miny.resize(n); minz.resize(n); maxx.resize(n); maxy.resize(n); maxz.resize(n); }
+    void set(int i, const AABB& b){
+        minx[i] = b.min.x; miny[i] = b.min.y; minz[i] = b.min.z;
+        maxx[i] = b.max.x; maxy[i] = b.max.y; maxz[i] = b.max.z;
+    }
+    void reserve(int n){ minx.reserve(n); miny.reserve(n); minz.reserve(n); maxx.reserve(n); maxy.reserve(n); maxz.reserve(n); }
+    void push_back(const AABB& b){
+        minx.push_back(b.min.x); miny.push_back(b.min.y); minz.push_back(b.min.z);
+        maxx.push_back(b.max.x); maxy.push_back(b.max.y); maxz.push_back(b.max.z);
+    }
+    void clear(){ resize(0); }
+};
+
+/**
+ * Frustum culling against the planes of a camera (Camera::planes).
+ * The plane normals point outwards, an object is culled if it lies completely on the positive side of one plane.
+ *
+ * The batched functions test 8 (AVX) or 4 (SSE) objects per instruction.
+ * The sphere test gives the same result as Camera::sphereInFrustum(s) != OUTSIDE.
+ */
+class SAIGA_GLOBAL FrustumCuller{
+public:
+    static const int maxPlanes = 6;
+
+    enum IntersectionResult{
+        OUTSIDE = 0,
+        INSIDE,
+        INTERSECT
+    };
+
+    FrustumCuller(){}
+    FrustumCuller(const Plane* planes, int count = maxPlanes){ setPlanes(planes,count); }
+
+    void setPlanes(const Plane* planes, int count = maxPlanes);
+
+    bool sphereVisible(const Sphere& s) const;
+    bool aabbVisible(const AABB& box) const;
+
+    /**
+     * AABB test for hierarchical culling.
+     * Only the planes in 'planeMask' (bit i = plane i) are tested. Planes that contain
+     * the box completely are removed from the mask, so they can be skipped for the children.
+     */
+    IntersectionResult classifyAABB(const AABB& box, int& planeMask) const;
+
+    //Writes 1 to 'visible' for every sphere/box that is not culled and returns the number of visible objects.
+    int cullSpheres(const SphereArray& spheres, unsigned char* visible) const;
+    int cullAABBs(const AABBArray& boxes, unsigned char* visible) const;
+
+    int allPlanes() const { return (1 << planeCount) - 1; }
+
+private:
+    int planeCount = 0;
+    //normal and d of every plane
+    vec4 planes[maxPlanes];
+};
+
+}
@@ -1,236 +1,414 @@
 /**
- * Copyright (c) 2017 Darius Rückert 
+ * Copyright (c) 2017 Darius Rückert
  * Licensed under the MIT License.
  * See LICENSE file for more information.
  */
 
-#pragma once
-
-#include <saiga/config.h>
-#include <vector>
-#include <algorithm>
-#include <saiga/util/glm.h>
-
-namespace Saiga {
-
-//D : Dimension. for example D=3 for 3 dimensional points
-//point_t : should be a glm vector type. for example vec2 or vec3
-template<int D, typename point_t>
-class SAIGA_TEMPLATE KDTree
-{
-public:
-    //create an empty tree
-    KDTree(){}
-    //calls 'createTree'
-    KDTree(const std::vector<point_t> &points);
-
-    //create a new tree with the given points.
-    //if this kdtree has already been build the old tree will be deleted.
-    void createTree(const std::vector<point_t> &points);
-
-    //returns the nearest point in this tree to the searchpoint
-    point_t nearestNeighbour(const point_t& searchPoint);
-
-    //returns the k nearest points in this tree to the searchpoint
-    std::vector<point_t> nearestNeighbours(const point_t& searchPoint, int k);
-private:
-    typedef int index_t;
-    typedef unsigned int axis_t;
-    typedef std::vector<std::pair<float,index_t>> queue_t;
-
-    struct kd_node_t{
-        point_t p;
-        index_t left = -1, right = -1;
-    };
-
-    std::vector<kd_node_t> nodes;
-    index_t rootNode = -1;
-
-    index_t sortByAxis(index_t startIndex, index_t endIndex, axis_t axis);
-    index_t make_tree(index_t startIndex, index_t endIndex, axis_t currentAxis);
-
-    //rekursive helper functions for nearest neighbour lookup
-    void nearestNeighbour(index_t currentNode, const point_t& searchPoint, axis_t currentAxis, index_t& bestNode, float &bestDist);
-    void nearestNeighbours(index_t currentNode, const point_t& searchPoint, int k, axis_t currentAxis, queue_t& queue);
-
-    float addToQueue(queue_t& queue, index_t currentNode, float distance);
-    float distance(point_t a, point_t b);
-    void printPoints(index_t startIndex, index_t endIndex);
-};
-
-template<int D, typename point_t>
-KDTree<D,point_t>::KDTree(const std::vector<point_t> &points)
-{
-    createTree(points);
-}
-
-template<int D, typename point_t>
-void KDTree<D,point_t>::createTree(const std::vector<point_t> &points)
-{
-    nodes.resize(points.size());
-    for(int i = 0 ; i < points.size() ; ++i){
-        nodes[i].p = points[i];
-    }
-    rootNode = make_tree(0,nodes.size(),0);
-}
-
-template<int D, typename point_t>
-typename KDTree<D,point_t>::index_t KDTree<D,point_t>::sortByAxis(index_t startIndex, index_t endIndex, axis_t axis)
-{
-    auto cmp = [axis](const kd_node_t& a, const kd_node_t& b) -> bool
-    {
-        return a.p[axis] < b.p[axis];
-    };
-    std::sort(nodes.begin()+startIndex,nodes.begin()+endIndex,cmp);
-    //return the median point
-    return (startIndex + endIndex) / 2;
-}
-
-template<int D, typename point_t>
-typename KDTree<D,point_t>::index_t KDTree<D,point_t>::make_tree(index_t startIndex, index_t endIndex, axis_t currentAxis)
-{
-    if (startIndex == endIndex) return -1;
-    if(startIndex+1 == endIndex) return startIndex;
-
-    index_t median = sortByAxis(startIndex,endIndex,currentAxis);
-    currentAxis = (currentAxis + 1) % D;
-
-
-    nodes[median].left  = make_tree(startIndex, median, currentAxis);
-    nodes[median].right = make_tree(median+1, endIndex, currentAxis);
-
-    return median;
-}
-
-template<int D, typename point_t>
-point_t KDTree<D,point_t>::nearestNeighbour(const point_t &searchPoint)
-{
-    KDTree::index_t bestNode;
-    float bestDist = 125625206456465;
-    nearestNeighbour(rootNode,searchPoint,0,bestNode,bestDist);
-    return nodes[bestNode].p;
-}
-
-
-template<int D, typename point_t>
-void KDTree<D,point_t>::nearestNeighbour(index_t currentNode, const point_t &searchPoint, axis_t currentAxis, index_t &bestNode, float &bestDist)
-{
-    if(currentNode == -1)
-        return;
-
-    //calculate distance to current point and update the current best
-    float d = distance(nodes[currentNode].p, searchPoint);
-    if (d < bestDist){
-        bestDist = d;
-        bestNode = currentNode;
-    }
-
-    //exact match (can't get any better)
-    if(d==0)
-        return;
-
-    //the (signed) distance of the searchpoint to the current split axis
-    float dAxis = nodes[currentNode].p[currentAxis] - searchPoint[currentAxis];
-    //the actual distance to the point is squared so we also need to square the distance to the axis
-    float dAxisSquared = dAxis * dAxis;
-
-    currentAxis = (currentAxis + 1) % D;
-
-    //first traverse the subtree in which the point lays
-    nearestNeighbour(dAxis > 0 ? nodes[currentNode].left : nodes[currentNode].right, searchPoint, currentAxis ,bestNode,  bestDist);
-
-    //when the distance to the axis is greater than the current distance
-    //we don't need to traverse the other sub tree
-    if (dAxisSquared >= bestDist) return;
-
-    //there may be a better point in this subtree
-    nearestNeighbour(dAxis > 0 ? nodes[currentNode].right : nodes[currentNode].left, searchPoint, currentAxis ,bestNode,  bestDist);
-}
-
-
-template<int D, typename point_t>
-std::vector<point_t> KDTree<D,point_t>::nearestNeighbours(const point_t &searchPoint,int k)
-{
-    queue_t queue(k);
-    for(auto& p : queue){
-        p.second = -1;
-        p.first = 3467369476;
-    }
-    nearestNeighbours(rootNode,searchPoint,k,0,queue);
-
-    std::vector<point_t> points;
-    for(auto& p : queue){
-        if(p.second != -1){
-            points.push_back(nodes[p.second].p);
-        }
-    }
-    return points;
-}
-
-
-template<int D, typename point_t>
-void KDTree<D,point_t>::nearestNeighbours(index_t currentNode, const point_t &searchPoint,int k, axis_t currentAxis,  queue_t& queue)
-{
-    if(currentNode == -1)
-        return;
-
-    //calculate distance to current point and update the current best
-    float d = distance(nodes[currentNode].p, searchPoint);
-    float lastD = addToQueue(queue,currentNode,d);
-
-
-    //the (signed) distance of the searchpoint to the current split axis
-    float dAxis = nodes[currentNode].p[currentAxis] - searchPoint[currentAxis];
-    //the actual distance to the point is squared so we also need to square the distance to the axis
-    float dAxisSquared = dAxis * dAxis;
-
-    currentAxis = (currentAxis + 1) % D;
-
-    //first traverse the subtree in which the point lays
-    nearestNeighbours(dAxis > 0 ? nodes[currentNode].left : nodes[currentNode].right, searchPoint,k, currentAxis ,queue);
-
-    //when the distance to the axis is greater than the current distance
-    //we don't need to traverse the other sub tree
-    if (dAxisSquared >= lastD) return;
-
-    //there may be a better point in this subtree
-    nearestNeighbours(dAxis > 0 ? nodes[currentNode].right : nodes[currentNode].left, searchPoint,k, currentAxis ,queue);
-
-    //    nearestNeighbour(dAxis > 0 ? nodes[currentNode].right : nodes[currentNode].left, searchPoint, currentAxis ,bestNode,  bestDist);
-}
-
-template<int D, typename point_t>
-float KDTree<D,point_t>::addToQueue(queue_t &queue, index_t currentNode, float distance)
-{
-    float lastD = queue[queue.size()-1].first;
-    if(distance >= lastD)
-        return lastD;
-
-    queue[queue.size()-1].first = distance;
-    queue[queue.size()-1].second = currentNode;
-
-    std::sort(queue.begin(),queue.end());
-
-
-    return queue[queue.size()-1].first;
-}
-
-
-
-template<int D, typename point_t>
-float KDTree<D,point_t>::distance(point_t a, point_t b)
-{
-    //use the squared distance so we don't have to calculate the sqrt
-    point_t tmp = a-b;
-    return glm::dot(tmp,tmp);
-}
-
-template<int D, typename point_t>
-void KDTree<D,point_t>::printPoints(index_t startIndex, index_t endIndex)
-{
-    for(index_t i = startIndex ; i < endIndex ; ++i){
-        cout << nodes[i].p << endl;
-    }
-}
-
-}
+#pragma once
+
+#include <saiga/config.h>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <saiga/util/glm.h>
+#include <saiga/util/taskScheduler.h>
+
+namespace Saiga {
+
+//D : Dimension. for example D=3 for 3 dimensional points
+//point_t : should be a glm vector type. for example vec2 or vec3
+template<int D, typename point_t>
+class SAIGA_TEMPLATE KDTree
+{
+public:
+    //Settings for approximate nearest neighbour queries.
+    //The default values give exact results.
+    struct Approximation{
+        //Subtrees are only searched if they can contain a point that is closer than
+        //'currentKthDistance / (1+eps)'. The returned distances are at most (1+eps) times the exact ones.
+        float eps = 0;
+        //Stop the search after this number of visited nodes (-1 = unlimited).
+        int maxVisits = -1;
+    };
+
+    //create an empty tree
+    KDTree(){}
+    //calls 'createTree'
+    KDTree(const std::vector<point_t> &points);
+
+    //create a new tree with the given points.
+    //if this kdtree has already been build the old tree will be deleted.
+    //the subtrees are build in parallel on the default TaskScheduler by up to 'threads' tasks at once
+    //(-1 = number of scheduler threads, 1 = only in the calling thread).
+    void createTree(const std::vector<point_t> &points, int threads = -1);
+
+    //returns the nearest point in this tree to the searchpoint
+    point_t nearestNeighbour(const point_t& searchPoint) const;
+
+    //returns the k nearest points in this tree to the searchpoint
+    std::vector<point_t> nearestNeighbours(const point_t& searchPoint, int k) const;
+
+    //Same as above, but without any memory allocation.
+    //Writes the indices (into the point list given to 'createTree') and the squared distances
+    //of the k nearest points to the output arrays, sorted by distance.
+    //Returns the number of found points, which is only less than k if the tree has less than k points.
+    //Nothing is written for k <= 0.
+    int nearestNeighbours(const point_t& searchPoint, int k, int* outIndices, float* outDistances,
+                          const Approximation& approx = Approximation()) const;
+
+    //Batched version of the function above for n searchpoints.
+    //The output arrays must have space for n*k elements. The results of searchpoint i start at i*k.
+    //The queries are distributed on the threads of 'scheduler' in chunks of 64 queries.
+    void nearestNeighbours(const point_t* searchPoints, int n, int k, int* outIndices, float* outDistances,
+                           const Approximation& approx = Approximation(), TaskScheduler& scheduler = defaultTaskScheduler()) const;
+
+    //Finds all points with a distance <= radius to the searchpoint.
+    //The indices are appended to 'outIndices' in no particular order. Returns the number of found points.
+    //Reuse the vector for multiple queries to avoid memory allocations.
+    int radiusSearch(const point_t& searchPoint, float radius, std::vector<int>& outIndices) const;
+
+    //returns the point with the given index (index into the list given to 'createTree')
+    point_t getPoint(int index) const { return nodes[nodeOfPoint[index]].p; }
+
+    int size() const { return nodes.size(); }
+private:
+    typedef int index_t;
+    typedef unsigned int axis_t;
+
+    struct kd_node_t{
+        point_t p;
+        //index of this point in the original point list
+        index_t id;
+        index_t left = -1, right = -1;
+    };
+
+    std::vector<kd_node_t> nodes;
+    std::vector<index_t> nodeOfPoint;
+    index_t rootNode = -1;
+
+    index_t sortByAxis(index_t startIndex, index_t endIndex, axis_t axis);
+    index_t make_tree(index_t startIndex, index_t endIndex, axis_t currentAxis, int parallelDepth);
+
+    //rekursive helper functions for nearest neighbour lookup
+    void nearestNeighbour(index_t currentNode, const point_t& searchPoint, axis_t currentAxis, index_t& bestNode, float &bestDist) const;
+    void nearestNeighbours(index_t currentNode, const point_t& searchPoint, int k, axis_t currentAxis, int& heapSize, index_t* heapNodes, float* heapDist,
+                           float pruneFactor, int& visitsLeft) const;
+    void radiusSearch(index_t currentNode, const point_t& searchPoint, float radiusSquared, axis_t currentAxis, std::vector<int>& outIndices) const;
+
+    //the k best points are stored in a bounded max-heap, with the current worst point on top
+    void heapPush(int k, int& heapSize, index_t* heapNodes, float* heapDist, index_t node, float distance) const;
+    void heapSiftDown(int heapSize, index_t* heapNodes, float* heapDist, int i) const;
+    float distance(const point_t& a, const point_t& b) const;
+    void printPoints(index_t startIndex, index_t endIndex);
+
+    static int numThreads(int threads);
+};
+
+template<int D, typename point_t>
+KDTree<D,point_t>::KDTree(const std::vector<point_t> &points)
+{
+    createTree(points);
+}
+
+template<int D, typename point_t>
+int KDTree<D,point_t>::numThreads(int threads)
+{
+    if(threads <= 0)
+        threads = defaultTaskScheduler().numThreads();
+    return std::max(threads,1);
+}
+
+template<int D, typename point_t>
+void KDTree<D,point_t>::createTree(const std::vector<point_t> &points, int threads)
+{
+    nodes.clear();
+    nodes.resize(points.size());
+    for(int i = 0 ; i < (int)points.size() ; ++i){
+        nodes[i].p = points[i];
+        nodes[i].id = i;
+    }
+
+    //every level of parallel recursion doubles the number of tasks
+    int parallelDepth = 0;
+    threads = numThreads(threads);
+    while((1 << parallelDepth) < threads)
+        parallelDepth++;
+
+    rootNode = make_tree(0,nodes.size(),0,parallelDepth);
+
+    nodeOfPoint.resize(nodes.size());
+    for(int i = 0 ; i < (int)nodes.size() ; ++i){
+        nodeOfPoint[nodes[i].id] = i;
+    }
+}
+
+template<int D, typename point_t>
+typename KDTree<D,point_t>::index_t KDTree<D,point_t>::sortByAxis(index_t startIndex, index_t endIndex, axis_t axis)
+{
+    auto cmp = [axis](const kd_node_t& a, const kd_node_t& b) -> bool
+    {
+        return a.p[axis] < b.p[axis];
+    };
+    //only the median has to be at the correct position.
+    //all points left of it are smaller and all points right of it are larger.
+    index_t median = (startIndex + endIndex) / 2;
+    std::nth_element(nodes.begin()+startIndex,nodes.begin()+median,nodes.begin()+endIndex,cmp);
+    return median;
+}
+
+template<int D, typename point_t>
+typename KDTree<D,point_t>::index_t KDTree<D,point_t>::make_tree(index_t startIndex, index_t endIndex, axis_t currentAxis, int parallelDepth)
+{
+    if (startIndex == endIndex) return -1;
+    if(startIndex+1 == endIndex) return startIndex;
+
+    index_t median = sortByAxis(startIndex,endIndex,currentAxis);
+    currentAxis = (currentAxis + 1) % D;
+
+    //the two subtrees are disjoint ranges of 'nodes' and can be build in parallel
+    //small subtrees are not worth the overhead of a new task
+    if(parallelDepth > 0 && endIndex - startIndex > 10000){
+        index_t left;
+        TaskGroup group;
+        group.run([&](){ left = make_tree(startIndex, median, currentAxis, parallelDepth - 1); });
+        nodes[median].right = make_tree(median+1, endIndex, currentAxis, parallelDepth - 1);
+        group.wait();
+        nodes[median].left = left;
+    }else{
+        nodes[median].left  = make_tree(startIndex, median, currentAxis, 0);
+        nodes[median].right = make_tree(median+1, endIndex, currentAxis, 0);
+    }
+
+    return median;
+}
+
+template<int D, typename point_t>
+point_t KDTree<D,point_t>::nearestNeighbour(const point_t &searchPoint) const
+{
+    KDTree::index_t bestNode;
+    float bestDist = 125625206456465;
+    nearestNeighbour(rootNode,searchPoint,0,bestNode,bestDist);
+    return nodes[bestNode].p;
+}
+
+
+template<int D, typename point_t>
+void KDTree<D,point_t>::nearestNeighbour(index_t currentNode, const point_t &searchPoint, axis_t currentAxis, index_t &bestNode, float &bestDist) const
+{
+    if(currentNode == -1)
+        return;
+
+    //calculate distance to current point and update the current best
+    float d = distance(nodes[currentNode].p, searchPoint);
+    if (d < bestDist){
+        bestDist = d;
+        bestNode = currentNode;
+    }
+
+    //exact match (can't get any better)
+    if(d==0)
+        return;
+
+    //the (signed) distance of the searchpoint to the current split axis
+    float dAxis = nodes[currentNode].p[currentAxis] - searchPoint[currentAxis];
+    //the actual distance to the point is squared so we also need to square the distance to the axis
+    float dAxisSquared = dAxis * dAxis;
+
+    currentAxis = (currentAxis + 1) % D;
+
+    //first traverse the subtree in which the point lays
+    nearestNeighbour(dAxis > 0 ? nodes[currentNode].left : nodes[currentNode].right, searchPoint, currentAxis ,bestNode,  bestDist);
+
+    //when the distance to the axis is greater than the current distance
+    //we don't need to traverse the other sub tree
+    if (dAxisSquared >= bestDist) return;
+
+    //there may be a better point in this subtree
+    nearestNeighbour(dAxis > 0 ? nodes[currentNode].right : nodes[currentNode].left, searchPoint, currentAxis ,bestNode,  bestDist);
+}
+
+
+template<int D, typename point_t>
+std::vector<point_t> KDTree<D,point_t>::nearestNeighbours(const point_t &searchPoint,int k) const
+{
+    if(k <= 0)
+        return std::vector<point_t>();
+    std::vector<int> indices(k);
+    std::vector<float> distances(k);
+    int found = nearestNeighbours(searchPoint,k,indices.data(),distances.data());
+
+    std::vector<point_t> points(found);
+    for(int i = 0 ; i < found ; ++i){
+        points[i] = getPoint(indices[i]);
+    }
+    return points;
+}
+
+template<int D, typename point_t>
+int KDTree<D,point_t>::nearestNeighbours(const point_t &searchPoint, int k, int *outIndices, float *outDistances, const Approximation& approx) const
+{
+    //the heap code below assumes at least one element
+    if(k <= 0)
+        return 0;
+
+    //all distances are squared
+    float pruneFactor = 1.0f / ((1.0f + approx.eps) * (1.0f + approx.eps));
+    int visitsLeft = approx.maxVisits;
+
+    //the output arrays are directly used as heap storage
+    int heapSize = 0;
+    nearestNeighbours(rootNode,searchPoint,k,0,heapSize,outIndices,outDistances,pruneFactor,visitsLeft);
+
+    //heap sort: move the largest element to the end of the array
+    for(int end = heapSize - 1 ; end > 0 ; --end){
+        std::swap(outIndices[0],outIndices[end]);
+        std::swap(outDistances[0],outDistances[end]);
+        heapSiftDown(end,outIndices,outDistances,0);
+    }
+
+    //convert node ids to point ids
+    for(int i = 0 ; i < heapSize ; ++i){
+        outIndices[i] = nodes[outIndices[i]].id;
+    }
+    return heapSize;
+}
+
+template<int D, typename point_t>
+void KDTree<D,point_t>::nearestNeighbours(const point_t *searchPoints, int n, int k, int *outIndices, float *outDistances, const Approximation& approx, TaskScheduler& scheduler) const
+{
+    //all queries are roughly equally expensive, a chunk amortizes the task overhead
+    parallelFor(scheduler,0,n,64,[=](int i){
+        this->nearestNeighbours(searchPoints[i],k,outIndices + i * k,outDistances + i * k,approx);
+    });
+}
+
+
+template<int D, typename point_t>
+void KDTree<D,point_t>::nearestNeighbours(index_t currentNode, const point_t &searchPoint,int k, axis_t currentAxis, int& heapSize, index_t* heapNodes, float* heapDist,
+                                          float pruneFactor, int& visitsLeft) const
+{
+    if(currentNode == -1 || visitsLeft == 0)
+        return;
+    visitsLeft--;
+
+    //calculate distance to current point and update the current best
+    float d = distance(nodes[currentNode].p, searchPoint);
+    heapPush(k,heapSize,heapNodes,heapDist,currentNode,d);
+
+
+    //the (signed) distance of the searchpoint to the current split axis
+    float dAxis = nodes[currentNode].p[currentAxis] - searchPoint[currentAxis];
+    //the actual distance to the point is squared so we also need to square the distance to the axis
+    float dAxisSquared = dAxis * dAxis;
+
+    currentAxis = (currentAxis + 1) % D;
+
+    //first traverse the subtree in which the point lays
+    nearestNeighbours(dAxis > 0 ? nodes[currentNode].left : nodes[currentNode].right, searchPoint,k, currentAxis ,heapSize,heapNodes,heapDist,pruneFactor,visitsLeft);
+
+    //when the distance to the axis is greater than the current k-th distance
+    //we don't need to traverse the other sub tree
+    float lastD = heapSize < k ? std::numeric_limits<float>::infinity() : heapDist[0];
+    if (dAxisSquared >= lastD * pruneFactor) return;
+
+    //there may be a better point in this subtree
+    nearestNeighbours(dAxis > 0 ? nodes[currentNode].right : nodes[currentNode].left, searchPoint,k, currentAxis ,heapSize,heapNodes,heapDist,pruneFactor,visitsLeft);
+}
+
+template<int D, typename point_t>
+int KDTree<D,point_t>::radiusSearch(const point_t &searchPoint, float radius, std::vector<int> &outIndices) const
+{
+    int oldSize = outIndices.size();
+    radiusSearch(rootNode,searchPoint,radius*radius,0,outIndices);
+    return outIndices.size() - oldSize;
+}
+
+template<int D, typename point_t>
+void KDTree<D,point_t>::radiusSearch(index_t currentNode, const point_t &searchPoint, float radiusSquared, axis_t currentAxis, std::vector<int> &outIndices) const
+{
+    if(currentNode == -1)
+        return;
+
+    const kd_node_t& node = nodes[currentNode];
+    if(distance(node.p, searchPoint) <= radiusSquared)
+        outIndices.push_back(node.id);
+
+    float dAxis = node.p[currentAxis] - searchPoint[currentAxis];
+    float dAxisSquared = dAxis * dAxis;
+
+    currentAxis = (currentAxis + 1) % D;
+
+    radiusSearch(dAxis > 0 ? node.left : node.right, searchPoint, radiusSquared, currentAxis, outIndices);
+
+    //the sphere doesn't intersect the split plane
+    if (dAxisSquared > radiusSquared) return;
+
+    radiusSearch(dAxis > 0 ? node.right : node.left, searchPoint, radiusSquared, currentAxis, outIndices);
+}
+
+template<int D, typename point_t>
+void KDTree<D,point_t>::heapPush(int k, int &heapSize, index_t *heapNodes, float *heapDist, index_t node, float distance) const
+{
+    if(heapSize < k){
+        //sift up
+        int i = heapSize++;
+        while(i > 0){
+            int parent = (i - 1) / 2;
+            if(heapDist[parent] >= distance)
+                break;
+            heapNodes[i] = heapNodes[parent];
+            heapDist[i] = heapDist[parent];
+            i = parent;
+        }
+        heapNodes[i] = node;
+        heapDist[i] = distance;
+        return;
+    }
+
+    //the heap is full: replace the current worst element
+    if(distance >= heapDist[0])
+        return;
+    heapNodes[0] = node;
+    heapDist[0] = distance;
+    heapSiftDown(heapSize,heapNodes,heapDist,0);
+}
+
+template<int D, typename point_t>
+void KDTree<D,point_t>::heapSiftDown(int heapSize, index_t *heapNodes, float *heapDist, int i) const
+{
+    index_t node = heapNodes[i];
+    float dist = heapDist[i];
+    for(;;){
+        int child = 2 * i + 1;
+        if(child >= heapSize)
+            break;
+        if(child + 1 < heapSize && heapDist[child + 1] > heapDist[child])
+            child++;
+        if(heapDist[child] <= dist)
+            break;
+        heapNodes[i] = heapNodes[child];
+        heapDist[i] = heapDist[child];
+        i = child;
+    }
+    heapNodes[i] = node;
+    heapDist[i] = dist;
+}
+
+
+template<int D, typename point_t>
+float KDTree<D,point_t>::distance(const point_t& a, const point_t& b) const
+{
+    //use the squared distance so we don't have to calculate the sqrt
+    point_t tmp = a-b;
+    return glm::dot(tmp,tmp);
+}
+
+template<int D, typename point_t>
+void KDTree<D,point_t>::printPoints(index_t startIndex, index_t endIndex)
+{
+    for(index_t i = startIndex ; i < endIndex ; ++i){
+        cout << nodes[i].p << endl;
+    }
+}
+
+}
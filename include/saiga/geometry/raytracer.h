@@ -11,6 +11,7 @@
 #include "saiga/geometry/aabb.h"
 #include "saiga/geometry/ray.h"
 #include "saiga/geometry/triangle.h"
+#include "saiga/geometry/triangleBVH.h"
 
 #include <vector>
 
@@ -24,7 +25,12 @@ class SAIGA_GLOBAL Raytracer
 {
 public:
 	std::vector<Triangle> &triangles;
-    Raytracer(std::vector<Triangle> &triangles):triangles(triangles){}
+    TriangleBVH bvh;
+
+    //the bvh is built once here. if the triangles are modified afterwards 'rebuild' has to be called.
+    Raytracer(std::vector<Triangle> &triangles):triangles(triangles),bvh(triangles){}
+
+    void rebuild(){ bvh.construct(triangles); }
 
     struct Result{
         bool valid;
@@ -40,6 +46,14 @@ public:
 
     //writes all found intersections to output and returns number
     int trace(Ray &r, std::vector<Result> &output);
+
+    //finds the closest intersection for each of the n rays.
+    //the triangles are intersected 4 or 8 at once (SSE/AVX) in the leaves of the bvh.
+    void trace(const Ray* rays, size_t n, Result* out);
+
+    //same as above, but without the bvh. every triangle is tested.
+    Result traceBruteForce(Ray &r);
+    int traceBruteForce(Ray &r, std::vector<Result> &output);
 };
 
 inline bool operator< (const Raytracer::Result& lhs, const Raytracer::Result& rhs){ return lhs.distance<rhs.distance; }
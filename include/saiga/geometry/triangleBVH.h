@@ -0,0 +1,136 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include <saiga/config.h>
+#include "saiga/util/glm.h"
+#include "saiga/geometry/aabb.h"
+#include "saiga/geometry/ray.h"
+#include "saiga/geometry/triangle.h"
+
+#include <vector>
+
+namespace Saiga {
+
+/**
+ * A bounding volume hierarchy over a list of triangles.
+ * The tree is built top-down with the binned surface area heuristic (SAH)
+ * and stored as a flat array in depth first order.
+ *
+ * The triangles of each leaf are copied into blocks of 8 in SoA layout, so the
+ * leaves can be intersected with SSE (2x4 triangles) or AVX (8 triangles) at once.
+ * A scalar fallback is used if neither is available.
+ * All returned triangle ids are indices into the original list.
+ */
+class SAIGA_GLOBAL TriangleBVH
+{
+public:
+    struct TriangleBlock{
+        static const int size = 8;
+        //vertex a and the two edges b-a, c-a
+        float ax[size], ay[size], az[size];
+        float e1x[size], e1y[size], e1z[size];
+        float e2x[size], e2y[size], e2z[size];
+        unsigned int id[size];
+        //number of valid triangles in this block
+        int count;
+    };
+
+    struct Node{
+        AABB box;
+        //inner node: indices of the two children
+        //leaf node: range [start,start+count) in the 'indices' array
+        int left = -1, right = -1;
+        int start = 0, count = 0;
+        //leaf node: first triangle block
+        int block = 0;
+
+        bool isLeaf() const { return count > 0; }
+        int blockCount() const { return (count + TriangleBlock::size - 1) / TriangleBlock::size; }
+    };
+
+    std::vector<Node> nodes;
+    std::vector<unsigned int> indices;
+    std::vector<TriangleBlock> blocks;
+
+    //number of bins per axis used for the SAH evaluation
+    int sahBins = 16;
+    //nodes with this number of triangles (or less) always become leaves.
+    //one full block, because a leaf is intersected block by block anyways.
+    int maxLeafSize = TriangleBlock::size;
+
+    TriangleBVH(){}
+    TriangleBVH(const std::vector<Triangle> &triangles){ construct(triangles); }
+
+    //builds a new tree. the old tree is discarded.
+    void construct(const std::vector<Triangle> &triangles);
+
+    //find closest intersection.
+    //returns false if nothing was hit.
+    bool getClosest(const Ray &r, unsigned int &triangle, float &distance, bool &back) const;
+
+    //calls 'op(triangleIndex,distance,back)' for every intersected triangle.
+    //the order is unspecified.
+    template<typename OP>
+    void forEachIntersection(const Ray &r, OP op) const;
+
+    //Intersects all triangles of the block with the ray and returns a bitmask of the hits.
+    //Same results as 'Ray::intersectTriangle'.
+    //t[i] and bit i of 'backMask' are only written for hit triangles.
+    static int intersectBlock(const TriangleBlock& block, const Ray &r, float* t, int& backMask);
+
+    int depth() const;
+private:
+    struct BuildTriangle{
+        AABB box;
+        vec3 center;
+    };
+
+    int build(std::vector<BuildTriangle> &bt, int start, int end, int currentDepth);
+    void createBlocks(const std::vector<Triangle> &triangles);
+    int depth(int node) const;
+};
+
+
+template<typename OP>
+void TriangleBVH::forEachIntersection(const Ray &r, OP op) const
+{
+    if(nodes.empty())
+        return;
+
+    //the tree depth is bounded by 64 (see 'build').
+    int stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while(stackSize > 0){
+        const Node& node = nodes[stack[--stackSize]];
+
+        float t;
+        if(!r.intersectAabb(node.box,t))
+            continue;
+
+        if(node.isLeaf()){
+            for(int b = node.block ; b < node.block + node.blockCount() ; ++b){
+                const TriangleBlock& block = blocks[b];
+                float d[TriangleBlock::size];
+                int backMask;
+                int hits = intersectBlock(block,r,d,backMask);
+                for(int i = 0 ; i < block.count ; ++i){
+                    if(hits & (1 << i)){
+                        op(block.id[i],d[i],(backMask & (1 << i)) != 0);
+                    }
+                }
+            }
+        }else{
+            stack[stackSize++] = node.right;
+            stack[stackSize++] = node.left;
+        }
+    }
+}
+
+}
@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+#include "saiga/geometry/triangle_mesh.h"
+
+#include <vector>
+#include <iostream>
+
+namespace Saiga {
+
+/**
+ * Result of a simulated FIFO post transform vertex cache.
+ * ACMR: average cache miss ratio = transformed vertices / triangles. Between 0.5 (optimal for large regular meshes) and 3.
+ * ATVR: average transformed vertex ratio = transformed vertices / referenced vertices. 1 is optimal.
+ */
+struct SAIGA_GLOBAL VertexCacheStatistics{
+    int cacheSize = 0;
+    int triangles = 0;
+    //number of different vertices referenced by the indices
+    int vertices = 0;
+    int transformedVertices = 0;
+
+    double acmr() const { return triangles ? double(transformedVertices) / triangles : 0; }
+    double atvr() const { return vertices ? double(transformedVertices) / vertices : 0; }
+
+    SAIGA_GLOBAL friend std::ostream& operator<<(std::ostream& os, const VertexCacheStatistics& s);
+};
+
+SAIGA_GLOBAL VertexCacheStatistics simulateVertexCache(const uint32_t* indices, int numIndices, int numVertices, int cacheSize = 16);
+
+/**
+ * Reorders the triangles for the post transform vertex cache with Tom Forsyth's
+ * "Linear-Speed Vertex Cache Optimisation": https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+ * The vertex order inside the triangles is not changed.
+ * There is no overdraw optimization (for example Tipsify style clustering and sorting by view direction),
+ * so the triangle order is only chosen for the cache.
+ * 'out' must have the size 'numIndices' and must not alias 'indices'.
+ */
+SAIGA_GLOBAL void optimizeVertexCache(const uint32_t* indices, int numIndices, int numVertices, uint32_t* out);
+
+/**
+ * Renumbers the vertices in the order of their first use, so the vertex fetch is mostly sequential.
+ * Unreferenced vertices are moved to the end.
+ * Returns the remap table: new index = remap[old index].
+ */
+SAIGA_GLOBAL std::vector<uint32_t> optimizeVertexFetch(uint32_t* indices, int numIndices, int numVertices);
+
+
+
+template<typename vertex_t, typename index_t>
+std::vector<uint32_t> faceIndices(const TriangleMesh<vertex_t,index_t>& mesh, int firstFace, int numFaces){
+    std::vector<uint32_t> indices(numFaces * 3);
+    for(int i = 0 ; i < numFaces ; ++i){
+        const typename TriangleMesh<vertex_t,index_t>::Face& f = mesh.faces[firstFace + i];
+        indices[i * 3 + 0] = f.v1;
+        indices[i * 3 + 1] = f.v2;
+        indices[i * 3 + 2] = f.v3;
+    }
+    return indices;
+}
+
+template<typename vertex_t, typename index_t>
+VertexCacheStatistics vertexCacheStatistics(const TriangleMesh<vertex_t,index_t>& mesh, int cacheSize = 16){
+    std::vector<uint32_t> indices = faceIndices(mesh,0,mesh.faces.size());
+    return simulateVertexCache(indices.data(),indices.size(),mesh.vertices.size(),cacheSize);
+}
+
+/**
+ * Reorders the faces [firstFace,firstFace+numFaces) for the vertex cache.
+ * Faces outside of this range are not moved, so for example material groups stay intact.
+ * numFaces = -1: all faces starting at firstFace
+ */
+template<typename vertex_t, typename index_t>
+void optimizeVertexCache(TriangleMesh<vertex_t,index_t>& mesh, int firstFace = 0, int numFaces = -1){
+    if(numFaces < 0)
+        numFaces = mesh.faces.size() - firstFace;
+    SAIGA_ASSERT(firstFace >= 0 && firstFace + numFaces <= (int)mesh.faces.size());
+
+    std::vector<uint32_t> indices = faceIndices(mesh,firstFace,numFaces);
+    std::vector<uint32_t> optimized(indices.size());
+    optimizeVertexCache(indices.data(),indices.size(),mesh.vertices.size(),optimized.data());
+    for(int i = 0 ; i < numFaces ; ++i){
+        mesh.faces[firstFace + i] = typename TriangleMesh<vertex_t,index_t>::Face(optimized[i * 3],optimized[i * 3 + 1],optimized[i * 3 + 2]);
+    }
+}
+
+//Reorders the vertices in the order of their first use by the faces.
+template<typename vertex_t, typename index_t>
+void optimizeVertexFetch(TriangleMesh<vertex_t,index_t>& mesh){
+    std::vector<uint32_t> indices = faceIndices(mesh,0,mesh.faces.size());
+    std::vector<uint32_t> remap = optimizeVertexFetch(indices.data(),indices.size(),mesh.vertices.size());
+
+    std::vector<vertex_t> vertices(mesh.vertices.size());
+    for(int i = 0 ; i < (int)remap.size() ; ++i){
+        vertices[remap[i]] = mesh.vertices[i];
+    }
+    mesh.vertices.swap(vertices);
+    for(int i = 0 ; i < (int)mesh.faces.size() ; ++i){
+        mesh.faces[i] = typename TriangleMesh<vertex_t,index_t>::Face(indices[i * 3],indices[i * 3 + 1],indices[i * 3 + 2]);
+    }
+}
+
+//Vertex cache followed by vertex fetch optimization. Should be done once after loading or when baking assets.
+template<typename vertex_t, typename index_t>
+void optimizeMesh(TriangleMesh<vertex_t,index_t>& mesh){
+    optimizeVertexCache(mesh);
+    optimizeVertexFetch(mesh);
+}
+
+}
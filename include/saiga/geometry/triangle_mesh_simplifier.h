@@ -0,0 +1,175 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+#include "saiga/geometry/triangle_mesh.h"
+
+#include <vector>
+#include <unordered_map>
+#include <cmath>
+
+namespace Saiga {
+
+/**
+ * Quadric error metric simplification (Garland and Heckbert 97) with half edge collapses.
+ * The remaining vertices are a subset of the input vertices, so all vertex attributes stay valid.
+ *
+ * Each pass collapses a batch of independent edges in the order of their cost and rebuilds the adjacency,
+ * so the memory is linear in the mesh size.
+ * Border vertices only collapse along the border and vertices of non manifold edges are never removed.
+ *
+ * targetTriangles: descending triangle counts. One index buffer is returned per target.
+ *                  If a target cannot be reached, the lod is the most simplified mesh.
+ * errors:          optional. The square root of the largest quadric error of a collapse up to this lod.
+ */
+SAIGA_GLOBAL void simplifyMesh(const vec3* positions, int numVertices, const uint32_t* indices, int numIndices,
+                               const std::vector<int>& targetTriangles, std::vector<std::vector<uint32_t>>& lods,
+                               std::vector<float>* errors = nullptr);
+
+
+/**
+ * Creates a chain of level of detail meshes. Each mesh only contains the used vertices.
+ */
+template<typename vertex_t, typename index_t>
+std::vector<TriangleMesh<vertex_t,index_t>> createLODs(const TriangleMesh<vertex_t,index_t>& mesh, const std::vector<int>& targetTriangles,
+                                                       std::vector<float>* errors = nullptr)
+{
+    std::vector<vec3> positions(mesh.vertices.size());
+    for(int i = 0 ; i < (int)mesh.vertices.size() ; ++i){
+        positions[i] = vec3(mesh.vertices[i].position);
+    }
+    std::vector<uint32_t> indices(mesh.faces.size() * 3);
+    for(int i = 0 ; i < (int)mesh.faces.size() ; ++i){
+        indices[i * 3 + 0] = mesh.faces[i].v1;
+        indices[i * 3 + 1] = mesh.faces[i].v2;
+        indices[i * 3 + 2] = mesh.faces[i].v3;
+    }
+
+    std::vector<std::vector<uint32_t>> lodIndices;
+    simplifyMesh(positions.data(),positions.size(),indices.data(),indices.size(),targetTriangles,lodIndices,errors);
+
+    std::vector<TriangleMesh<vertex_t,index_t>> lods(lodIndices.size());
+    std::vector<int> remap(mesh.vertices.size());
+    for(int l = 0 ; l < (int)lods.size() ; ++l){
+        TriangleMesh<vertex_t,index_t>& lod = lods[l];
+        std::vector<uint32_t>& ind = lodIndices[l];
+        std::fill(remap.begin(),remap.end(),-1);
+        for(uint32_t& i : ind){
+            if(remap[i] < 0){
+                remap[i] = lod.addVertex(mesh.vertices[i]);
+            }
+            i = remap[i];
+        }
+        lod.faces.reserve(ind.size() / 3);
+        for(int i = 0 ; i < (int)ind.size() ; i += 3){
+            lod.addFace(ind[i],ind[i + 1],ind[i + 2]);
+        }
+    }
+    return lods;
+}
+
+
+/**
+ * Merges vertices whose positions are closer than 'tolerance' (per axis) and whose other attributes are equal.
+ * The positions are hashed on a grid with a cell size of 'tolerance', so only the 27 neighbouring cells are searched.
+ * Faces that become degenerate and unused vertices are removed.
+ * Returns the number of removed vertices.
+ */
+template<typename vertex_t, typename index_t>
+int weldVertices(TriangleMesh<vertex_t,index_t>& mesh, float tolerance)
+{
+    typedef typename TriangleMesh<vertex_t,index_t>::Face Face;
+    int n = mesh.vertices.size();
+    float invCell = tolerance > 0 ? 1.0f / tolerance : 1.0f;
+
+    auto cellKey = [](int x, int y, int z){
+        //21 bits per axis
+        return (uint64_t(uint32_t(x) & 0x1fffff) << 42) | (uint64_t(uint32_t(y) & 0x1fffff) << 21) | uint64_t(uint32_t(z) & 0x1fffff);
+    };
+
+    //first vertex of each cell + linked list of the unique vertices in that cell
+    std::unordered_map<uint64_t,int> cells;
+    cells.reserve(n);
+    std::vector<int> next(n,-1);
+    std::vector<int> remap(n);
+    std::vector<vertex_t> unique;
+    unique.reserve(n);
+
+    for(int i = 0 ; i < n ; ++i){
+        const vertex_t& v = mesh.vertices[i];
+        vec3 p(v.position);
+        int cx = (int)std::floor(p.x * invCell);
+        int cy = (int)std::floor(p.y * invCell);
+        int cz = (int)std::floor(p.z * invCell);
+        //the own cell first, because most duplicates are there
+        const int offsets[3] = {0,-1,1};
+        int range = tolerance > 0 ? 3 : 1;
+
+        int found = -1;
+        for(int x = 0 ; x < range && found < 0 ; ++x){
+            for(int y = 0 ; y < range && found < 0 ; ++y){
+                for(int z = 0 ; z < range && found < 0 ; ++z){
+                    auto it = cells.find(cellKey(cx + offsets[x],cy + offsets[y],cz + offsets[z]));
+                    if(it == cells.end())
+                        continue;
+                    for(int u = it->second ; u >= 0 ; u = next[u]){
+                        const vertex_t& o = unique[u];
+                        vec3 d = glm::abs(vec3(o.position) - p);
+                        if(d.x > tolerance || d.y > tolerance || d.z > tolerance)
+                            continue;
+                        //compare the remaining attributes
+                        vertex_t tmp = v;
+                        tmp.position = o.position;
+                        if(tmp == o){
+                            found = u;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        if(found < 0){
+            found = unique.size();
+            unique.push_back(v);
+            auto it = cells.insert(std::make_pair(cellKey(cx,cy,cz),found));
+            if(!it.second){
+                next[found] = it.first->second;
+                it.first->second = found;
+            }
+        }
+        remap[i] = found;
+    }
+
+    std::vector<Face> faces;
+    faces.reserve(mesh.faces.size());
+    for(const Face& f : mesh.faces){
+        Face g(remap[f.v1],remap[f.v2],remap[f.v3]);
+        if(g.v1 != g.v2 && g.v1 != g.v3 && g.v2 != g.v3)
+            faces.push_back(g);
+    }
+
+    //remove the vertices of degenerate faces
+    std::vector<int> used(unique.size(),-1);
+    mesh.vertices.clear();
+    for(Face& f : faces){
+        index_t* idx[3] = {&f.v1,&f.v2,&f.v3};
+        for(int k = 0 ; k < 3 ; ++k){
+            int& u = used[*idx[k]];
+            if(u < 0){
+                u = mesh.vertices.size();
+                mesh.vertices.push_back(unique[*idx[k]]);
+            }
+            *idx[k] = u;
+        }
+    }
+    mesh.faces.swap(faces);
+    return n - mesh.vertices.size();
+}
+
+}
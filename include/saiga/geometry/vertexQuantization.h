@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+#include "saiga/util/glm.h"
+#include "saiga/opengl/vertex.h"
+#include "saiga/geometry/aabb.h"
+#include "saiga/geometry/triangle_mesh.h"
+
+namespace Saiga {
+
+//Octahedral normal encoding in [-1,1]^2: http://jcgt.org/published/0003/02/01/
+SAIGA_GLOBAL vec2 encodeOctahedral(const vec3& n);
+SAIGA_GLOBAL vec3 decodeOctahedral(const vec2& e);
+
+//IEEE 754 half precision with round to nearest even. Overflows become infinity.
+SAIGA_GLOBAL uint16_t floatToHalf(float f);
+SAIGA_GLOBAL float halfToFloat(uint16_t h);
+
+/**
+ * Converts vertices to the compressed formats VertexNQ and VertexNTQ.
+ * The positions are quantized relative to 'box'. The shader gets the original position with
+ * 'position * dequantizationScale + dequantizationOffset' (see geometry/deferred_mvp_model_quantized.glsl
+ * and MVPQuantizedShader). The scale is not part of the model matrix, because the normals are
+ * transformed with the model matrix and would be skewed by a non uniform scale.
+ */
+class SAIGA_GLOBAL VertexQuantizer{
+public:
+    VertexQuantizer(const AABB& box);
+
+    vec3 dequantizationScale() const { return size; }
+    vec3 dequantizationOffset() const { return box.min; }
+    //The maximum position error of one quantized vertex.
+    vec3 maxError() const { return size * (0.5f / 65535.0f); }
+
+    void quantize(const VertexN* in, VertexNQ* out, int count) const;
+    void quantize(const VertexNT* in, VertexNTQ* out, int count) const;
+
+    VertexN dequantize(const VertexNQ& v) const;
+    VertexNT dequantize(const VertexNTQ& v) const;
+
+private:
+    AABB box;
+    vec3 size;
+    //65535 / size
+    vec3 invStep;
+
+    void quantize(const VertexN& in, VertexNQ& out) const;
+};
+
+/**
+ * Converts 'mesh' to a compressed mesh with the same faces. The bounding box of 'out' is the one
+ * of the original positions.
+ * Returns the quantizer, which has the dequantization parameters for the shader.
+ */
+template<typename vertex_t, typename quantized_vertex_t, typename index_t>
+VertexQuantizer quantizeMesh(TriangleMesh<vertex_t,index_t>& mesh, TriangleMesh<quantized_vertex_t,index_t>& out){
+    VertexQuantizer quantizer(mesh.calculateAabb());
+    out.vertices.resize(mesh.vertices.size());
+    out.faces.resize(mesh.faces.size());
+    for(int i = 0 ; i < (int)mesh.faces.size() ; ++i){
+        out.faces[i].v1 = mesh.faces[i].v1;
+        out.faces[i].v2 = mesh.faces[i].v2;
+        out.faces[i].v3 = mesh.faces[i].v3;
+    }
+    quantizer.quantize(mesh.vertices.data(),out.vertices.data(),mesh.vertices.size());
+    out.boundingBox = mesh.boundingBox;
+    return quantizer;
+}
+
+}
@@ -0,0 +1,50 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+#include "saiga/image/image.h"
+
+namespace Saiga {
+
+/**
+ * Exact euclidean distance transform in linear time.
+ *
+ * Paper: Distance Transforms of Sampled Functions, Felzenszwalb and Huttenlocher
+ * https://cs.brown.edu/~pff/papers/dt-final.pdf
+ *
+ * The 1D transform computes the lower envelope of the parabolas rooted at (q,f(q)).
+ * The 2D transform is a 1D transform of all rows followed by a 1D transform of all columns.
+ */
+namespace DistanceTransform {
+
+//Value for pixels that are not a feature. It is large enough for all image sizes, but small enough for float arithmetic.
+static const float infinity = 1e20f;
+
+//d[q] = min_p (q-p)^2 + f[p]
+//v and z are temporary arrays of size n and n+1.
+//f and d are accessed with the given stride and must not overlap.
+SAIGA_GLOBAL void squaredDistance1D(const float* f, float* d, int n, int stride, int* v, float* z);
+
+//In place squared euclidean distance transform.
+//The input has to be 0 at the feature pixels and 'infinity' everywhere else.
+SAIGA_GLOBAL void squaredDistance(float* data, int width, int height);
+
+/**
+ * Creates a downsampled signed distance field from a 1 channel 8 bit bitmap.
+ *
+ * The texel (x,y) of the sdf is the pixel (x*divisor+divisor/2, y*divisor+divisor/2) of the bitmap.
+ * The distance to the nearest pixel with the other value (zero or non zero) is divided by searchRadius and clamped to [0,1].
+ * Non zero pixels are mapped to [0.5,1] and zero pixels to [0,0.5].
+ *
+ * Only the columns that contain a sample are transformed in the second pass.
+ */
+SAIGA_GLOBAL void bitmapToSDF(Image& bitmap, Image& sdf, int divisor, int searchRadius);
+
+}
+
+}
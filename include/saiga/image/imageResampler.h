@@ -0,0 +1,130 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+#include "saiga/image/templatedImage.h"
+
+#include <vector>
+#include <functional>
+
+namespace Saiga {
+
+enum class ResampleFilter{
+    Box,        //average of the covered pixels, exact 2x2 average for mipmaps
+    Bilinear,   //tent filter
+    Lanczos,    //lanczos with 3 lobes
+    Kaiser      //sinc with a kaiser window (width 3, alpha 4)
+};
+
+/**
+ * Separable CPU resampler.
+ *
+ * The destination is processed in bands of 16 rows. For each band the source rows it needs are read
+ * as float and filtered horizontally into a small buffer, then every destination row of the band is
+ * filtered vertically from that buffer and written. No complete float copy of the image is created,
+ * and source rows at the border of two bands are filtered horizontally by both bands.
+ * When downsampling the filter is scaled with the reduction factor, so all source pixels contribute.
+ * The borders are clamped.
+ * With parallel = true the bands are distributed on the default TaskScheduler.
+ */
+namespace ImageResampler {
+
+//Reads n pixels starting at (x,y) of the source image as float.
+typedef std::function<void(int x, int y, int n, float* out)> ReadFunction;
+//Receives n pixels starting at (x,y) of the destination image. The data may be modified.
+typedef std::function<void(int x, int y, int n, float* data)> WriteFunction;
+//Same as WriteFunction for a mip level >= 1.
+typedef std::function<void(int level, int x, int y, int n, float* data)> MipWriteFunction;
+
+//The source image is read and the destination image is written row by row, so no
+//complete float copy of the images is created. Reads and writes can happen from multiple threads.
+SAIGA_GLOBAL void resample(int srcW, int srcH, const ReadFunction& read, int dstW, int dstH, const WriteFunction& write,
+                           int channels, ResampleFilter filter = ResampleFilter::Lanczos, bool parallel = false);
+
+//Resamples a float image with interleaved channels and tightly packed rows.
+SAIGA_GLOBAL void resample(const float* src, int srcW, int srcH, float* dst, int dstW, int dstH, int channels,
+                           ResampleFilter filter = ResampleFilter::Lanczos, bool parallel = false);
+
+//Number of levels of a full mip chain down to 1x1.
+SAIGA_GLOBAL int mipLevelCount(int width, int height);
+
+//Creates all mip levels >= 1 of an image. Every level is computed in float from the previous one.
+//For the box filter and a size divisible by 64 the first levels are computed in a single tiled pass:
+//every 64x64 tile is reduced to 1x1 while it is in the cache.
+SAIGA_GLOBAL void generateMipChain(int width, int height, const ReadFunction& read, const MipWriteFunction& write,
+                                   int channels, ResampleFilter filter = ResampleFilter::Box, bool parallel = false);
+
+//Same for a float image. levels[0] must contain the image, the other levels are created.
+SAIGA_GLOBAL void generateMipChain(std::vector<std::vector<float>>& levels, int width, int height, int channels,
+                                   ResampleFilter filter = ResampleFilter::Box, bool parallel = false);
+
+
+template<int CHANNELS, int BITDEPTH, ImageElementFormat FORMAT>
+struct FloatRowConversion{
+    typedef Texel<CHANNELS,BITDEPTH,FORMAT> texel_t;
+    typedef Texel<CHANNELS,32,ImageElementFormat::FloatingPoint> float_texel_t;
+
+    static void toFloat(texel_t* src, float* dst, int n){
+        TexelRowConversion<texel_t,float_texel_t>::convert(src,reinterpret_cast<float_texel_t*>(dst),n);
+    }
+
+    //Normalized values are clamped to [0,1] and rounded to the nearest integer.
+    static void fromFloat(float* src, texel_t* dst, int n){
+        if(FORMAT == ImageElementFormat::UnsignedNormalized){
+            const float offset = 0.5f / float((1ull << BITDEPTH) - 1);
+            for(int i = 0 ; i < n * CHANNELS ; ++i){
+                float f = src[i];
+                f = f < 0 ? 0 : (f > 1 ? 1 : f);
+                src[i] = f + offset;
+            }
+        }
+        TexelRowConversion<float_texel_t,texel_t>::convert(reinterpret_cast<float_texel_t*>(src),dst,n);
+    }
+};
+
+}
+
+
+//Resamples 'src' to the size of 'dst'.
+template<int CHANNELS, int BITDEPTH, ImageElementFormat FORMAT, bool SRGB>
+void resample(TemplatedImage<CHANNELS,BITDEPTH,FORMAT,SRGB>& src, TemplatedImage<CHANNELS,BITDEPTH,FORMAT,SRGB>& dst,
+              ResampleFilter filter = ResampleFilter::Lanczos, bool parallel = false)
+{
+    typedef ImageResampler::FloatRowConversion<CHANNELS,BITDEPTH,FORMAT> conversion_t;
+    ImageResampler::resample(src.width,src.height,[&src](int x, int y, int n, float* out){
+        conversion_t::toFloat(src.rowPointer(y) + x,out,n);
+    },dst.width,dst.height,[&dst](int x, int y, int n, float* data){
+        conversion_t::fromFloat(data,dst.rowPointer(y) + x,n);
+    },CHANNELS,filter,parallel);
+}
+
+//Returns all mip levels of 'src' down to 1x1. The first element is a copy of 'src'.
+//The filtering is done in float, so the rounding errors do not accumulate over the levels.
+template<int CHANNELS, int BITDEPTH, ImageElementFormat FORMAT, bool SRGB>
+std::vector<TemplatedImage<CHANNELS,BITDEPTH,FORMAT,SRGB>> generateMipChain(TemplatedImage<CHANNELS,BITDEPTH,FORMAT,SRGB>& src,
+                                                                            ResampleFilter filter = ResampleFilter::Box, bool parallel = false)
+{
+    typedef TemplatedImage<CHANNELS,BITDEPTH,FORMAT,SRGB> image_t;
+    typedef ImageResampler::FloatRowConversion<CHANNELS,BITDEPTH,FORMAT> conversion_t;
+    int numLevels = ImageResampler::mipLevelCount(src.width,src.height);
+
+    std::vector<image_t> result;
+    result.reserve(numLevels);
+    result.push_back(src);
+    for(int i = 1 ; i < numLevels ; ++i){
+        result.push_back(image_t(std::max(1,src.width >> i),std::max(1,src.height >> i)));
+    }
+
+    ImageResampler::generateMipChain(src.width,src.height,[&src](int x, int y, int n, float* out){
+        conversion_t::toFloat(src.rowPointer(y) + x,out,n);
+    },[&result](int level, int x, int y, int n, float* data){
+        conversion_t::fromFloat(data,result[level].rowPointer(y) + x,n);
+    },CHANNELS,filter,parallel);
+    return result;
+}
+}
@@ -0,0 +1,169 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+#include "saiga/image/templatedImageTypes.h"
+#include "saiga/util/color.h"
+#include "saiga/util/taskScheduler.h"
+
+#include <cstring>
+#include <stdint.h>
+
+namespace Saiga {
+
+/**
+ * Row based conversion kernels for 8-bit and 32-bit float images.
+ * The kernels use SSE2, SSSE3 or AVX2 if the compiler flags allow it (see SAIGA_SIMD_NATIVE)
+ * and produce the same results as the texel wise conversion with Texel::toVec4 and Texel::fromVec4.
+ */
+namespace PixelConversion {
+
+//'n' is the number of elements (pixels * channels)
+//u8 -> float in [0,1]
+SAIGA_GLOBAL void u8ToFloat(const uint8_t* src, float* dst, int n);
+//float in [0,1] -> u8. Values are truncated and clamped.
+SAIGA_GLOBAL void floatToU8(const float* src, uint8_t* dst, int n);
+
+//'n' is the number of pixels
+SAIGA_GLOBAL void rgbToRgba(const uint8_t* src, uint8_t* dst, int n, uint8_t alpha);
+SAIGA_GLOBAL void rgbaToRgb(const uint8_t* src, uint8_t* dst, int n);
+SAIGA_GLOBAL void flipRBRgba(uint8_t* data, int n);
+
+//256 entry tables for the sRGB conversion of 8-bit channels
+SAIGA_GLOBAL const uint8_t* srgbToLinearLUT();
+SAIGA_GLOBAL const uint8_t* linearToSrgbLUT();
+//Applies the lookup table to the color channels (at most 3) of 'n' pixels. Alpha is not changed.
+SAIGA_GLOBAL void applyLUT(uint8_t* data, int n, int channels, const uint8_t* lut);
+
+//The scalar versions of the kernels above. They are also used for the remaining elements of the simd loops.
+namespace Scalar {
+SAIGA_GLOBAL void u8ToFloat(const uint8_t* src, float* dst, int n);
+SAIGA_GLOBAL void floatToU8(const float* src, uint8_t* dst, int n);
+SAIGA_GLOBAL void rgbToRgba(const uint8_t* src, uint8_t* dst, int n, uint8_t alpha);
+SAIGA_GLOBAL void rgbaToRgb(const uint8_t* src, uint8_t* dst, int n);
+SAIGA_GLOBAL void flipRBRgba(uint8_t* data, int n);
+}
+
+
+//Calls f(y) for every row. With parallel = true the rows are distributed on the default TaskScheduler.
+template<typename F>
+void forEachRow(int height, bool parallel, F f)
+{
+    if(parallel){
+        parallelFor(defaultTaskScheduler(), 0, height, 16, f);
+    }else{
+        for(int y = 0 ; y < height ; ++y){
+            f(y);
+        }
+    }
+}
+
+}
+
+
+//Converts a row of texels. The generic version goes through vec4.
+template<typename SRC, typename DST>
+struct TexelRowConversion{
+    static void convert(SRC* src, DST* dst, int n){
+        for(int i = 0 ; i < n ; ++i){
+            dst[i].fromVec4(src[i].toVec4());
+        }
+    }
+};
+
+template<typename T>
+struct TexelRowConversion<T,T>{
+    static void convert(T* src, T* dst, int n){
+        memcpy(dst,src,n*sizeof(T));
+    }
+};
+
+template<int CHANNELS>
+struct TexelRowConversion<Texel<CHANNELS,8,ImageElementFormat::UnsignedNormalized>,Texel<CHANNELS,32,ImageElementFormat::FloatingPoint>>{
+    static void convert(Texel<CHANNELS,8,ImageElementFormat::UnsignedNormalized>* src, Texel<CHANNELS,32,ImageElementFormat::FloatingPoint>* dst, int n){
+        PixelConversion::u8ToFloat(&src->r,&dst->r,n*CHANNELS);
+    }
+};
+
+template<int CHANNELS>
+struct TexelRowConversion<Texel<CHANNELS,32,ImageElementFormat::FloatingPoint>,Texel<CHANNELS,8,ImageElementFormat::UnsignedNormalized>>{
+    static void convert(Texel<CHANNELS,32,ImageElementFormat::FloatingPoint>* src, Texel<CHANNELS,8,ImageElementFormat::UnsignedNormalized>* dst, int n){
+        PixelConversion::floatToU8(&src->r,&dst->r,n*CHANNELS);
+    }
+};
+
+template<>
+struct TexelRowConversion<Texel<3,8,ImageElementFormat::UnsignedNormalized>,Texel<4,8,ImageElementFormat::UnsignedNormalized>>{
+    static void convert(Texel<3,8,ImageElementFormat::UnsignedNormalized>* src, Texel<4,8,ImageElementFormat::UnsignedNormalized>* dst, int n){
+        //the missing alpha is 0 like in Texel<3>::toVec4
+        PixelConversion::rgbToRgba(&src->r,&dst->r,n,0);
+    }
+};
+
+template<>
+struct TexelRowConversion<Texel<4,8,ImageElementFormat::UnsignedNormalized>,Texel<3,8,ImageElementFormat::UnsignedNormalized>>{
+    static void convert(Texel<4,8,ImageElementFormat::UnsignedNormalized>* src, Texel<3,8,ImageElementFormat::UnsignedNormalized>* dst, int n){
+        PixelConversion::rgbaToRgb(&src->r,&dst->r,n);
+    }
+};
+
+
+//In place operations on a row of texels.
+template<typename T>
+struct TexelRowOperations{
+    static void flipRB(T* row, int n){
+        for(int i = 0 ; i < n ; ++i){
+            typename T::elementType tmp = row[i].r;
+            row[i].r = row[i].b;
+            row[i].b = tmp;
+        }
+    }
+
+    static void toSRGB(T* row, int n){
+        for(int i = 0 ; i < n ; ++i){
+            vec4 c = row[i].toVec4();
+            c = vec4(Color::linearrgb2srgb(vec3(c)),c.w);
+            row[i].fromVec4(c);
+        }
+    }
+
+    static void toLinearRGB(T* row, int n){
+        for(int i = 0 ; i < n ; ++i){
+            vec4 c = row[i].toVec4();
+            c = vec4(Color::srgb2linearrgb(vec3(c)),c.w);
+            row[i].fromVec4(c);
+        }
+    }
+};
+
+template<int CHANNELS>
+struct TexelRowOperations<Texel<CHANNELS,8,ImageElementFormat::UnsignedNormalized>>{
+    typedef Texel<CHANNELS,8,ImageElementFormat::UnsignedNormalized> T;
+
+    static void flipRB(T* row, int n){
+        if(CHANNELS == 4){
+            PixelConversion::flipRBRgba(&row->r,n);
+            return;
+        }
+        for(int i = 0 ; i < n ; ++i){
+            uint8_t tmp = row[i].r;
+            row[i].r = row[i].b;
+            row[i].b = tmp;
+        }
+    }
+
+    static void toSRGB(T* row, int n){
+        PixelConversion::applyLUT(&row->r,n,CHANNELS,PixelConversion::linearToSrgbLUT());
+    }
+
+    static void toLinearRGB(T* row, int n){
+        PixelConversion::applyLUT(&row->r,n,CHANNELS,PixelConversion::srgbToLinearLUT());
+    }
+};
+
+}
@@ -11,7 +11,9 @@
 #include "saiga/image/imageFormat.h"
 #include "saiga/image/image.h"
 #include "saiga/image/templatedImageTypes.h"
+#include "saiga/image/pixelConversion.h"
 #include "saiga/util/color.h"
+#include "saiga/util/assert.h"
 #include <vector>
 
 namespace Saiga {
@@ -35,17 +37,23 @@ public:
     //pointer to the beginning of this row
     TexelType* rowPointer(int y);
 
-    void flipRB();
+    //The conversions work row by row with the kernels from pixelConversion.h.
+    //With parallel = true the rows are processed on the default TaskScheduler.
+    void flipRB(bool parallel = false);
 
 
-    void toSRGB();
-    void toLinearRGB();
+    void toSRGB(bool parallel = false);
+    void toLinearRGB(bool parallel = false);
 
-    TemplatedImage<CHANNELS,32,ImageElementFormat::FloatingPoint,false> convertToFloatImage();
+    TemplatedImage<CHANNELS,32,ImageElementFormat::FloatingPoint,false> convertToFloatImage(bool parallel = false);
 
 
     template<int OTHER_CHANNELS, int OTHER_BITDEPTH, ImageElementFormat OTHER_FORMAT, bool OTHER_SRGB=false>
-    TemplatedImage<OTHER_CHANNELS,OTHER_BITDEPTH,OTHER_FORMAT,OTHER_SRGB> convertImage();
+    TemplatedImage<OTHER_CHANNELS,OTHER_BITDEPTH,OTHER_FORMAT,OTHER_SRGB> convertImage(bool parallel = false);
+
+    //converts to an existing image with the same size
+    template<int OTHER_CHANNELS, int OTHER_BITDEPTH, ImageElementFormat OTHER_FORMAT, bool OTHER_SRGB>
+    void convertImage(TemplatedImage<OTHER_CHANNELS,OTHER_BITDEPTH,OTHER_FORMAT,OTHER_SRGB>& dst, bool parallel = false);
 };
 
 
@@ -89,73 +97,55 @@ typename TemplatedImage<CHANNELS,BITDEPTH,FORMAT,SRGB>::TexelType* TemplatedImag
 }
 
 template<int CHANNELS, int BITDEPTH, ImageElementFormat FORMAT, bool SRGB>
-void TemplatedImage<CHANNELS,BITDEPTH,FORMAT,SRGB>::flipRB(){
+void TemplatedImage<CHANNELS,BITDEPTH,FORMAT,SRGB>::flipRB(bool parallel){
     static_assert(CHANNELS>=3,"The image must have atleast 3 channels.");
-    for(int y = 0 ; y < height ; ++y){
-        for(int x = 0 ; x < width ; ++x){
-            TexelType& texel = getTexel(x,y);
-            typename TexelType::elementType tmp = texel.r;
-            texel.r = texel.b;
-            texel.b = tmp;
-        }
-    }
+    PixelConversion::forEachRow(height,parallel,[this](int y){
+        TexelRowOperations<TexelType>::flipRB(rowPointer(y),width);
+    });
 }
 
 template<int CHANNELS, int BITDEPTH, ImageElementFormat FORMAT, bool SRGB>
-void TemplatedImage<CHANNELS,BITDEPTH,FORMAT,SRGB>::toSRGB()
+void TemplatedImage<CHANNELS,BITDEPTH,FORMAT,SRGB>::toSRGB(bool parallel)
 {
-    for(int y = 0 ; y < height ; ++y){
-        for(int x = 0 ; x < width ; ++x){
-            auto& texel1 = getTexel(x,y);
-            vec4 c = texel1.toVec4();
-            c = vec4(Color::linearrgb2srgb(vec3(c)),c.w);
-            texel1.fromVec4(c);
-        }
-    }
+    PixelConversion::forEachRow(height,parallel,[this](int y){
+        TexelRowOperations<TexelType>::toSRGB(rowPointer(y),width);
+    });
 }
 
 template<int CHANNELS, int BITDEPTH, ImageElementFormat FORMAT, bool SRGB>
-void TemplatedImage<CHANNELS,BITDEPTH,FORMAT,SRGB>::toLinearRGB()
+void TemplatedImage<CHANNELS,BITDEPTH,FORMAT,SRGB>::toLinearRGB(bool parallel)
 {
-    for(int y = 0 ; y < height ; ++y){
-        for(int x = 0 ; x < width ; ++x){
-            auto& texel1 = getTexel(x,y);
-            vec4 c = texel1.toVec4();
-            c = vec4(Color::srgb2linearrgb(vec3(c)),c.w);
-            texel1.fromVec4(c);
-        }
-    }
+    PixelConversion::forEachRow(height,parallel,[this](int y){
+        TexelRowOperations<TexelType>::toLinearRGB(rowPointer(y),width);
+    });
 }
 
 
 template<int CHANNELS, int BITDEPTH, ImageElementFormat FORMAT, bool SRGB>
-TemplatedImage<CHANNELS, 32, ImageElementFormat::FloatingPoint, false> TemplatedImage<CHANNELS,BITDEPTH,FORMAT,SRGB>::convertToFloatImage()
+TemplatedImage<CHANNELS, 32, ImageElementFormat::FloatingPoint, false> TemplatedImage<CHANNELS,BITDEPTH,FORMAT,SRGB>::convertToFloatImage(bool parallel)
 {
-    TemplatedImage<CHANNELS, 32, ImageElementFormat::FloatingPoint, false> img(width,height);
-    for(int y = 0 ; y < height ; ++y){
-        for(int x = 0 ; x < width ; ++x){
-            auto& texel1 = getTexel(x,y);
-            auto& texel2 = img.getTexel(x,y);
-            texel2.fromVec4(texel1.toVec4());
-        }
-    }
-    return img;
+    return convertImage<CHANNELS, 32, ImageElementFormat::FloatingPoint, false>(parallel);
 }
 
 
 template<int CHANNELS, int BITDEPTH, ImageElementFormat FORMAT, bool SRGB>
 template<int OTHER_CHANNELS, int OTHER_BITDEPTH, ImageElementFormat OTHER_FORMAT, bool OTHER_SRGB>
-TemplatedImage<OTHER_CHANNELS,OTHER_BITDEPTH,OTHER_FORMAT,OTHER_SRGB> TemplatedImage<CHANNELS,BITDEPTH,FORMAT,SRGB>::convertImage()
+TemplatedImage<OTHER_CHANNELS,OTHER_BITDEPTH,OTHER_FORMAT,OTHER_SRGB> TemplatedImage<CHANNELS,BITDEPTH,FORMAT,SRGB>::convertImage(bool parallel)
 {
     TemplatedImage<OTHER_CHANNELS,OTHER_BITDEPTH,OTHER_FORMAT,OTHER_SRGB> img(width,height);
-    for(int y = 0 ; y < height ; ++y){
-        for(int x = 0 ; x < width ; ++x){
-            auto& texel1 = getTexel(x,y);
-            auto& texel2 = img.getTexel(x,y);
-            texel2.fromVec4(texel1.toVec4());
-        }
-    }
+    convertImage(img,parallel);
     return img;
 }
 
+template<int CHANNELS, int BITDEPTH, ImageElementFormat FORMAT, bool SRGB>
+template<int OTHER_CHANNELS, int OTHER_BITDEPTH, ImageElementFormat OTHER_FORMAT, bool OTHER_SRGB>
+void TemplatedImage<CHANNELS,BITDEPTH,FORMAT,SRGB>::convertImage(TemplatedImage<OTHER_CHANNELS,OTHER_BITDEPTH,OTHER_FORMAT,OTHER_SRGB>& dst, bool parallel)
+{
+    typedef typename TemplatedImage<OTHER_CHANNELS,OTHER_BITDEPTH,OTHER_FORMAT,OTHER_SRGB>::TexelType other_texel_t;
+    SAIGA_ASSERT(dst.width == width && dst.height == height);
+    PixelConversion::forEachRow(height,parallel,[this,&dst](int y){
+        TexelRowConversion<TexelType,other_texel_t>::convert(rowPointer(y),dst.rowPointer(y),width);
+    });
+}
+
 }
@@ -16,6 +16,7 @@
 #include "saiga/opengl/indexedVertexBuffer.h"
 #include "saiga/opengl/instancedBuffer.h"
 #include "saiga/opengl/opengl.h"
+#include "saiga/opengl/streamingBuffer.h"
 #include "saiga/opengl/uniformBuffer.h"
 #include "saiga/opengl/vertex.h"
 #include "saiga/opengl/vertexBuffer.h"
@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/opengl/buffer.h"
+
+#include <vector>
+#include <memory>
+#include <functional>
+
+namespace Saiga {
+
+class Image;
+
+/**
+ * Reads the default framebuffer without stalling the pipeline.
+ *
+ * glReadPixels writes into one of 'ringSize' pixel pack buffers and a fence is inserted after it.
+ * A capture requested in frame N is mapped and passed to the callback in update() of frame N+2,
+ * when the gpu has finished it. If all buffers are in use, the oldest capture is finished immediately.
+ *
+ * Usage:
+ *
+ * request(image,[](std::shared_ptr<Image> img){ ... }); //somewhere in the frame
+ * ...
+ * swapBuffers();
+ * update();                                            //once per frame
+ *
+ * All functions have to be called from the OpenGL thread. The callbacks are called in update().
+ */
+class SAIGA_GLOBAL AsyncReadback{
+public:
+    typedef std::function<void(std::shared_ptr<Image>)> Callback;
+
+    AsyncReadback(int ringSize = 3, int frameDelay = 2);
+    ~AsyncReadback();
+    AsyncReadback(const AsyncReadback&) = delete;
+    AsyncReadback& operator=(const AsyncReadback&) = delete;
+
+    //Starts reading the default framebuffer to 'image'. The image has to be created with the size of the framebuffer.
+    void request(std::shared_ptr<Image> image, Callback callback);
+
+    //Finishes all captures that are at least 'frameDelay' frames old.
+    void update();
+
+    //Finishes all captures. This stalls until the gpu is done.
+    void flush();
+
+    int numPending(){ return pending; }
+private:
+    struct Slot{
+        Buffer pbo;
+        GLsync fence = nullptr;
+        int frame = 0;
+        int order = 0;
+        std::shared_ptr<Image> image;
+        Callback callback;
+        Slot() : pbo(GL_PIXEL_PACK_BUFFER){}
+    };
+    std::vector<Slot> slots;
+    int frameDelay;
+    int frame = 0;
+    int requests = 0;
+    int pending = 0;
+
+    void finish(Slot& slot);
+    Slot* oldest();
+};
+
+}
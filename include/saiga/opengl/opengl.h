@@ -12,6 +12,8 @@
 #ifdef SAIGA_USE_GLEW
 #include <GL/glew.h>
 typedef int MemoryBarrierMask;
+typedef GLbitfield BufferStorageMask;
+typedef GLbitfield BufferAccessMask;
 #endif
 
 #ifdef SAIGA_USE_GLBINDING
@@ -8,6 +8,7 @@
 
 #include "saiga/opengl/shader/basic_shaders.h"
 #include "saiga/opengl/shader/shader.h"
+#include "saiga/opengl/shader/shaderBinaryCache.h"
 #include "saiga/opengl/shader/shaderLoader.h"
 #include "saiga/opengl/shader/shaderpart.h"
 #include "saiga/opengl/shader/shaderPartLoader.h"
@@ -37,6 +37,15 @@ public:
     virtual void uploadColor(const vec4 &color);
 };
 
+//For the compressed vertex formats VertexNQ and VertexNTQ (see VertexQuantizer).
+class SAIGA_GLOBAL MVPQuantizedShader : public MVPColorShader{
+public:
+    GLint location_dequantizationScale, location_dequantizationOffset;
+
+    virtual void checkUniforms();
+    void uploadDequantization(const vec3& scale, const vec3& offset);
+};
+
 class SAIGA_GLOBAL MVPTextureShader : public MVPShader{
 public:
     GLint location_texture;
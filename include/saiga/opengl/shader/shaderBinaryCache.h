@@ -0,0 +1,51 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/opengl/opengl.h"
+#include "saiga/opengl/shader/shaderpart.h"
+
+#include <vector>
+
+namespace Saiga {
+
+class Shader;
+
+/**
+ * Persistent cache of linked shader programs.
+ *
+ * The key is a hash of the preprocessed source of all shader parts, the code injections and the
+ * driver string (vendor, renderer and version). The binaries are written with glGetProgramBinary to
+ * '<directory>/<key>.bin' and loaded with glProgramBinary.
+ * If the driver rejects a binary (for example after a driver update with the same version string),
+ * the shader is compiled from source and the entry is overwritten.
+ */
+class SAIGA_GLOBAL ShaderBinaryCache{
+public:
+    //The cache is disabled if the directory is empty. The directory is created if it does not exist.
+    void setDirectory(const std::string &dir);
+    bool isEnabled();
+
+    uint64_t computeKey(const std::vector<std::shared_ptr<ShaderPart>> &parts, const ShaderPart::ShaderCodeInjections &injections);
+
+    //Creates the program of 'shader' from the cached binary. Returns false if there is no valid entry.
+    bool load(Shader &shader, uint64_t key);
+    //Writes the binary of the linked program of 'shader'.
+    bool store(Shader &shader, uint64_t key);
+
+private:
+    std::string directory;
+    std::string driver;
+    //-1: not checked yet, 0: the driver does not support program binaries
+    int supported = -1;
+
+    std::string entryFile(uint64_t key);
+};
+
+extern SAIGA_GLOBAL ShaderBinaryCache shaderBinaryCache;
+
+}
@@ -24,25 +24,41 @@ public:
     template<typename shader_t> std::shared_ptr<shader_t> getLoaded(const std::string &name, const ShaderPart::ShaderCodeInjections& sci=ShaderPart::ShaderCodeInjections());
     template<typename shader_t> std::shared_ptr<shader_t> loadFromFile(const std::string &name, const ShaderPart::ShaderCodeInjections& sci);
 
+    //Shaders are compiled in the OpenGL thread and the type is only known in load<shader_t>, so there is no asynchronous loading.
+    std::shared_future<std::shared_ptr<Shader>> loadAsync(const std::string &name, const ShaderPart::ShaderCodeInjections& sci=ShaderPart::ShaderCodeInjections()) = delete;
+
     void reload();
     bool reload(std::shared_ptr<Shader> shader, const std::string &name, const ShaderPart::ShaderCodeInjections& sci);
+private:
+    //the same file can be loaded with different shader types, so all entries with this key are checked
+    template<typename shader_t> std::shared_ptr<shader_t> findShader(const std::string &name, const ShaderPart::ShaderCodeInjections& sci);
 };
 
-
-
-
 template<typename shader_t>
-std::shared_ptr<shader_t> ShaderLoader::load(const std::string &name, const ShaderPart::ShaderCodeInjections& sci){
-    std::shared_ptr<shader_t> object;
-
-    for(data_t &data : objects){
-        if(std::get<0>(data)==name && std::get<1>(data)==sci){
-            object = std::dynamic_pointer_cast<shader_t>(std::get<2>(data));
+std::shared_ptr<shader_t> ShaderLoader::findShader(const std::string &name, const ShaderPart::ShaderCodeInjections& sci){
+    auto range = index.equal_range(hashKey(name,sci));
+    for(auto it = range.first ; it != range.second ; ++it){
+        CacheEntry& e = *it->second;
+        if(e.name == name && e.params == sci){
+            std::shared_ptr<shader_t> object = std::dynamic_pointer_cast<shader_t>(e.object);
             if(object){
+                touch(it->second);
                 return object;
             }
         }
     }
+    return nullptr;
+}
+
+
+
+
+template<typename shader_t>
+std::shared_ptr<shader_t> ShaderLoader::load(const std::string &name, const ShaderPart::ShaderCodeInjections& sci){
+    std::shared_ptr<shader_t> object = findShader<shader_t>(name,sci);
+    if(object){
+        return object;
+    }
 
     std::string fullName = shaderPathes.getFile(name);
 
@@ -53,22 +69,16 @@ std::shared_ptr<shader_t> ShaderLoader::load(const std::string &name, const Shad
 
     object = loadFromFile<shader_t>(fullName,sci);
     SAIGA_ASSERT(object);
-    objects.emplace_back(name,sci,object);
+    insert(name,object,sci);
 
     return object;
 }
 
 template<typename shader_t>
 std::shared_ptr<shader_t> ShaderLoader::getLoaded(const std::string &name, const ShaderPart::ShaderCodeInjections& sci){
-    std::shared_ptr<shader_t> object;
-
-    for(data_t &data : objects){
-        if(std::get<0>(data)==name && std::get<1>(data)==sci){
-            object = std::dynamic_pointer_cast<shader_t>(std::get<2>(data));
-            if(object){
-                return object;
-            }
-        }
+    std::shared_ptr<shader_t> object = findShader<shader_t>(name,sci);
+    if(object){
+        return object;
     }
 
     SAIGA_ASSERT(false && "Shader was not loaded!");
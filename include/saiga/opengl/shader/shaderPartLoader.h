@@ -41,6 +41,7 @@ public:
     bool load();
     bool loadAndPreproccess(const std::string &file, std::vector<std::string> &ret);
 
+    //creates the shader part with the injections. it is compiled in createShader, if it is not in the binary cache.
     void addShader(std::vector<std::string> &content, GLenum type);
 
     //combine all loaded shader parts to a shader. the returned shader is linked and ready to use
@@ -48,6 +49,20 @@ public:
 
     //like create shader, but the passed shader is updated instead of creating a new one
     void reloadShader(std::shared_ptr<Shader>  shader);
+
+    /**
+     * The files read by loadAndPreproccess are kept in memory and only read again if their size or
+     * modification time changed. This makes ShaderLoader::reload() cheap if only a few files were modified.
+     * Not thread safe, shaders are only loaded in the OpenGL thread.
+     */
+    static void clearFileCache();
+private:
+    //first pass of loadAndPreproccess without the include expansion
+    bool readFile(const std::string &file, std::vector<std::string> &ret);
+    //compiles all parts and removes the ones with errors. returns false if no part is left.
+    bool compileShaders();
+    //links the program from the binary cache or compiles it from source
+    bool createProgram(std::shared_ptr<Shader> shader);
 };
 
 
@@ -62,8 +77,10 @@ std::shared_ptr<shader_t> ShaderPartLoader::createShader()
     }
 
     auto shader = std::make_shared<shader_t>();
-    shader->shaders = shaders;
-    shader->createProgram();
+    if(!createProgram(shader)){
+        std::cerr<<file<<": all shader parts failed to compile."<<endl;
+        return nullptr;
+    }
 
 #ifndef SAIGA_RELEASE
     std::cout<<"Loaded: "<<file<<" ( ";
@@ -10,6 +10,7 @@
 #include "saiga/util/glm.h"
 
 #include <vector>
+#include <functional>
 
 namespace Saiga {
 
@@ -33,6 +34,15 @@ SAIGA_GLOBAL inline bool operator==(const ShaderCodeInjection& lhs, const Shader
 	return lhs.type == rhs.type && lhs.code == rhs.code && lhs.line == rhs.line;
 }
 
+//used by the ShaderLoader cache
+SAIGA_GLOBAL inline size_t loaderHash(const std::vector<ShaderCodeInjection>& scis) {
+	size_t h = scis.size();
+	for(const ShaderCodeInjection& sci : scis){
+		h ^= std::hash<std::string>()(sci.code) + sci.type + sci.line + 0x9e3779b9 + (h << 6) + (h >> 2);
+	}
+	return h;
+}
+
 /**
  * The ShaderPart class represents an actual Shader Object in OpenGL while the
  * Shader class represents a program.
@@ -0,0 +1,125 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/opengl/buffer.h"
+#include "saiga/opengl/vertexBuffer.h"
+
+#include <vector>
+
+namespace Saiga {
+
+/**
+ * A buffer for data that is rewritten every frame (particles, debug lines, dynamic text, ...).
+ *
+ * The storage is created with glBufferStorage and mapped once (persistent and coherent),
+ * so the data is written directly to gpu visible memory without a driver copy.
+ * The buffer is split into 'numRegions' regions. Every frame uses the next region, which is
+ * guarded by a fence, so the cpu never writes to memory the gpu is still reading.
+ * Inside a region the memory is handed out with a bump allocator.
+ *
+ * Usage:
+ *
+ * beginFrame();
+ * Allocation a = allocate(size);
+ * memcpy(a.ptr,data,size);
+ * flush();
+ * //draw with a.offset
+ * endFrame();
+ *
+ * Without GL 4.4 or ARB_buffer_storage the data is staged in cpu memory and uploaded with glBufferSubData in flush().
+ */
+class SAIGA_GLOBAL StreamingBuffer : public Buffer{
+public:
+    struct Allocation{
+        void* ptr = nullptr;    //nullptr if the region is full
+        unsigned int offset = 0; //offset in bytes from the beginning of the buffer
+    };
+
+    StreamingBuffer(GLenum _target = GL_ARRAY_BUFFER);
+    ~StreamingBuffer();
+    StreamingBuffer(const StreamingBuffer&) = delete;
+    StreamingBuffer& operator=(const StreamingBuffer&) = delete;
+
+    void create(unsigned int regionSize, int numRegions = 3);
+    void destroy();
+
+    //Switches to the next region and waits until the gpu has finished the frame that used it last.
+    void beginFrame();
+    //Inserts the fence for the current region. Call it after the last draw call that uses this frame's data.
+    void endFrame();
+
+    //The returned offset is a multiple of 'alignment', which doesn't have to be a power of two.
+    Allocation allocate(unsigned int bytes, unsigned int alignment = 16);
+    //Makes the data written since the last flush available to the gpu. Does nothing with persistent mapping.
+    void flush();
+
+    bool isPersistent(){ return persistent; }
+    unsigned int getRegionSize(){ return regionSize; }
+    unsigned int getRemainingBytes(){ return regionSize - (head - regionStart()); }
+private:
+    unsigned char* mapped = nullptr;
+    std::vector<unsigned char> staging;
+    std::vector<GLsync> fences;
+    unsigned int regionSize = 0;
+    int numRegions = 0;
+    int currentRegion = 0;
+    unsigned int head = 0; //next free byte in the current region
+    unsigned int flushed = 0; //data before this offset was already uploaded
+    bool persistent = false;
+
+    unsigned int regionStart(){ return currentRegion * regionSize; }
+};
+
+
+/**
+ * A StreamingBuffer with a vertex array object.
+ * The vertices of every allocation are drawn with draw(firstVertex,count).
+ */
+template<class vertex_t>
+class StreamingVertexBuffer : public VertexBuffer<vertex_t>{
+public:
+    StreamingBuffer stream;
+
+    ~StreamingVertexBuffer(){ deleteGLBuffer(); }
+
+    void create(int verticesPerFrame, int numRegions = 3);
+    void deleteGLBuffer();
+
+    //Returns memory for 'count' vertices in the current region or nullptr if it is full.
+    vertex_t* allocate(int count, int& firstVertex);
+};
+
+template<class vertex_t>
+void StreamingVertexBuffer<vertex_t>::create(int verticesPerFrame, int numRegions){
+    deleteGLBuffer();
+    //one extra vertex, because the allocations are aligned to the vertex size
+    stream.create((verticesPerFrame + 1) * sizeof(vertex_t),numRegions);
+
+    glGenVertexArrays(1, &this->gl_vao);
+    glBindVertexArray(this->gl_vao);
+    stream.bind();
+    this->setVertexAttributes();
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    assert_no_glerror();
+}
+
+template<class vertex_t>
+void StreamingVertexBuffer<vertex_t>::deleteGLBuffer(){
+    VertexBuffer<vertex_t>::deleteGLBuffer();
+    stream.destroy();
+}
+
+template<class vertex_t>
+vertex_t* StreamingVertexBuffer<vertex_t>::allocate(int count, int& firstVertex){
+    StreamingBuffer::Allocation a = stream.allocate(count * sizeof(vertex_t),sizeof(vertex_t));
+    firstVertex = a.offset / sizeof(vertex_t);
+    return reinterpret_cast<vertex_t*>(a.ptr);
+}
+
+}
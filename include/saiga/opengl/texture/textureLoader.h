@@ -18,11 +18,15 @@ struct SAIGA_GLOBAL TextureParameters{
 };
 
 SAIGA_GLOBAL bool operator==(const TextureParameters& lhs, const TextureParameters& rhs);
+SAIGA_GLOBAL size_t loaderHash(const TextureParameters& params);
 
 
 class SAIGA_GLOBAL TextureLoader : public Loader<std::shared_ptr<Texture>,TextureParameters>, public Singleton <TextureLoader>{
     friend class Singleton <TextureLoader>;
 public:
+    //the asynchronous loads use the virtual decode functions of this class
+    virtual ~TextureLoader(){ waitAsync(); }
+
     std::shared_ptr<Texture> loadFromFile(const std::string &name, const TextureParameters &params);
 
     /**
@@ -37,6 +41,12 @@ public:
      */
     bool saveImage(const std::string &path, Image& image) const;
     std::shared_ptr<Texture> textureFromImage(Image &im, const TextureParameters &params) const;
+
+protected:
+    //the image is loaded on a worker thread and uploaded in update()
+    std::shared_ptr<void> decodeAsync(const std::string &path, const TextureParameters &params);
+    std::shared_ptr<Texture> finishAsync(std::shared_ptr<void> decoded, const std::string &name, const TextureParameters &params);
+    size_t memorySize(const std::shared_ptr<Texture>& object);
 };
 
 }
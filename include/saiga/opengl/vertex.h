@@ -93,6 +93,29 @@ struct SAIGA_GLOBAL VertexNC : public VertexN{
     friend std::ostream& operator<<(std::ostream& os, const VertexNC& vert);
 };
 
+/**
+ * Compressed vertex formats for static geometry. See geometry/vertexQuantization.h for the conversion.
+ *
+ * position: 16 bit unsigned normalized relative to the AABB of the mesh. The w component is always 65535 (=1.0),
+ *           so the shader reads a valid homogeneous position in [0,1]^3 and the dequantization matrix
+ *           is simply multiplied into the model matrix.
+ * normal:   octahedral encoding with 2x16 bit signed normalized. Decode with decodeOctahedral() from
+ *           shader/geometry/vertex_quantization.glsl.
+ * texture:  2x half float
+ */
+struct SAIGA_GLOBAL VertexNQ{
+    uint16_t position[4];
+    int16_t normal[2];
+
+    bool operator==(const VertexNQ &other) const;
+};
+
+struct SAIGA_GLOBAL VertexNTQ : public VertexNQ{
+    uint16_t texture[2];
+
+    bool operator==(const VertexNTQ &other) const;
+};
+
 
 
 template<>
@@ -105,5 +128,9 @@ template<>
 SAIGA_GLOBAL void VertexBuffer<VertexNTD>::setVertexAttributes();
 template<>
 SAIGA_GLOBAL void VertexBuffer<VertexNC>::setVertexAttributes();
+template<>
+SAIGA_GLOBAL void VertexBuffer<VertexNQ>::setVertexAttributes();
+template<>
+SAIGA_GLOBAL void VertexBuffer<VertexNTQ>::setVertexAttributes();
 
 }
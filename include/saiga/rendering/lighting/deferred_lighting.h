@@ -12,6 +12,8 @@
 #include "saiga/opengl/indexedVertexBuffer.h"
 #include "saiga/opengl/shader/basic_shaders.h"
 #include "saiga/opengl/query/gpuTimer.h"
+#include "saiga/geometry/frustumCulling.h"
+#include "saiga/rendering/shadowCasters.h"
 
 namespace Saiga {
 
@@ -85,6 +87,15 @@ private:
     float shadowOffsetFactor = 4;
     float shadowOffsetUnits = 10;
 
+    //bounding spheres of all active point, spot and box lights for the batched culling
+    SphereArray lightSpheres;
+    std::vector<unsigned char> lightVisible;
+
+    //one frustum and draw list per rendered shadow map, in the order of renderDepthMaps
+    std::vector<FrustumCuller> shadowViews;
+    std::vector<ShadowDrawList> shadowDrawLists;
+    int currentShadowView = 0;
+
     std::vector<FilteredMultiFrameOpenGLTimer> timers2;
 	std::vector<std::string> timerStrings;
     void startTimer(int timer){if(useTimers)timers2[timer].startTimer();}
@@ -99,6 +110,13 @@ public:
 
     int shadowSamples = 16; //Quadratic number (1,4,9,16,...)
 
+    //Optional. These objects are culled per shadow map in cullShadowCasters and rendered in renderDepthMaps.
+    ShadowCasterIndex* shadowCasters = nullptr;
+    //CPU time of the last frame in ms
+    double shadowCullTime = 0;
+    double shadowSubmitTime = 0;
+    int shadowCasterDraws = 0;
+
     std::shared_ptr<Texture> ssaoTexture;
 
     std::shared_ptr<Texture> lightAccumulationTexture;
@@ -146,6 +164,9 @@ public:
 
     void cullLights(Camera *cam);
 
+    //Builds the draw lists of all shadow maps in parallel. Must be called after cullLights and before renderDepthMaps.
+    void cullShadowCasters();
+
     void printTimings();
     void renderImGui(bool* p_open = NULL);
 
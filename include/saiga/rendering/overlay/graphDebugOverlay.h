@@ -9,6 +9,7 @@
 #include "saiga/util/glm.h"
 #include "saiga/opengl/vertex.h"
 #include "saiga/opengl/indexedVertexBuffer.h"
+#include "saiga/opengl/streamingBuffer.h"
 #include "saiga/rendering/object3d.h"
 #include <vector>
 
@@ -21,7 +22,8 @@ class SAIGA_GLOBAL GraphDebugOverlay: public Object3D {
     struct Graph{
         std::vector<float> data;
         float lastDataPoint = 0;
-        VertexBuffer<Vertex> buffer;
+        //range of 'data' at the last update, it is scaled to [0,1] when the line strip is written
+        float min = 0, max = 1;
         vec4 color = vec4(1,1,1,1);
 
 
@@ -62,6 +64,8 @@ private:
 
 
     std::vector<Graph> graphs;
+    //the graphs are written every frame
+    StreamingVertexBuffer<Vertex> graphBuffer;
 
 
 public:
@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+#include "saiga/util/glm.h"
+
+#include <vector>
+#include <unordered_map>
+#include <functional>
+
+namespace Saiga {
+
+class Asset;
+class Camera;
+
+/**
+ * Collects the draws of a frame, sorts them by a 64 bit state key and merges draws of the same asset
+ * into one Asset::renderInstanced call.
+ *
+ * Key layout (most significant first):
+ *   16 bit material: user defined state, for example one id per texture set or blend mode
+ *   24 bit asset:    dense id assigned by the queue on the first submit of an asset
+ *   24 bit depth:    view space depth, front to back
+ *
+ * The draws of one material are consecutive, so render() calls the optional bindMaterial
+ * function only once per material. The shaders are still bound by the assets.
+ *
+ * Everything except render/renderDepth is CPU only.
+ *
+ * Usage:
+ *
+ * queue.begin(cam);
+ * for(...) queue.submit(asset,model);
+ * queue.sort();
+ * queue.render(cam);
+ */
+class SAIGA_GLOBAL RenderQueue{
+public:
+    struct Batch{
+        Asset* asset;
+        uint16_t material;
+        //range in the sorted model matrices
+        int first;
+        int count;
+    };
+
+    static const int materialBits = 16;
+    static const int assetBits = 24;
+    static const int depthBits = 24;
+
+    //Clears the queue. The view matrix is used to compute the depth of the submitted objects.
+    void begin(Camera* cam);
+    void begin(const mat4& view = mat4(1), float zFar = 1000.0f);
+
+    void submit(Asset* asset, const mat4& model, uint16_t material = 0);
+
+    //Sorts the draws and builds the batches.
+    void sort();
+
+    typedef std::function<void(uint16_t material)> MaterialFunction;
+
+    //Asset::renderInstanced for every batch.
+    //bindMaterial is called before the first batch of every material.
+    void render(Camera* cam, const MaterialFunction& bindMaterial = MaterialFunction());
+    //Asset::renderDepth for every batch
+    void renderDepth(Camera* cam);
+
+    int numDraws() const { return models.size(); }
+    const std::vector<Batch>& getBatches() const { return batches; }
+    //in batch order after sort()
+    const std::vector<mat4>& getModels() const { return sortedModels; }
+
+    //in batch order after sort()
+    uint64_t getKey(int i) const { return keys[i]; }
+
+    //Forgets the asset ids. Must be called before assets that were submitted are deleted.
+    void clearAssets();
+
+    //Least significant digit radix sort by key. Keys are stable for equal values.
+    static void radixSort(std::vector<uint64_t>& keys, std::vector<uint32_t>& values,
+                          std::vector<uint64_t>& tmpKeys, std::vector<uint32_t>& tmpValues);
+private:
+    mat4 view;
+    float depthScale = 0;
+
+    std::vector<mat4> models;
+    //sort key and index in 'models' of every draw
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> values;
+
+    std::unordered_map<Asset*,uint32_t> assetIds;
+    std::vector<Asset*> assets;
+
+    std::vector<uint64_t> tmpKeys;
+    std::vector<uint32_t> tmpValues;
+
+    std::vector<Batch> batches;
+    std::vector<mat4> sortedModels;
+};
+
+}
@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+#include "saiga/rendering/object3d.h"
+#include "saiga/geometry/dynamicAABBTree.h"
+
+#include <vector>
+
+namespace Saiga {
+
+class Camera;
+
+/**
+ * Spatial index of the renderable objects of a scene for frustum culling.
+ *
+ * The world space bounding box of an object is computed from its local bounding box and Object3D::model.
+ * After an object moved (and calculateModel() was called) it has to be updated with update(handle).
+ * Small movements only refit the leaf, see DynamicAABBTree.
+ *
+ * Usage:
+ *
+ * int handle = index.add(&object,localBounds);
+ * ...
+ * object.translateGlobal(v);
+ * object.calculateModel();
+ * index.update(handle);
+ * ...
+ * index.cull(camera,visibleObjects);
+ */
+class SAIGA_GLOBAL SceneIndex
+{
+public:
+    DynamicAABBTree tree;
+
+    int add(Object3D* object, const AABB& localBounds);
+    void remove(int handle);
+
+    void update(int handle);
+    //Updates all objects. Use this if most of the objects moved.
+    void updateAll();
+
+    //Replaces the content of 'visible' with the objects inside the view frustum of the camera.
+    void cull(Camera* cam, std::vector<Object3D*>& visible) const;
+    void cull(const FrustumCuller& culler, std::vector<Object3D*>& visible) const;
+
+    //Appends the handles of the visible objects. Thread safe with one QueryBuffer per thread.
+    void query(const FrustumCuller& culler, std::vector<int>& handles, DynamicAABBTree::QueryBuffer& buffer) const { tree.query(culler,handles,buffer); }
+
+    Object3D* getObject(int handle) const { return entries[handle].object; }
+
+    int size() const { return tree.size(); }
+
+    //Bounding box of 'local' transformed by 'model'. Correct for every affine transformation.
+    static AABB transformAABB(const AABB& local, const mat4& model);
+
+private:
+    struct Entry{
+        Object3D* object = nullptr;
+        AABB localBounds;
+        int proxy = -1;
+    };
+    std::vector<Entry> entries;
+    std::vector<int> freeHandles;
+    mutable std::vector<int> visibleHandles;
+};
+
+}
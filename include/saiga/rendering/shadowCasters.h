@@ -0,0 +1,62 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+#include "saiga/rendering/sceneIndex.h"
+
+#include <vector>
+
+namespace Saiga {
+
+class Asset;
+
+//The visible shadow casters of one shadow map (or cube face, cascade), grouped by asset.
+struct SAIGA_GLOBAL ShadowDrawList{
+    struct Batch{
+        Asset* asset;
+        //range in 'models'
+        int first;
+        int count;
+    };
+    std::vector<Batch> batches;
+    std::vector<mat4> models;
+
+    void clear(){ batches.clear(); models.clear(); }
+    int numDraws() const { return models.size(); }
+};
+
+/**
+ * Static objects that are culled and rendered into the shadow maps by DeferredLighting.
+ *
+ * The draw lists are built on the CPU in parallel (one task per shadow map) and submitted with
+ * Asset::renderDepth(cam,models,count), so the shader and vertex buffer are bound once per asset.
+ * Objects that are not in this index (for example animated objects, which need their bone matrices)
+ * are still rendered by Program::renderDepth.
+ */
+class SAIGA_GLOBAL ShadowCasterIndex{
+public:
+    SceneIndex scene;
+
+    int add(Object3D* object, Asset* asset, const AABB& localBounds);
+    void remove(int handle);
+
+    //Must be called after the model matrix of the object changed.
+    void update(int handle){ scene.update(handle); }
+    void updateAll(){ scene.updateAll(); }
+
+    int size() const { return scene.size(); }
+
+    //Replaces the content of 'list' with the casters inside the frustum. Thread safe with one QueryBuffer per thread.
+    void cull(const FrustumCuller& culler, ShadowDrawList& list, DynamicAABBTree::QueryBuffer& buffer) const;
+
+private:
+    //indexed by the handle of the scene index
+    std::vector<Asset*> assets;
+};
+
+}
@@ -13,5 +13,65 @@ namespace Tests {
 
 SAIGA_GLOBAL void fpTest(float x = 1.0f);
 
+//compares the bvh raytracer with the brute force implementation (rays per second + correctness)
+SAIGA_GLOBAL void raytracerBenchmark(int numTriangles = 100000, int numRays = 10000);
+
+//checks the kdtree k-nn queries against a linear search and measures build and query times
+SAIGA_GLOBAL void kdtreeBenchmark(int numPoints = 1000000, int numQueries = 100000, int k = 10);
+
+//measures speed and accuracy (recall) of the approximate kdtree queries and checks the radius search against a linear search
+SAIGA_GLOBAL void kdtreeApproximationBenchmark(int numPoints = 1000000, int numQueries = 100000, int k = 10);
+
+//tasks per second of the work stealing TaskScheduler compared to the ThreadPool with 1, 4 and 16 threads
+SAIGA_GLOBAL void taskSchedulerBenchmark(int numTasks = 1000000);
+
+//throughput of the lock-free queues compared to the SynchronizedBuffer
+SAIGA_GLOBAL void queueBenchmark(int numItems = 10000000);
+
+//sustained frames per second of the FFMPEGEncoder pipeline with a synthetic image source
+SAIGA_GLOBAL void videoEncoderBenchmark(int width = 3840, int height = 2160, int frames = 600);
+
+//compares the row based TemplatedImage conversions with the texel wise reference implementation
+SAIGA_GLOBAL void imageConversionBenchmark(int width = 3840, int height = 2160);
+
+//checks the cpu resampler and measures resampling and mip chain generation with all filters
+SAIGA_GLOBAL void resampleBenchmark(int width = 4096, int height = 4096);
+
+//loads a generated .obj file with the parallel parser and from the binary cache
+SAIGA_GLOBAL void objLoaderBenchmark(int gridSize = 1000);
+
+//compares the distance transform sdf generation of the text atlas with the brute force search
+SAIGA_GLOBAL void sdfBenchmark(int numGlyphs = 3000);
+
+//checks the skyline packer of the text atlas for overlaps and compares the code point table with a std::map
+SAIGA_GLOBAL void glyphAtlasBenchmark(int numGlyphs = 10000);
+
+//compares the hashed Loader cache with a linear search and checks the asynchronous loading and lru eviction
+SAIGA_GLOBAL void loaderBenchmark(int numAssets = 10000, int numLookups = 1000000);
+
+//compares the flat skeleton evaluation with the AnimationFrame tree traversal
+SAIGA_GLOBAL void skeletonBenchmark(int numInstances = 2000);
+
+//compares memory and sample cost of the compressed animation tracks with AnimationFrame and SkeletonAnimation
+SAIGA_GLOBAL void animationCompressionBenchmark(int numInstances = 2000);
+
+//compares the batched frustum culling and the SceneIndex with per object plane tests
+SAIGA_GLOBAL void cullingBenchmark(int numObjects = 100000, int numLights = 10000);
+
+//compares the batched SoA skinning kernel with BoneVertex::apply
+SAIGA_GLOBAL void skinningBenchmark(int numMeshes = 32, int verticesPerMesh = 20000);
+
+//memory footprint, conversion speed and error of the compressed vertex formats
+SAIGA_GLOBAL void vertexQuantizationBenchmark(int gridSize = 1000);
+
+//ACMR/ATVR of a simulated FIFO vertex cache before and after the triangle mesh optimizer
+SAIGA_GLOBAL void meshOptimizerBenchmark(int gridSize = 500);
+
+//welds a triangle soup sphere and creates a lod chain with the quadric simplifier (triangle count, error, time)
+SAIGA_GLOBAL void meshSimplificationBenchmark(int sectors = 1000);
+
+//submit, sort and batching cost of the RenderQueue and the number of draw calls compared to one call per object
+SAIGA_GLOBAL void renderQueueBenchmark(int numObjects = 100000, int numAssets = 64, int numMaterials = 4);
+
 }
 }
@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include <saiga/config.h>
+#include "saiga/animation/animation.h"
+
+#include <random>
+
+namespace Saiga {
+namespace Tests {
+
+//A random node tree similar to a humanoid rig loaded with assimp.
+//The first nodes are not animated, like the armature in the collada export.
+//keyFrame(node, t) sets position, rotation and scaling of an animated node at the time t (in seconds).
+//The keyframes are 1/30 seconds apart.
+template<typename KEYFRAME_F>
+void createTestAnimation(Animation& anim, int nodeCount, int boneCount, int frameCount, std::mt19937& gen, KEYFRAME_F keyFrame)
+{
+    std::uniform_real_distribution<float> dis(-1,1);
+
+    std::vector<AnimationNode> nodes(nodeCount);
+    for(int i = 0 ; i < nodeCount ; ++i){
+        AnimationNode& n = nodes[i];
+        n.index = i;
+        n.name = "node" + std::to_string(i);
+        n.keyFramed = i >= 2 && i % 5 != 0;
+        n.boneIndex = i >= nodeCount - boneCount ? i - (nodeCount - boneCount) : -1;
+        n.matrix = glm::translate(mat4(1),vec3(dis(gen),dis(gen),dis(gen)));
+        if(i > 0){
+            int parent = std::uniform_int_distribution<int>(std::max(0,i-4),i-1)(gen);
+            nodes[parent].children.push_back(i);
+        }
+    }
+
+    anim.boneCount = boneCount;
+    anim.boneOffsets.resize(boneCount);
+    for(mat4& m : anim.boneOffsets)
+        m = glm::translate(mat4(1),vec3(dis(gen),dis(gen),dis(gen)));
+
+    anim.keyFrames.resize(frameCount);
+    for(int f = 0 ; f < frameCount ; ++f){
+        AnimationFrame& k = anim.keyFrames[f];
+        k.time = animationtime_t(f / 30.0);
+        k.nodeCount = nodeCount;
+        k.nodes = nodes;
+        for(AnimationNode& n : k.nodes){
+            if(n.keyFramed)
+                keyFrame(n,f / 30.0f);
+        }
+    }
+    anim.frameCount = frameCount;
+    anim.duration = anim.keyFrames.back().time;
+}
+
+}
+}
@@ -0,0 +1,40 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+
+#include <vector>
+
+namespace Saiga {
+
+/**
+ * Two level table from a unicode code point to an index.
+ * A page has 256 entries and is allocated the first time one of its code points is set,
+ * so the memory only depends on the used unicode blocks.
+ */
+class SAIGA_GLOBAL CodePointTable{
+public:
+    static const int maxCodePoint = 0x10FFFF;
+    static const int pageSize = 256;
+
+    static bool validCodePoint(int c){ return c >= 0 && c <= maxCodePoint; }
+
+    //-1 if the code point was not set or is invalid
+    int get(int c) const;
+
+    //Returns false and does nothing for invalid code points.
+    bool set(int c, int index);
+
+    void clear(){ pages.clear(); }
+
+    int allocatedPages() const;
+private:
+    std::vector<std::vector<int>> pages;
+};
+
+}
@@ -37,14 +37,19 @@ public:
     void loadMonochromatic(int fontSize, int glyphPadding = 0);
     void writeGlyphsToFiles(const std::string& prefix);
 
+    //Loads the font face. Afterwards single glyphs can be added with loadGlyph.
+    void loadFace(int fontSize);
+    //Renders one character and adds it to 'glyphs'.
+    //Returns false if the font does not contain this character.
+    bool loadGlyph(int charCode, int glyphPadding = 0);
+
 private:
     static FT_Library ft;
     std::string file;
     std::vector<Unicode::UnicodeBlock> blocks;
     FT_Face face = nullptr;
 
-    void loadFace(int fontSize);
-    void loadAndAddGlyph(int charCode, int glyphPadding);
+    bool loadAndAddGlyph(int charCode, int glyphPadding);
     void addGlyph(int charCode, int glyphPadding);
 };
 
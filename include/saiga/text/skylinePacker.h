@@ -0,0 +1,42 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+#include "saiga/util/glm.h"
+
+#include <vector>
+#include <memory>
+
+namespace Saiga {
+
+/**
+ * Skyline rectangle packer for texture atlases.
+ * Wraps stb_rect_pack, which is compiled once in imgui_draw.cpp.
+ * Rectangles are placed at the lowest possible y, so the used height grows slowly.
+ */
+class SAIGA_GLOBAL SkylinePacker{
+public:
+    SkylinePacker(int width, int height);
+    ~SkylinePacker();
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    //Places one rectangle. Returns false if it does not fit anymore.
+    bool pack(int w, int h, glm::ivec2& position);
+
+    //Places all rectangles at once, which packs tighter than one by one.
+    //Returns false if not all rectangles fit.
+    bool pack(const std::vector<glm::ivec2>& sizes, std::vector<glm::ivec2>& positions);
+private:
+    struct Context;
+    int width, height;
+    std::unique_ptr<Context> context;
+};
+
+}
@@ -64,9 +64,13 @@ private:
     TriangleMesh<VertexNT,GLuint> mesh;
     IndexedVertexBuffer<VertexNT,GLuint> buffer;
     TextureAtlas* textureAtlas;
+    //version of the texture atlas, that was used to create the mesh
+    int atlasVersion;
     AABB boundingBox;
 
     void calculateNormalizationMatrix();
+    //recreates the complete mesh, if the texture coordinates of the atlas changed
+    void checkAtlasVersion();
     void updateGLBuffer(int start, bool resize);
     bool compressText(utf32string &str, int &start, int &lines);
 
@@ -10,16 +10,14 @@
 #include "saiga/util/glm.h"
 #include "saiga/geometry/aabb.h"
 #include "saiga/text/fontLoader.h"
+#include "saiga/text/skylinePacker.h"
+#include "saiga/text/codePointTable.h"
 #include "saiga/opengl/texture/texture.h"
 
-#include <map>
+#include <vector>
 
 namespace Saiga {
 
-//TODO: Better bitmap to sdf conversion
-//Paper: Distance Transforms of Sampled Functions
-//https://cs.brown.edu/~pff/papers/dt-final.pdf
-
 class SAIGA_GLOBAL TextureAtlas{
 public:
     struct character_info {
@@ -40,9 +38,17 @@ public:
     /**
      * Loads a True Type font (.ttf) with libfreetype.
      * This will create the textureAtlas, so it has to be called before any ussage.
+     * All characters of the given blocks are created and packed at once.
      */
     void loadFont(const std::string &font, int fontSize=40, int quality=4, int searchRange=5, bool bufferToFile=false, const std::vector<Unicode::UnicodeBlock> &blocks = {Unicode::BasicLatin});
 
+    /**
+     * Same as loadFont, but the characters are created the first time they are requested by getCharacterInfo.
+     * The atlas starts with 'initialAtlasSize' x 'initialAtlasSize' texels and grows in y direction when it is full.
+     * Use this for large character sets (chat, localisation), where only a few characters are actually used.
+     */
+    void loadFontDynamic(const std::string &font, int fontSize=40, int quality=4, int searchRange=5, int initialAtlasSize=256);
+
     /**
      * Returns the bounding box that could contain every character in this font.
      */
@@ -50,11 +56,14 @@ public:
 
     /**
      * Returns the actual opengl texture.
+     * In the dynamic mode the new characters are uploaded here.
      */
-    std::shared_ptr<Texture> getTexture(){return textureAtlas;}
+    std::shared_ptr<Texture> getTexture();
 
     /**
      * Returns information to a specific character in this font.
+     * In the dynamic mode unknown characters are created.
+     * The reference is valid until the next character is created.
      */
     const character_info& getCharacterInfo(int c);
 
@@ -63,6 +72,12 @@ public:
      */
     float getLineSpacing(){ return (maxCharacter.max - maxCharacter.min).y + additionalLineSpacing;}
 
+    /**
+     * Is incremented every time the texture coordinates of existing characters or the max character change.
+     * Meshes that were created with an older version have to be recreated.
+     */
+    int getVersion(){ return version; }
+
 
     //these values are added to the default line and character spacings.
     //a positive value moves the characters and lines further apart
@@ -70,7 +85,6 @@ public:
     float additionalLineSpacing = 0;
     float additionalCharacterSpacing = 0;
 private:
-
     //distance between characters in texture atlas
     int charPaddingX = 0;
     int charPaddingY = 0;
@@ -78,25 +92,42 @@ private:
     int atlasHeight;
     int atlasWidth;
 
-//    static const int maxNumCharacters = 256;
-
     character_info invalidCharacter;
-    std::map<int,character_info> characterInfoMap;
-//    character_info characters[maxNumCharacters];
+    //all characters in the order they were created
+    std::vector<character_info> characters;
+    //code point -> index in 'characters'
+    CodePointTable characterLookup;
     int numCharacters = 0;
-//    std::vector<character_info> characterInfoMap = std::vector<character_info>(maxNumCharacters);
 
     std::shared_ptr<Texture> textureAtlas = nullptr;
     AABB maxCharacter;
     //std::string font;
     std::string uniqueFontString;
+    int version = 0;
+
+    //dynamic mode
+    bool dynamic = false;
+    int glyphQuality, glyphSearchRadius, glyphPadding;
+    std::shared_ptr<FontLoader> fontLoader;
+    std::shared_ptr<SkylinePacker> packer;
+    Image atlasImage;
+    //rows of atlasImage that have to be uploaded
+    int dirtyStart = 0, dirtyEnd = 0;
 
 
     void createTextureAtlas(Image &outImg, std::vector<FontLoader::Glyph> &glyphs, int downsample, int searchRadius);
     void calculateTextureAtlasLayout(std::vector<FontLoader::Glyph> &glyphs);
     void padGlyphsToDivisor(std::vector<FontLoader::Glyph> &glyphs, int divisor);
+    //exact euclidean distance transform of each glyph, the glyphs are processed in parallel
     void convertToSDF(std::vector<FontLoader::Glyph> &glyphs, int divisor, int searchRadius);
-    std::vector<glm::ivec2> generateSDFsamples(int searchRadius);
+
+    //-1 if the character does not exist (yet), -2 if the font does not contain it
+    int findCharacter(int c){ return characterLookup.get(c); }
+    character_info& addCharacterInfo(FontLoader::Glyph &g);
+    void calculateTextureCoordinates(character_info &info);
+    void copyGlyphToAtlas(Image &outImg, FontLoader::Glyph &g, const character_info &info);
+    int createCharacter(int c);
+    void growAtlas();
 
     void writeAtlasToFiles(Image &img);
     bool readAtlasFromFiles();
@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include <saiga/config.h>
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+namespace Saiga {
+
+/**
+ * Lets threads sleep until a condition, which is checked without locks, becomes true.
+ * On Linux the threads are parked with a futex on the epoch counter. Other platforms use a condition variable.
+ * Notifying is only an atomic load if nobody is waiting.
+ *
+ * Usage (waiting thread):
+ *
+ * for(;;){
+ *     if(condition()) break;
+ *     auto key = ec.prepareWait();
+ *     if(condition()){ ec.cancelWait(); break; }
+ *     ec.wait(key);
+ * }
+ *
+ * The notifying thread makes the condition true and then calls notifyOne or notifyAll.
+ */
+class SAIGA_GLOBAL EventCount
+{
+public:
+    EventCount() : epoch(0), waiters(0) {}
+
+    unsigned int prepareWait(){
+        waiters.fetch_add(1);
+        //make sure the condition is checked again after the waiter is registered
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return epoch.load();
+    }
+
+    void cancelWait(){
+        waiters.fetch_sub(1);
+    }
+
+    //blocks until a notify happens after 'prepareWait' returned 'key'
+    void wait(unsigned int key);
+
+    void notifyOne(){
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(waiters.load(std::memory_order_relaxed) > 0)
+            notify(false);
+    }
+
+    void notifyAll(){
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(waiters.load(std::memory_order_relaxed) > 0)
+            notify(true);
+    }
+private:
+    std::atomic<unsigned int> epoch;
+    std::atomic<int> waiters;
+
+#ifndef __linux__
+    std::mutex lock;
+    std::condition_variable cv;
+#endif
+
+    void notify(bool all);
+};
+
+}
@@ -1,5 +1,5 @@
 /**
- * Copyright (c) 2017 Darius Rückert 
+ * Copyright (c) 2017 Darius Rückert
  * Licensed under the MIT License.
  * See LICENSE file for more information.
  */
@@ -8,9 +8,17 @@
 
 #include <saiga/config.h>
 #include "saiga/util/assert.h"
+#include "saiga/util/taskScheduler.h"
 
 #include <vector>
-#include <tuple>
+#include <list>
+#include <unordered_map>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <iostream>
 
 namespace Saiga {
 
@@ -25,18 +33,61 @@ SAIGA_GLOBAL inline bool operator==(const NoParams& lhs, const NoParams& rhs) {
     return true;
 }
 
+//Every param_t needs an operator== and a loaderHash overload, which is found by argument dependent lookup.
+SAIGA_GLOBAL inline size_t loaderHash(const NoParams& params) {
+    (void)params;
+    return 0;
+}
+
+//An object is in use, if somebody else than the loader holds a reference to it.
+//These objects are not evicted, because a reload would create a second copy.
+template<typename T>
+bool loaderObjectInUse(const std::shared_ptr<T>& object){ return object.use_count() > 1; }
+template<typename T>
+bool loaderObjectInUse(const T& object){ (void)object; return false; }
+
 
+/**
+ * Base class of the resource loaders (textures, shaders, ...).
+ *
+ * The loaded objects are cached with a hash of (name,params), so load() and getLoaded() are O(1).
+ * With a memory budget the least recently used objects are removed from the cache,
+ * if they are not pinned and not used anywhere else.
+ *
+ * loadAsync() decodes the object on the default TaskScheduler. Because many objects (for example textures)
+ * have to be created in the thread of the OpenGL context, the loading is split in two parts:
+ *  - decodeAsync() runs on a worker thread and returns the intermediate data.
+ *  - finishAsync() creates the object from this data and runs in update().
+ * The default implementation calls loadFromFile in decodeAsync, so loadFromFile has to be thread safe in that case.
+ *
+ * The tasks call the virtual decodeAsync, so every loader that uses loadAsync has to call waitAsync()
+ * in its destructor. In ~Loader the virtual functions of the derived class are already gone.
+ */
 template <typename object_t, typename param_t = NoParams>
 class Loader{
 protected:
     std::vector<std::string> locations; //locations where to search
 
+    struct CacheEntry{
+        std::string name; //name passed in load()
+        param_t params;   //params passed in load()
+        object_t object;
+        size_t hash;
+        size_t memory = 0;
+        bool pinned = false;
+        bool pending = false; //the object is decoded by loadAsync
+        std::shared_ptr<std::promise<object_t>> promise;
+        std::shared_future<object_t> future;
+    };
+    typedef typename std::list<CacheEntry>::iterator entry_iterator;
+
+    //ordered by the last usage, the most recently used object is in the front
+    std::list<CacheEntry> entries;
+    std::unordered_multimap<size_t,entry_iterator> index;
+
+    size_t memoryBudget = 0;
+    size_t memoryUsage = 0;
 
-    //string: name passed in load(), param: params passed in load()
-    typedef std::tuple<std::string, param_t, object_t> data_t;
-
-
-    std::vector<data_t> objects;
 public:
 //    Loader(){};
     virtual ~Loader();
@@ -49,13 +100,66 @@ public:
     virtual object_t getLoaded(const std::string &name, const param_t &params=param_t());
     void put(const std::string &name, object_t obj, const param_t &params=param_t());
 
+    /**
+     * Starts loading the object on a worker thread and returns immediately.
+     * The future is ready after update() finished the object. It contains nullptr if the object was not found.
+     */
+    std::shared_future<object_t> loadAsync(const std::string &name, const param_t &params=param_t());
+
+    /**
+     * Finishes the objects of loadAsync, which are decoded.
+     * Has to be called regularly by the thread that calls load() (for example once per frame).
+     */
+    void update();
+
+    //Waits until all asynchronous loads are finished.
+    void waitAsync();
+
+    //Pinned objects are never evicted.
+    void setPinned(const std::string &name, bool pinned = true, const param_t &params=param_t());
+
+    //0 means unlimited. Objects over the budget are evicted immediately.
+    void setMemoryBudget(size_t bytes);
+    size_t getMemoryUsage(){ return memoryUsage; }
+    int numLoadedObjects(){ return entries.size(); }
+
 protected:
     virtual object_t exists(const std::string &name, const param_t &params=param_t());
     virtual object_t loadFromFile(const std::string &name, const param_t &params) = 0;
+
+    //see class description
+    virtual std::shared_ptr<void> decodeAsync(const std::string &name, const param_t &params);
+    virtual object_t finishAsync(std::shared_ptr<void> decoded, const std::string &name, const param_t &params);
+
+    //Memory that is counted for the budget. Objects of size 0 are never evicted.
+    virtual size_t memorySize(const object_t& object){ (void)object; return 0; }
+
+    size_t hashKey(const std::string &name, const param_t &params);
+    //returns entries.end() if there is no entry
+    entry_iterator findEntry(const std::string &name, const param_t &params);
+    entry_iterator insert(const std::string &name, object_t obj, const param_t &params);
+    //moves the entry to the front of the lru list
+    void touch(entry_iterator it){ entries.splice(entries.begin(),entries,it); }
+    void remove(entry_iterator it);
+    void evict();
+
+private:
+    //shared with the worker threads, so the tasks do not depend on the lifetime of the loader
+    struct AsyncState{
+        std::mutex lock;
+        int inFlight = 0;
+        //name, params and the result of decodeAsync
+        std::vector<std::tuple<std::string,param_t,std::shared_ptr<void>>> decoded;
+    };
+    std::shared_ptr<AsyncState> asyncState;
 };
 
 template<typename object_t, typename param_t >
 Loader<object_t,param_t>:: ~Loader(){
+    if(asyncState){
+        std::unique_lock<std::mutex> l(asyncState->lock);
+        SAIGA_ASSERT(asyncState->inFlight == 0,"call waitAsync() in the destructor of the derived loader");
+    }
     clear();
 }
 
@@ -65,18 +169,107 @@ void Loader<object_t,param_t>::clear(){
 //    for(data_t &object : objects){
 //        delete std::get<2>(object);
 //    }
-    objects.clear();
+    //pending objects are kept, they are still finished by update()
+    for(auto it = entries.begin() ; it != entries.end() ; ){
+        auto current = it++;
+        if(!current->pending)
+            remove(current);
+    }
+}
+
+template<typename object_t, typename param_t >
+size_t Loader<object_t,param_t>::hashKey(const std::string &name, const param_t &params){
+    size_t h = std::hash<std::string>()(name);
+    return h ^ (loaderHash(params) + 0x9e3779b9 + (h << 6) + (h >> 2));
+}
+
+template<typename object_t, typename param_t >
+typename Loader<object_t,param_t>::entry_iterator Loader<object_t,param_t>::findEntry(const std::string &name, const param_t &params){
+    auto range = index.equal_range(hashKey(name,params));
+    for(auto it = range.first ; it != range.second ; ++it){
+        CacheEntry& e = *it->second;
+        if(e.name == name && e.params == params)
+            return it->second;
+    }
+    return entries.end();
+}
+
+template<typename object_t, typename param_t >
+typename Loader<object_t,param_t>::entry_iterator Loader<object_t,param_t>::insert(const std::string &name, object_t obj, const param_t &params){
+    CacheEntry e;
+    e.name = name;
+    e.params = params;
+    e.object = obj;
+    e.hash = hashKey(name,params);
+    entries.push_front(e);
+    index.emplace(e.hash,entries.begin());
+    if(obj){
+        entries.front().memory = memorySize(obj);
+        memoryUsage += entries.front().memory;
+    }
+    return entries.begin();
+}
+
+template<typename object_t, typename param_t >
+void Loader<object_t,param_t>::remove(entry_iterator it){
+    auto range = index.equal_range(it->hash);
+    for(auto i = range.first ; i != range.second ; ++i){
+        if(i->second == it){
+            index.erase(i);
+            break;
+        }
+    }
+    memoryUsage -= it->memory;
+    entries.erase(it);
+}
+
+template<typename object_t, typename param_t >
+void Loader<object_t,param_t>::evict(){
+    if(memoryBudget == 0)
+        return;
+    for(auto it = entries.end() ; memoryUsage > memoryBudget && it != entries.begin() ; ){
+        --it;
+        CacheEntry& e = *it;
+        if(e.pinned || e.pending || e.memory == 0 || loaderObjectInUse(e.object))
+            continue;
+        auto current = it++;
+        remove(current);
+    }
+}
+
+template<typename object_t, typename param_t >
+void Loader<object_t,param_t>::setMemoryBudget(size_t bytes){
+    memoryBudget = bytes;
+    evict();
+}
+
+template<typename object_t, typename param_t >
+void Loader<object_t,param_t>::setPinned(const std::string &name, bool pinned, const param_t &params){
+    auto it = findEntry(name,params);
+    SAIGA_ASSERT(it != entries.end(),"object is not loaded!");
+    it->pinned = pinned;
+    if(!pinned)
+        evict();
 }
 
 template<typename object_t, typename param_t >
 object_t Loader<object_t,param_t>::exists(const std::string &name, const param_t &params){
     //check if already exists
-    for(data_t &data : objects){
-        if(std::get<0>(data)==name && std::get<1>(data)==params){
-            return std::get<2>(data);
-        }
+    auto it = findEntry(name,params);
+    if(it == entries.end())
+        return nullptr;
+    //a synchronous load of an object, that is currently loaded asynchronously.
+    //update() removes the entry if the loading failed.
+    while(it->pending){
+        if(!defaultTaskScheduler().tryRunOne())
+            std::this_thread::yield();
+        update();
+        it = findEntry(name,params);
+        if(it == entries.end())
+            return nullptr;
     }
-    return nullptr;
+    touch(it);
+    return it->object;
 }
 
 
@@ -95,7 +288,8 @@ object_t Loader<object_t,param_t>::load(const std::string &name, const param_t &
         object = loadFromFile(complete_path,params);
         if (object){
             std::cout<<"Loaded from file: "<<complete_path<<std::endl;
-            objects.emplace_back(name,params,object);
+            insert(name,object,params);
+            evict();
             return object;
         }
     }
@@ -124,10 +318,120 @@ object_t Loader<object_t,param_t>::getLoaded(const std::string &name, const para
 template<typename object_t, typename param_t >
 void Loader<object_t,param_t>::put(const std::string &name, object_t obj, const param_t &params){
 
-    SAIGA_ASSERT(!exists(name,params),"object was already loaded!");
+    SAIGA_ASSERT(findEntry(name,params) == entries.end(),"object was already loaded!");
     SAIGA_ASSERT(obj);
 
-    objects.emplace_back(name,params,obj);
+    insert(name,obj,params);
+    evict();
+}
+
+template<typename object_t, typename param_t >
+std::shared_future<object_t> Loader<object_t,param_t>::loadAsync(const std::string &name, const param_t &params){
+    auto it = findEntry(name,params);
+    if(it != entries.end()){
+        touch(it);
+        if(it->pending)
+            return it->future;
+        std::promise<object_t> ready;
+        ready.set_value(it->object);
+        return ready.get_future().share();
+    }
+
+    it = insert(name,nullptr,params);
+    it->pending = true;
+    it->promise = std::make_shared<std::promise<object_t>>();
+    it->future = it->promise->get_future().share();
+
+    if(!asyncState)
+        asyncState = std::make_shared<AsyncState>();
+    std::shared_ptr<AsyncState> state = asyncState;
+    {
+        std::unique_lock<std::mutex> l(state->lock);
+        state->inFlight++;
+    }
+
+    //the loader has to outlive the task, because the virtual decode function is called (see waitAsync)
+    std::vector<std::string> paths = locations;
+    Loader* loader = this;
+    defaultTaskScheduler().submit(Task([state,paths,name,params,loader](){
+        std::shared_ptr<void> decoded;
+        for(const std::string &path : paths){
+            decoded = loader->decodeAsync(path + "/" + name,params);
+            if(decoded)
+                break;
+        }
+        std::unique_lock<std::mutex> l(state->lock);
+        state->decoded.emplace_back(name,params,decoded);
+    }));
+    return it->future;
+}
+
+template<typename object_t, typename param_t >
+void Loader<object_t,param_t>::update(){
+    if(!asyncState)
+        return;
+    std::vector<std::tuple<std::string,param_t,std::shared_ptr<void>>> decoded;
+    {
+        std::unique_lock<std::mutex> l(asyncState->lock);
+        decoded.swap(asyncState->decoded);
+        asyncState->inFlight -= decoded.size();
+    }
+
+    for(auto &d : decoded){
+        const std::string &name = std::get<0>(d);
+        const param_t &params = std::get<1>(d);
+        auto it = findEntry(name,params);
+        SAIGA_ASSERT(it != entries.end() && it->pending);
+
+        object_t object = nullptr;
+        if(std::get<2>(d))
+            object = finishAsync(std::get<2>(d),name,params);
+        if(!object){
+            std::cout<<"Failed to load "<<name<<"!!!"<<std::endl;
+        }
+
+        it->pending = false;
+        it->object = object;
+        it->memory = object ? memorySize(object) : 0;
+        memoryUsage += it->memory;
+        it->promise->set_value(object);
+        //the future holds a reference to the object, which would block the eviction
+        it->promise = nullptr;
+        it->future = std::shared_future<object_t>();
+        if(!object)
+            remove(it);
+    }
+    if(!decoded.empty())
+        evict();
+}
+
+template<typename object_t, typename param_t >
+void Loader<object_t,param_t>::waitAsync(){
+    while(asyncState){
+        update();
+        {
+            std::unique_lock<std::mutex> l(asyncState->lock);
+            if(asyncState->inFlight == 0)
+                break;
+        }
+        //helps the workers instead of spinning
+        if(!defaultTaskScheduler().tryRunOne())
+            std::this_thread::yield();
+    }
+}
+
+template<typename object_t, typename param_t >
+std::shared_ptr<void> Loader<object_t,param_t>::decodeAsync(const std::string &name, const param_t &params){
+    object_t object = loadFromFile(name,params);
+    if(!object)
+        return nullptr;
+    return std::make_shared<object_t>(object);
+}
+
+template<typename object_t, typename param_t >
+object_t Loader<object_t,param_t>::finishAsync(std::shared_ptr<void> decoded, const std::string &name, const param_t &params){
+    (void)name; (void)params;
+    return *std::static_pointer_cast<object_t>(decoded);
 }
 
 }
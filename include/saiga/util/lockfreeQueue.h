@@ -0,0 +1,238 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+#include "saiga/util/eventCount.h"
+
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <cstdint>
+
+namespace Saiga {
+
+//Variables that are written by different threads are placed on different cache lines to prevent false sharing.
+#define SAIGA_CACHE_LINE_SIZE 64
+
+namespace LockfreeQueueDetail {
+
+inline size_t nextPowerOfTwo(size_t v){
+    size_t p = 1;
+    while(p < v)
+        p *= 2;
+    return p;
+}
+
+//Blocking operations spin for a short time before the thread is parked,
+//because a context switch is much more expensive than a few failed tries.
+template<typename TRY>
+bool spinTry(TRY t){
+    for(int i = 0 ; i < 64 ; ++i){
+        if(t())
+            return true;
+    }
+    for(int i = 0 ; i < 16 ; ++i){
+        std::this_thread::yield();
+        if(t())
+            return true;
+    }
+    return false;
+}
+
+template<typename TRY>
+void blockingTry(EventCount& ec, TRY t){
+    if(spinTry(t))
+        return;
+    for(;;){
+        unsigned int key = ec.prepareWait();
+        if(t()){
+            ec.cancelWait();
+            return;
+        }
+        ec.wait(key);
+        if(t())
+            return;
+    }
+}
+
+}
+
+/**
+ * A bounded lock-free queue for exactly one producer and one consumer thread.
+ * Has the same interface as SynchronizedBuffer.
+ *
+ * Both sides keep a cached copy of the other side's index, so the shared indices
+ * are only read when the queue looks full (or empty).
+ * add and get block if the queue is full (empty). After a short spinning phase
+ * the thread is parked with an EventCount (a futex on Linux).
+ */
+template<typename T>
+class SAIGA_TEMPLATE SPSCQueue{
+public:
+    //the capacity is rounded up to the next power of two
+    SPSCQueue(int capacity)
+        : buffer(LockfreeQueueDetail::nextPowerOfTwo(capacity)), mask(buffer.size() - 1),
+          tail(0), cachedHead(0), head(0), cachedTail(0) {
+    }
+
+    bool tryAdd(const T& data){
+        size_t t = tail.load(std::memory_order_relaxed);
+        if(t - cachedHead == buffer.size()){
+            cachedHead = head.load(std::memory_order_acquire);
+            if(t - cachedHead == buffer.size())
+                return false;
+        }
+        buffer[t & mask] = data;
+        tail.store(t + 1, std::memory_order_release);
+        notEmpty.notifyOne();
+        return true;
+    }
+
+    bool tryGet(T& v){
+        size_t h = head.load(std::memory_order_relaxed);
+        if(h == cachedTail){
+            cachedTail = tail.load(std::memory_order_acquire);
+            if(h == cachedTail)
+                return false;
+        }
+        v = std::move(buffer[h & mask]);
+        head.store(h + 1, std::memory_order_release);
+        notFull.notifyOne();
+        return true;
+    }
+
+    void add(T data){
+        LockfreeQueueDetail::blockingTry(notFull,[&](){ return this->tryAdd(data); });
+    }
+
+    T get(){
+        T result;
+        LockfreeQueueDetail::blockingTry(notEmpty,[&](){ return this->tryGet(result); });
+        return result;
+    }
+
+    //only exact if called by the producer or consumer while the other side is idle
+    bool empty() const { return head.load() == tail.load(); }
+    int count() const { return int(tail.load() - head.load()); }
+    int capacity() const { return buffer.size(); }
+private:
+    std::vector<T> buffer;
+    size_t mask;
+
+    char pad0[SAIGA_CACHE_LINE_SIZE];
+    //written by the producer
+    std::atomic<size_t> tail;
+    size_t cachedHead;
+
+    char pad1[SAIGA_CACHE_LINE_SIZE];
+    //written by the consumer
+    std::atomic<size_t> head;
+    size_t cachedTail;
+
+    char pad2[SAIGA_CACHE_LINE_SIZE];
+    EventCount notEmpty, notFull;
+};
+
+
+/**
+ * A bounded lock-free queue for any number of producers and consumers.
+ * Has the same interface as SynchronizedBuffer.
+ *
+ * Implementation of Dmitry Vyukov's bounded MPMC queue:
+ * http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+ * Every cell has a sequence number, which tells the producers and consumers
+ * if the cell is free or contains data for the current round.
+ */
+template<typename T>
+class SAIGA_TEMPLATE MPMCQueue{
+public:
+    //the capacity is rounded up to the next power of two
+    MPMCQueue(int capacity)
+        : cells(LockfreeQueueDetail::nextPowerOfTwo(capacity)), mask(cells.size() - 1),
+          enqueuePos(0), dequeuePos(0) {
+        for(size_t i = 0 ; i < cells.size() ; ++i){
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool tryAdd(const T& data){
+        Cell* cell;
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        for(;;){
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if(diff == 0){
+                if(enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }else if(diff < 0){
+                //the cell still contains data of the last round
+                return false;
+            }else{
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = data;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        notEmpty.notifyOne();
+        return true;
+    }
+
+    bool tryGet(T& v){
+        Cell* cell;
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        for(;;){
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+            if(diff == 0){
+                if(dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }else if(diff < 0){
+                //no data written to this cell yet
+                return false;
+            }else{
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        v = std::move(cell->data);
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        notFull.notifyOne();
+        return true;
+    }
+
+    void add(T data){
+        LockfreeQueueDetail::blockingTry(notFull,[&](){ return this->tryAdd(data); });
+    }
+
+    T get(){
+        T result;
+        LockfreeQueueDetail::blockingTry(notEmpty,[&](){ return this->tryGet(result); });
+        return result;
+    }
+
+    int capacity() const { return cells.size(); }
+private:
+    struct Cell{
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    std::vector<Cell> cells;
+    size_t mask;
+
+    char pad0[SAIGA_CACHE_LINE_SIZE];
+    std::atomic<size_t> enqueuePos;
+    char pad1[SAIGA_CACHE_LINE_SIZE];
+    std::atomic<size_t> dequeuePos;
+    char pad2[SAIGA_CACHE_LINE_SIZE];
+
+    EventCount notEmpty, notFull;
+};
+
+}
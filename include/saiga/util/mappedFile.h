@@ -0,0 +1,54 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include "saiga/config.h"
+
+#include <string>
+#include <cstdint>
+
+namespace Saiga {
+
+/**
+ * A read only memory mapping of a complete file.
+ * Uses mmap on unix and MapViewOfFile on windows.
+ * The pages are loaded on first access, so the file can be larger than the available memory.
+ */
+class SAIGA_GLOBAL MappedFile
+{
+public:
+    MappedFile(){}
+    MappedFile(const std::string& file){ open(file); }
+    ~MappedFile(){ close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    //Returns false if the file does not exist or can not be mapped.
+    //An empty file is valid, but data() is null.
+    bool open(const std::string& file);
+    void close();
+
+    bool isOpen() const { return opened; }
+    const char* data() const { return ptr; }
+    size_t size() const { return length; }
+
+    //Size and last modification time of a file without opening it.
+    //The time is in nanoseconds (as precise as the file system) and should only be compared for equality.
+    //Returns false if the file does not exist.
+    static bool fileStats(const std::string& file, uint64_t& size, int64_t& modificationTime);
+private:
+    const char* ptr = nullptr;
+    size_t length = 0;
+    bool opened = false;
+#if defined(_WIN32)
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+}
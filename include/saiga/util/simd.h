@@ -0,0 +1,32 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include <saiga/config.h>
+
+//Compile time detection of the available simd instruction sets.
+//Only include this in source files, because the result depends on the compiler flags
+//of the current translation unit.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SAIGA_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__SSSE3__) || defined(__AVX__)
+#define SAIGA_HAS_SSSE3
+#include <tmmintrin.h>
+#endif
+
+#if defined(__AVX__)
+#define SAIGA_HAS_AVX
+#include <immintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define SAIGA_HAS_AVX2
+#endif
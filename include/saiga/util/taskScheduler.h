@@ -0,0 +1,264 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#pragma once
+
+#include <saiga/config.h>
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <type_traits>
+#include <algorithm>
+
+namespace Saiga {
+
+/**
+ * A type erased 'void()' callable, similar to std::function.
+ * Callables up to 'bufferSize' bytes are stored inline, so creating a task
+ * for a small lambda does not allocate memory. Only larger callables are moved to the heap.
+ * Tasks can only be moved, not copied.
+ */
+class SAIGA_GLOBAL Task
+{
+public:
+    static const int bufferSize = 48;
+
+    Task(){}
+
+    template<typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type,Task>::value>::type>
+    Task(F&& f);
+
+    Task(Task&& other){ moveFrom(other); }
+    Task& operator=(Task&& other){
+        if(this != &other){
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task(){ reset(); }
+
+    void operator()(){ ops->invoke(&storage); }
+    explicit operator bool() const { return ops != nullptr; }
+
+    void reset(){
+        if(ops){
+            ops->destroy(&storage);
+            ops = nullptr;
+        }
+    }
+private:
+    struct Ops{
+        void (*invoke)(void*);
+        //move constructs the callable at dst and destroys src
+        void (*move)(void* dst, void* src);
+        void (*destroy)(void*);
+    };
+
+    template<typename F>
+    struct InlineOps{
+        static void invoke(void* p){ (*static_cast<F*>(p))(); }
+        static void move(void* dst, void* src){
+            new (dst) F(std::move(*static_cast<F*>(src)));
+            static_cast<F*>(src)->~F();
+        }
+        static void destroy(void* p){ static_cast<F*>(p)->~F(); }
+        static const Ops ops;
+    };
+
+    template<typename F>
+    struct HeapOps{
+        static void invoke(void* p){ (**static_cast<F**>(p))(); }
+        static void move(void* dst, void* src){ *static_cast<F**>(dst) = *static_cast<F**>(src); }
+        static void destroy(void* p){ delete *static_cast<F**>(p); }
+        static const Ops ops;
+    };
+
+    typename std::aligned_storage<bufferSize,alignof(double)>::type storage;
+    const Ops* ops = nullptr;
+
+    template<typename F>
+    struct FitsInline : std::integral_constant<bool,sizeof(F) <= bufferSize && alignof(F) <= alignof(double)>{};
+
+    //selected at compile time, so the placement new is only instantiated for callables that fit
+    template<typename C, typename F>
+    void construct(F&& f, std::true_type){
+        new (&storage) C(std::forward<F>(f));
+        ops = &InlineOps<C>::ops;
+    }
+    template<typename C, typename F>
+    void construct(F&& f, std::false_type){
+        *reinterpret_cast<C**>(&storage) = new C(std::forward<F>(f));
+        ops = &HeapOps<C>::ops;
+    }
+
+    void moveFrom(Task& other){
+        if(other.ops){
+            other.ops->move(&storage,&other.storage);
+            ops = other.ops;
+            other.ops = nullptr;
+        }
+    }
+};
+
+template<typename F>
+const Task::Ops Task::InlineOps<F>::ops = {&Task::InlineOps<F>::invoke, &Task::InlineOps<F>::move, &Task::InlineOps<F>::destroy};
+
+template<typename F>
+const Task::Ops Task::HeapOps<F>::ops = {&Task::HeapOps<F>::invoke, &Task::HeapOps<F>::move, &Task::HeapOps<F>::destroy};
+
+template<typename F, typename>
+Task::Task(F&& f)
+{
+    typedef typename std::decay<F>::type callable_t;
+    construct<callable_t>(std::forward<F>(f),FitsInline<callable_t>());
+}
+
+
+class TaskGroup;
+
+/**
+ * A work stealing task scheduler.
+ *
+ * Every worker thread has its own task queue. New tasks created by a worker are pushed to
+ * the back of its own queue and taken from there (LIFO), which keeps the working set in the cache.
+ * Idle workers steal the oldest task from the front of another worker's queue.
+ * Tasks submitted from outside the scheduler are distributed round robin on the queues.
+ *
+ * Use it through TaskGroup and parallelFor:
+ *
+ * TaskGroup group;
+ * group.run([](){ ... });
+ * group.run([](){ ... });
+ * group.wait();
+ *
+ * parallelFor(0,n,[&](int i){ data[i] = ...; });
+ */
+class SAIGA_GLOBAL TaskScheduler
+{
+public:
+    //threads = -1: one worker for each hardware thread
+    TaskScheduler(int threads = -1);
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    int numThreads() const { return workers.size(); }
+
+    //adds a task to the queues. if group is not null its counter is decremented after the task finished.
+    void submit(Task task, TaskGroup* group = nullptr);
+
+    //executes one pending task in the calling thread.
+    //returns false if no task was found.
+    bool tryRunOne();
+private:
+    struct Job{
+        Task task;
+        TaskGroup* group = nullptr;
+    };
+
+    //A growable ring buffer guarded by a mutex.
+    //The owner works on the back and the thieves on the front, so the lock is almost never contended.
+    struct WorkQueue{
+        std::mutex lock;
+        std::vector<Job> jobs;
+        size_t front = 0, count = 0;
+
+        void pushBack(Job& job);
+        bool popBack(Job& job);
+        bool popFront(Job& job);
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<WorkQueue*> queues;
+
+    std::atomic<int> queuedJobs;
+    std::atomic<unsigned int> nextQueue;
+
+    std::mutex sleepLock;
+    std::condition_variable sleepCondition;
+    std::atomic<int> sleepingWorkers;
+    bool stop = false;
+
+    void workerFunc(int id);
+    bool getJob(int id, Job& job, bool allowSteal);
+    void execute(Job& job);
+};
+
+//The scheduler used by TaskGroup and parallelFor if none is given.
+//It is created on the first call with one worker per hardware thread.
+SAIGA_GLOBAL TaskScheduler& defaultTaskScheduler();
+
+
+/**
+ * A set of tasks that can be waited on.
+ * The waiting thread executes pending tasks until all tasks of this group are finished,
+ * which makes nested parallelism (tasks creating and waiting on other tasks) deadlock free.
+ * If there is nothing to execute, it blocks until the last task of the group is finished.
+ */
+class SAIGA_GLOBAL TaskGroup
+{
+public:
+    TaskGroup(TaskScheduler& scheduler = defaultTaskScheduler()) : scheduler(scheduler), pending(0) {}
+    ~TaskGroup(){ wait(); }
+
+    template<typename F>
+    void run(F&& f){
+        pending++;
+        scheduler.submit(Task(std::forward<F>(f)),this);
+    }
+
+    void wait();
+private:
+    friend class TaskScheduler;
+    TaskScheduler& scheduler;
+    std::atomic<int> pending;
+
+    //the waiting thread sleeps here if it can not find a task to execute
+    std::mutex lock;
+    std::condition_variable finished;
+    void taskFinished();
+};
+
+
+//Calls f(i) for all i in [begin,end).
+//The range is split into chunks of 'chunkSize' indices, each chunk is one task.
+//chunkSize <= 0: about 4 chunks per worker thread.
+template<typename F>
+void parallelFor(TaskScheduler& scheduler, int begin, int end, int chunkSize, F f)
+{
+    if(end <= begin)
+        return;
+    if(chunkSize <= 0)
+        chunkSize = std::max(1, (end - begin) / (4 * scheduler.numThreads()));
+
+    TaskGroup group(scheduler);
+    for(int start = begin ; start < end ; start += chunkSize){
+        int stop = std::min(start + chunkSize, end);
+        group.run([&f,start,stop](){
+            for(int i = start ; i < stop ; ++i){
+                f(i);
+            }
+        });
+    }
+    group.wait();
+}
+
+template<typename F>
+void parallelFor(int begin, int end, F f)
+{
+    parallelFor(defaultTaskScheduler(),begin,end,0,f);
+}
+
+}
@@ -13,6 +13,7 @@
 #include "saiga/imgui/imgui_renderer.h"
 
 #include <thread>
+#include <functional>
 
 namespace Saiga {
 
@@ -21,6 +22,8 @@ class Deferred_Renderer;
 class Program;
 struct RenderingParameters;
 class Image;
+class AsyncReadback;
+class TaskGroup;
 
 
 struct SAIGA_GLOBAL OpenGLParameters{
@@ -109,6 +112,10 @@ protected:
     float imRenderTimes[numGraphValues];
     bool showRendererImgui = false;
     bool showImguiDemo = false;
+
+    //pixel pack buffers for the asynchronous reads and the tasks that write the screenshots
+    std::shared_ptr<AsyncReadback> readback;
+    std::shared_ptr<TaskGroup> screenshotTasks;
 public:
     std::shared_ptr<ImGuiRenderer> imgui;
     ExponentialTimer updateTimer, interpolationTimer, renderCPUTimer, swapBuffersTimer;
@@ -139,6 +146,19 @@ public:
     void screenshot(const std::string &file);
     void screenshotRender(const std::string &file);
 
+    /**
+     * Reading the default framebuffer without stalling the pipeline.
+     * The image is passed to the callback two frames later, after the buffers were swapped.
+     * If 'out' is null an RGB image with the size of the window is created.
+     */
+    void readToImageAsync(std::function<void(std::shared_ptr<Image>)> callback, std::shared_ptr<Image> out = nullptr);
+
+    //like screenshot, but the image is read asynchronously and written to file on a worker thread
+    void screenshotAsync(const std::string &file);
+
+    //finishes all asynchronous reads and waits until the screenshots are written
+    void finishAsyncReads();
+
 
     //Basic getters and setters
 
@@ -64,5 +64,25 @@ int main(int argc, char *argv[]) {
 
 
     Tests::fpTest();
+    Tests::raytracerBenchmark();
+    Tests::kdtreeBenchmark();
+    Tests::kdtreeApproximationBenchmark(1000000);
+    Tests::taskSchedulerBenchmark();
+    Tests::queueBenchmark();
+    Tests::videoEncoderBenchmark();
+    Tests::imageConversionBenchmark();
+    Tests::resampleBenchmark();
+    Tests::objLoaderBenchmark();
+    Tests::sdfBenchmark();
+    Tests::glyphAtlasBenchmark();
+    Tests::loaderBenchmark();
+    Tests::skeletonBenchmark();
+    Tests::animationCompressionBenchmark();
+    Tests::cullingBenchmark();
+    Tests::skinningBenchmark();
+    Tests::vertexQuantizationBenchmark();
+    Tests::meshOptimizerBenchmark();
+    Tests::meshSimplificationBenchmark();
+    Tests::renderQueueBenchmark();
 
 }
@@ -84,10 +84,12 @@ void VideoRecording::update(float dt){
     if(encoder && frame++%frameSkip==0){
         //the encoder manages a buffer of a few frames
         auto img = encoder->getFrameBuffer();
-        //read the current framebuffer to the buffer
-        parentWindow->readToExistingImage(*img);
-        //add an image to the video stream
-        encoder->addFrame(img);
+        //read the current framebuffer to the buffer without waiting for the gpu
+        //and add the image to the video stream two frames later
+        auto enc = encoder;
+        parentWindow->readToImageAsync([enc](std::shared_ptr<Image> img){
+            enc->addFrame(img);
+        },img);
     }
 
     remainingFrames--;
@@ -228,6 +230,8 @@ void VideoRecording::renderFinal(Camera *cam)
         if(encoder){
             if(remainingFrames <= 0 || ImGui::Button("Stop Recording")){
                 SAIGA_ASSERT(encoder);
+                //the last frames are still read asynchronously
+                parentWindow->finishAsyncReads();
                 encoder->finishEncoding();
                 encoder.reset();
             }
@@ -0,0 +1,34 @@
+/**
+ * Copyright (c) 2017 Darius Rückert 
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+
+##GL_VERTEX_SHADER
+
+#version 330
+layout(location=0) in vec3 in_position;
+
+//instancing
+layout(location=4) in mat4 in_model;
+
+#include "camera.glsl"
+
+void main() {
+    gl_Position = viewProj *in_model* vec4(in_position,1);
+}
+
+
+
+
+
+##GL_FRAGMENT_SHADER
+
+#version 330
+
+
+void main() {
+}
+
+
@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) 2017 Darius Rückert 
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+//Deferred shader for the compressed vertex formats VertexNQ and VertexNTQ with a uniform color.
+//Use it with MVPQuantizedShader.
+
+##GL_VERTEX_SHADER
+
+#version 330
+layout(location=0) in vec4 in_position;
+layout(location=1) in vec2 in_normal;
+
+#include "camera.glsl"
+#include "vertex_quantization.glsl"
+uniform mat4 model;
+
+out vec3 normal;
+
+void main() {
+    //the model matrix has no dequantization scale, so the normal is not skewed
+    normal = normalize(vec3(view*model * vec4( decodeOctahedral(in_normal), 0 )));
+    gl_Position = viewProj *model* vec4(dequantizePosition(in_position.xyz),1);
+}
+
+
+
+
+
+##GL_FRAGMENT_SHADER
+
+#version 330
+
+uniform vec4 color;
+uniform float userData; //blue channel of data texture in gbuffer. Not used in lighting.
+
+in vec3 normal;
+
+#include "geometry_helper_fs.glsl"
+
+
+void main() {
+    setGbufferData(color.rgb,normal,vec4(0,0,userData,0));
+}
+
+
@@ -0,0 +1,28 @@
+/**
+ * Copyright (c) 2017 Darius Rückert 
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+//Decoding of the compressed vertex formats VertexNQ and VertexNTQ.
+//The texture coordinates of VertexNTQ need no decoding, they are converted from half floats by OpenGL.
+
+//VertexQuantizer::dequantizationScale and dequantizationOffset
+uniform vec3 dequantizationScale;
+uniform vec3 dequantizationOffset;
+
+//The position is a unorm in [0,1] relative to the bounding box of the mesh.
+vec3 dequantizePosition(vec3 p) {
+    return p * dequantizationScale + dequantizationOffset;
+}
+
+vec2 signNotZero(vec2 v) {
+    return vec2((v.x >= 0.0) ? 1.0 : -1.0, (v.y >= 0.0) ? 1.0 : -1.0);
+}
+
+//Octahedral normal encoding: http://jcgt.org/published/0003/02/01/
+vec3 decodeOctahedral(vec2 e) {
+    vec3 v = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    if (v.z < 0) v.xy = (1.0 - abs(v.yx)) * signNotZero(v.xy);
+    return normalize(v);
+}
@@ -0,0 +1,219 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/animation/compressedAnimation.h"
+#include "saiga/animation/animation.h"
+#include "saiga/util/assert.h"
+
+#include <algorithm>
+
+namespace Saiga {
+
+static vec4 quatToVec(const quat& q){
+    return vec4(q.x,q.y,q.z,q.w);
+}
+
+static quat vecToQuat(const vec4& v){
+    return quat(v.w,v.x,v.y,v.z);
+}
+
+//interpolation of two keys of a track, same as AnimationNode
+static vec4 interpolate(const vec4& a, const vec4& b, float alpha, bool rotation){
+    if(rotation){
+        return quatToVec(glm::normalize(glm::slerp(vecToQuat(a),vecToQuat(b),alpha)));
+    }
+    return glm::mix(a,b,alpha);
+}
+
+//q and -q are the same rotation
+static float difference(const vec4& a, const vec4& b, bool rotation){
+    vec4 d = glm::abs(a - b);
+    float m = glm::max(glm::max(d.x,d.y),glm::max(d.z,d.w));
+    if(rotation){
+        vec4 d2 = glm::abs(a + b);
+        m = glm::min(m,glm::max(glm::max(d2.x,d2.y),glm::max(d2.z,d2.w)));
+    }
+    return m;
+}
+
+void CompressedAnimation::create(const Animation &animation, const AnimationCompressionSettings &settings)
+{
+    skeleton.create(animation);
+    duration = animation.duration;
+    quantized = settings.quantize;
+
+    int frameCount = animation.keyFrames.size();
+    std::vector<float> frameTimes(frameCount);
+    for(int f = 0 ; f < frameCount ; ++f){
+        frameTimes[f] = animationtime_t(animation.keyFrames[f].time).count();
+    }
+
+    tracks.clear();
+    tracks.resize(skeleton.animatedCount * 3);
+    keyTimes.clear();
+    values.clear();
+    quantizedValues.clear();
+
+    std::vector<vec4> original(frameCount), reconstructed(frameCount);
+    std::vector<QuantizedValue> q(frameCount);
+
+    for(int i = 0 ; i < skeleton.nodeCount ; ++i){
+        int trackIndex = skeleton.trackIndices[i];
+        if(trackIndex == -1)
+            continue;
+
+        for(int c = 0 ; c < 3 ; ++c){
+            bool rotation = c == Rotation;
+            float tolerance = c == Position ? settings.positionTolerance : (rotation ? settings.rotationTolerance : settings.scaleTolerance);
+
+            for(int f = 0 ; f < frameCount ; ++f){
+                const AnimationNode& node = animation.keyFrames[f].nodes[skeleton.sourceNodes[i]];
+                original[f] = c == Position ? node.position : (rotation ? quatToVec(node.rotation) : node.scaling);
+            }
+
+            Track& track = tracks[trackIndex * 3 + c];
+            track.firstKey = keyTimes.size();
+
+            //quantization relative to the range of the track
+            if(quantized){
+                if(rotation){
+                    track.offset = vec4(0);
+                    track.scale = vec4(1.0f / 32767);
+                }else{
+                    vec4 minV = original[0], maxV = original[0];
+                    for(const vec4& v : original){
+                        minV = glm::min(minV,v);
+                        maxV = glm::max(maxV,v);
+                    }
+                    track.offset = (minV + maxV) * 0.5f;
+                    track.scale = (maxV - minV) / 65534.0f;
+                }
+                for(int f = 0 ; f < frameCount ; ++f){
+                    for(int k = 0 ; k < 4 ; ++k){
+                        float s = track.scale[k];
+                        float v = s == 0 ? 0 : (original[f][k] - track.offset[k]) / s;
+                        q[f].v[k] = int16_t(glm::clamp(glm::round(v),-32767.0f,32767.0f));
+                        reconstructed[f][k] = track.offset[k] + s * q[f].v[k];
+                    }
+                    if(rotation){
+                        reconstructed[f] = quatToVec(glm::normalize(vecToQuat(reconstructed[f])));
+                    }
+                }
+            }else{
+                reconstructed = original;
+            }
+
+            //greedy key reduction: extend the segment from the last key as long as
+            //all skipped keys are reproduced by the interpolation within the tolerance
+            int last = 0;
+            std::vector<int> keys(1,0);
+            for(int f = 2 ; f < frameCount ; ++f){
+                bool ok = true;
+                for(int m = last + 1 ; m < f && ok ; ++m){
+                    float alpha = (frameTimes[m] - frameTimes[last]) / (frameTimes[f] - frameTimes[last]);
+                    vec4 v = interpolate(reconstructed[last],reconstructed[f],alpha,rotation);
+                    ok = difference(v,original[m],rotation) <= tolerance;
+                }
+                if(!ok){
+                    last = f - 1;
+                    keys.push_back(last);
+                }
+            }
+            if(frameCount > 1){
+                keys.push_back(frameCount - 1);
+            }
+            //constant track
+            if(keys.size() == 2){
+                bool constant = true;
+                for(int f = 0 ; f < frameCount && constant ; ++f)
+                    constant = difference(reconstructed[0],original[f],rotation) <= tolerance;
+                if(constant)
+                    keys.resize(1);
+            }
+
+            for(int f : keys){
+                keyTimes.push_back(frameTimes[f]);
+                if(quantized)
+                    quantizedValues.push_back(q[f]);
+                else
+                    values.push_back(reconstructed[f]);
+            }
+            track.keyCount = keys.size();
+        }
+    }
+}
+
+void CompressedAnimation::initCursor(AnimationCursor &cursor) const
+{
+    cursor.keys.assign(tracks.size(),0);
+    cursor.lastTime = 0;
+}
+
+vec4 CompressedAnimation::getValue(const CompressedAnimation::Track &track, int key) const
+{
+    if(!quantized)
+        return values[track.firstKey + key];
+    const QuantizedValue& q = quantizedValues[track.firstKey + key];
+    return track.offset + track.scale * vec4(q.v[0],q.v[1],q.v[2],q.v[3]);
+}
+
+void CompressedAnimation::sample(animationtime_t time, AnimationCursor &cursor, SkeletonPose &pose) const
+{
+    if(cursor.keys.size() != tracks.size())
+        initCursor(cursor);
+    pose.resize(skeleton.animatedCount);
+
+    double t = std::max(std::min(time,duration),animationtime_t(0)).count();
+    //the cursor only moves forward, a jump back (for example a loop) restarts at the first key
+    if(t < cursor.lastTime){
+        std::fill(cursor.keys.begin(),cursor.keys.end(),0);
+    }
+    cursor.lastTime = t;
+
+    for(int i = 0 ; i < (int)tracks.size() ; ++i){
+        const Track& track = tracks[i];
+        const float* times = keyTimes.data() + track.firstKey;
+        int& k = cursor.keys[i];
+        while(k + 1 < track.keyCount && times[k + 1] <= t){
+            k++;
+        }
+
+        bool rotation = i % 3 == Rotation;
+        vec4 v = getValue(track,k);
+        if(k + 1 < track.keyCount && t > times[k]){
+            float alpha = float((t - times[k]) / (times[k + 1] - times[k]));
+            v = interpolate(v,getValue(track,k + 1),alpha,rotation);
+        }else if(rotation && quantized){
+            v = quatToVec(glm::normalize(vecToQuat(v)));
+        }
+
+        int node = i / 3;
+        switch(i % 3){
+        case Position:
+            pose.positions[node] = v;
+            break;
+        case Rotation:
+            pose.rotations[node] = vecToQuat(v);
+            break;
+        default:
+            pose.scalings[node] = v;
+        }
+    }
+}
+
+void CompressedAnimation::evaluate(animationtime_t time, AnimationCursor &cursor, SkeletonPose &pose, mat4 *out, std::vector<mat4> &worldMatrices) const
+{
+    sample(time,cursor,pose);
+    skeleton.evaluate(pose,out,worldMatrices);
+}
+
+size_t CompressedAnimation::memoryUsage() const
+{
+    return tracks.size() * sizeof(Track) + keyTimes.size() * sizeof(float)
+            + values.size() * sizeof(vec4) + quantizedValues.size() * sizeof(QuantizedValue);
+}
+
+}
@@ -0,0 +1,235 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/animation/cpuSkinning.h"
+#include "saiga/util/taskScheduler.h"
+#include "saiga/util/assert.h"
+#include "saiga/util/simd.h"
+
+#include <cmath>
+
+namespace Saiga {
+
+void VertexStreams::resize(int n)
+{
+    px.resize(n); py.resize(n); pz.resize(n);
+    nx.resize(n); ny.resize(n); nz.resize(n);
+}
+
+void BonePalette::set(const std::vector<mat4> &boneMatrices)
+{
+    rows.resize(boneMatrices.size() * 12);
+    float* r = rows.data();
+    for(const mat4& m : boneMatrices){
+        //glm is column major
+        for(int row = 0 ; row < 3 ; ++row){
+            for(int col = 0 ; col < 4 ; ++col){
+                *r++ = m[col][row];
+            }
+        }
+    }
+}
+
+static inline void skinVertex(const SkinnedMesh& mesh, const float* palette, VertexStreams& out, int i){
+    float m[12];
+    for(int e = 0 ; e < 12 ; ++e)
+        m[e] = 0;
+    for(int k = 0 ; k < MAX_BONES_PER_VERTEX ; ++k){
+        const float* r = palette + mesh.boneIndices[k][i] * 12;
+        float w = mesh.boneWeights[k][i];
+        for(int e = 0 ; e < 12 ; ++e)
+            m[e] += w * r[e];
+    }
+
+    const VertexStreams& in = mesh.bindPose;
+    float px = in.px[i], py = in.py[i], pz = in.pz[i];
+    out.px[i] = m[0] * px + m[1] * py + m[2] * pz + m[3];
+    out.py[i] = m[4] * px + m[5] * py + m[6] * pz + m[7];
+    out.pz[i] = m[8] * px + m[9] * py + m[10] * pz + m[11];
+
+    float nx = in.nx[i], ny = in.ny[i], nz = in.nz[i];
+    float tx = m[0] * nx + m[1] * ny + m[2] * nz;
+    float ty = m[4] * nx + m[5] * ny + m[6] * nz;
+    float tz = m[8] * nx + m[9] * ny + m[10] * nz;
+    float length = std::sqrt(tx * tx + ty * ty + tz * tz);
+    out.nx[i] = tx / length;
+    out.ny[i] = ty / length;
+    out.nz[i] = tz / length;
+}
+
+#if defined(SAIGA_HAS_AVX)
+//r[v] holds 8 values of vertex v -> r[e] holds value e of all 8 vertices
+static inline void transpose8(__m256* r){
+    __m256 t0 = _mm256_unpacklo_ps(r[0],r[1]);
+    __m256 t1 = _mm256_unpackhi_ps(r[0],r[1]);
+    __m256 t2 = _mm256_unpacklo_ps(r[2],r[3]);
+    __m256 t3 = _mm256_unpackhi_ps(r[2],r[3]);
+    __m256 t4 = _mm256_unpacklo_ps(r[4],r[5]);
+    __m256 t5 = _mm256_unpackhi_ps(r[4],r[5]);
+    __m256 t6 = _mm256_unpacklo_ps(r[6],r[7]);
+    __m256 t7 = _mm256_unpackhi_ps(r[6],r[7]);
+    __m256 s0 = _mm256_shuffle_ps(t0,t2,_MM_SHUFFLE(1,0,1,0));
+    __m256 s1 = _mm256_shuffle_ps(t0,t2,_MM_SHUFFLE(3,2,3,2));
+    __m256 s2 = _mm256_shuffle_ps(t1,t3,_MM_SHUFFLE(1,0,1,0));
+    __m256 s3 = _mm256_shuffle_ps(t1,t3,_MM_SHUFFLE(3,2,3,2));
+    __m256 s4 = _mm256_shuffle_ps(t4,t6,_MM_SHUFFLE(1,0,1,0));
+    __m256 s5 = _mm256_shuffle_ps(t4,t6,_MM_SHUFFLE(3,2,3,2));
+    __m256 s6 = _mm256_shuffle_ps(t5,t7,_MM_SHUFFLE(1,0,1,0));
+    __m256 s7 = _mm256_shuffle_ps(t5,t7,_MM_SHUFFLE(3,2,3,2));
+    r[0] = _mm256_permute2f128_ps(s0,s4,0x20);
+    r[1] = _mm256_permute2f128_ps(s1,s5,0x20);
+    r[2] = _mm256_permute2f128_ps(s2,s6,0x20);
+    r[3] = _mm256_permute2f128_ps(s3,s7,0x20);
+    r[4] = _mm256_permute2f128_ps(s0,s4,0x31);
+    r[5] = _mm256_permute2f128_ps(s1,s5,0x31);
+    r[6] = _mm256_permute2f128_ps(s2,s6,0x31);
+    r[7] = _mm256_permute2f128_ps(s3,s7,0x31);
+}
+#endif
+
+void skinVertices(const SkinnedMesh &mesh, const BonePalette &palette, VertexStreams &out, int begin, int end)
+{
+    SAIGA_ASSERT(mesh.maxBoneIndex < palette.size());
+    SAIGA_ASSERT(out.size() == mesh.size());
+    SAIGA_ASSERT(begin >= 0 && end <= mesh.size());
+
+    const float* pal = palette.rows.data();
+    const VertexStreams& in = mesh.bindPose;
+    int i = begin;
+
+#if defined(SAIGA_HAS_AVX)
+    //same as the SSE version below with 8 vertices: rows 0 and 1 of a vertex are one 256 bit register
+    for(; i + 8 <= end ; i += 8){
+        __m256 r01[8];
+        __m128 r2[8];
+        for(int v = 0 ; v < 8 ; ++v){
+            __m256 a01 = _mm256_setzero_ps();
+            __m128 a2 = _mm_setzero_ps();
+            for(int k = 0 ; k < MAX_BONES_PER_VERTEX ; ++k){
+                const float* r = pal + mesh.boneIndices[k][i + v] * 12;
+                float w = mesh.boneWeights[k][i + v];
+                a01 = _mm256_add_ps(a01,_mm256_mul_ps(_mm256_set1_ps(w),_mm256_loadu_ps(r)));
+                a2 = _mm_add_ps(a2,_mm_mul_ps(_mm_set1_ps(w),_mm_loadu_ps(r + 8)));
+            }
+            r01[v] = a01;
+            r2[v] = a2;
+        }
+        transpose8(r01);
+        _MM_TRANSPOSE4_PS(r2[0],r2[1],r2[2],r2[3]);
+        _MM_TRANSPOSE4_PS(r2[4],r2[5],r2[6],r2[7]);
+
+        __m256 m[12];
+        for(int e = 0 ; e < 8 ; ++e)
+            m[e] = r01[e];
+        for(int e = 0 ; e < 4 ; ++e)
+            m[8 + e] = _mm256_insertf128_ps(_mm256_castps128_ps256(r2[e]),r2[4 + e],1);
+
+        __m256 px = _mm256_loadu_ps(in.px.data() + i);
+        __m256 py = _mm256_loadu_ps(in.py.data() + i);
+        __m256 pz = _mm256_loadu_ps(in.pz.data() + i);
+        __m256 nx = _mm256_loadu_ps(in.nx.data() + i);
+        __m256 ny = _mm256_loadu_ps(in.ny.data() + i);
+        __m256 nz = _mm256_loadu_ps(in.nz.data() + i);
+
+        __m256 o[3], t[3];
+        for(int r = 0 ; r < 3 ; ++r){
+            const __m256* row = m + r * 4;
+            __m256 rot = _mm256_add_ps(_mm256_mul_ps(row[0],px),_mm256_mul_ps(row[1],py));
+            o[r] = _mm256_add_ps(_mm256_add_ps(rot,_mm256_mul_ps(row[2],pz)),row[3]);
+            __m256 n = _mm256_add_ps(_mm256_mul_ps(row[0],nx),_mm256_mul_ps(row[1],ny));
+            t[r] = _mm256_add_ps(n,_mm256_mul_ps(row[2],nz));
+        }
+        __m256 length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(t[0],t[0]),_mm256_mul_ps(t[1],t[1])),_mm256_mul_ps(t[2],t[2])));
+
+        _mm256_storeu_ps(out.px.data() + i,o[0]);
+        _mm256_storeu_ps(out.py.data() + i,o[1]);
+        _mm256_storeu_ps(out.pz.data() + i,o[2]);
+        _mm256_storeu_ps(out.nx.data() + i,_mm256_div_ps(t[0],length));
+        _mm256_storeu_ps(out.ny.data() + i,_mm256_div_ps(t[1],length));
+        _mm256_storeu_ps(out.nz.data() + i,_mm256_div_ps(t[2],length));
+    }
+#endif
+
+#if defined(SAIGA_HAS_SSE2)
+    //blend the rows of 4 vertices and transpose them, so every register holds one matrix entry of 4 vertices
+    for(; i + 4 <= end ; i += 4){
+        __m128 r0[4], r1[4], r2[4];
+        for(int v = 0 ; v < 4 ; ++v){
+            __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps(), a2 = _mm_setzero_ps();
+            for(int k = 0 ; k < MAX_BONES_PER_VERTEX ; ++k){
+                const float* r = pal + mesh.boneIndices[k][i + v] * 12;
+                __m128 w = _mm_set1_ps(mesh.boneWeights[k][i + v]);
+                a0 = _mm_add_ps(a0,_mm_mul_ps(w,_mm_loadu_ps(r)));
+                a1 = _mm_add_ps(a1,_mm_mul_ps(w,_mm_loadu_ps(r + 4)));
+                a2 = _mm_add_ps(a2,_mm_mul_ps(w,_mm_loadu_ps(r + 8)));
+            }
+            r0[v] = a0;
+            r1[v] = a1;
+            r2[v] = a2;
+        }
+        _MM_TRANSPOSE4_PS(r0[0],r0[1],r0[2],r0[3]);
+        _MM_TRANSPOSE4_PS(r1[0],r1[1],r1[2],r1[3]);
+        _MM_TRANSPOSE4_PS(r2[0],r2[1],r2[2],r2[3]);
+
+        __m128 px = _mm_loadu_ps(in.px.data() + i);
+        __m128 py = _mm_loadu_ps(in.py.data() + i);
+        __m128 pz = _mm_loadu_ps(in.pz.data() + i);
+        __m128 nx = _mm_loadu_ps(in.nx.data() + i);
+        __m128 ny = _mm_loadu_ps(in.ny.data() + i);
+        __m128 nz = _mm_loadu_ps(in.nz.data() + i);
+
+        __m128 o[3], t[3];
+        const __m128* rows[3] = {r0, r1, r2};
+        for(int r = 0 ; r < 3 ; ++r){
+            const __m128* row = rows[r];
+            __m128 rot = _mm_add_ps(_mm_mul_ps(row[0],px),_mm_mul_ps(row[1],py));
+            o[r] = _mm_add_ps(_mm_add_ps(rot,_mm_mul_ps(row[2],pz)),row[3]);
+            __m128 n = _mm_add_ps(_mm_mul_ps(row[0],nx),_mm_mul_ps(row[1],ny));
+            t[r] = _mm_add_ps(n,_mm_mul_ps(row[2],nz));
+        }
+        __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(t[0],t[0]),_mm_mul_ps(t[1],t[1])),_mm_mul_ps(t[2],t[2])));
+
+        _mm_storeu_ps(out.px.data() + i,o[0]);
+        _mm_storeu_ps(out.py.data() + i,o[1]);
+        _mm_storeu_ps(out.pz.data() + i,o[2]);
+        _mm_storeu_ps(out.nx.data() + i,_mm_div_ps(t[0],length));
+        _mm_storeu_ps(out.ny.data() + i,_mm_div_ps(t[1],length));
+        _mm_storeu_ps(out.nz.data() + i,_mm_div_ps(t[2],length));
+    }
+#endif
+
+    for(; i < end ; ++i){
+        skinVertex(mesh,pal,out,i);
+    }
+}
+
+void skinMeshes(const std::vector<SkinningJob> &jobs, bool parallel, int chunkSize)
+{
+    for(const SkinningJob& job : jobs){
+        job.out->resize(job.mesh->size());
+    }
+
+    if(!parallel){
+        for(const SkinningJob& job : jobs){
+            skinVertices(*job.mesh,*job.palette,*job.out,0,job.mesh->size());
+        }
+        return;
+    }
+
+    TaskGroup group(defaultTaskScheduler());
+    for(const SkinningJob& job : jobs){
+        int n = job.mesh->size();
+        for(int start = 0 ; start < n ; start += chunkSize){
+            int stop = std::min(start + chunkSize,n);
+            group.run([job,start,stop](){
+                skinVertices(*job.mesh,*job.palette,*job.out,start,stop);
+            });
+        }
+    }
+    group.wait();
+}
+
+}
@@ -6,51 +6,356 @@
 
 #include "saiga/animation/objLoader2.h"
 #include "saiga/util/fileChecker.h"
+#include "saiga/util/mappedFile.h"
+#include "saiga/util/taskScheduler.h"
 
 #include <fstream>
-#include <sstream>
 #include <algorithm>
+#include <cstring>
+#include <cmath>
 
 namespace Saiga {
 
-std::vector<std::string> split(const std::string &s, char delim);
+//======================================================================
+//Parsing
+
+//the chunks should be large enough that the merging is negligible
+#define OBJ_MIN_CHUNK_SIZE (1024 * 1024)
+
+#define OBJ_CACHE_MAGIC 0x4A424F53
+//version 2: the source time is in nanoseconds
+#define OBJ_CACHE_VERSION 2
+
+namespace {
+
+enum class ObjStatementType{
+    UseMaterial,
+    MaterialLibrary
+};
+
+//usemtl and mtllib are replayed in file order after the parsing
+struct ObjStatement{
+    ObjStatementType type;
+    int face;   //number of triangles of the chunk before this statement
+    std::string name;
+};
+
+struct ObjChunk{
+    const char* begin;
+    const char* end;
+
+    std::vector<vec3> vertices;
+    std::vector<vec3> normals;
+    std::vector<vec2> texCoords;
+    std::vector<IndexedVertex2> faces;
+    std::vector<ObjStatement> statements;
+
+    //Negative indices are relative to the last vertex, which is not known before all previous chunks are parsed.
+    //They are stored relative to the start of this chunk and the positions (faces.size() * 3 + component) are stored here.
+    std::vector<int> relativeIndices;
+
+    //global offsets, computed after the parsing
+    int vertexOffset = 0, normalOffset = 0, texCoordOffset = 0, faceOffset = 0;
+};
+
+inline bool isSpace(char c){
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char* skipSpaces(const char* p, const char* end){
+    while(p < end && isSpace(*p))
+        ++p;
+    return p;
+}
+
+inline const char* skipLine(const char* p, const char* end){
+    const char* n = static_cast<const char*>(memchr(p,'\n',end - p));
+    return n ? n + 1 : end;
+}
+
+//powers of 10 that are exact in double precision
+static const double exactPowers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+//Parses a decimal number with optional fraction and exponent.
+//Non numbers like 'nan' or 'inf' are passed to strtod.
+const char* parseFloat(const char* p, const char* end, float& out){
+    p = skipSpaces(p,end);
+    const char* start = p;
+    bool negative = false;
+    if(p < end && (*p == '-' || *p == '+')){
+        negative = *p == '-';
+        ++p;
+    }
+
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    int digits = 0;
+    bool any = false;
+    for(; p < end && *p >= '0' && *p <= '9' ; ++p){
+        any = true;
+        //more digits do not change a float
+        if(digits < 18){
+            mantissa = mantissa * 10 + (*p - '0');
+            if(mantissa) digits++;
+        }else{
+            exponent++;
+        }
+    }
+    if(p < end && *p == '.'){
+        ++p;
+        for(; p < end && *p >= '0' && *p <= '9' ; ++p){
+            any = true;
+            if(digits < 18){
+                mantissa = mantissa * 10 + (*p - '0');
+                if(mantissa) digits++;
+                exponent--;
+            }
+        }
+    }
+
+    if(!any){
+        //fallback for special values
+        const char* tokenEnd = start;
+        while(tokenEnd < end && !isSpace(*tokenEnd) && *tokenEnd != '\n')
+            ++tokenEnd;
+        std::string token(start,tokenEnd);
+        out = token.empty() ? 0 : (float)strtod(token.c_str(),nullptr);
+        return tokenEnd;
+    }
+
+    if(p < end && (*p == 'e' || *p == 'E')){
+        const char* e = p + 1;
+        bool negativeExp = false;
+        if(e < end && (*e == '-' || *e == '+')){
+            negativeExp = *e == '-';
+            ++e;
+        }
+        if(e < end && *e >= '0' && *e <= '9'){
+            int ex = 0;
+            for(; e < end && *e >= '0' && *e <= '9' ; ++e){
+                if(ex < 10000)
+                    ex = ex * 10 + (*e - '0');
+            }
+            exponent += negativeExp ? -ex : ex;
+            p = e;
+        }
+    }
+
+    double value = (double)mantissa;
+    if(exponent >= -22 && exponent <= 22){
+        value = exponent < 0 ? value / exactPowers[-exponent] : value * exactPowers[exponent];
+    }else{
+        value = value * std::pow(10.0,exponent);
+    }
+    out = (float)(negative ? -value : value);
+    return p;
+}
+
+inline const char* parseInt(const char* p, const char* end, int& out, bool& valid){
+    bool negative = false;
+    if(p < end && (*p == '-' || *p == '+')){
+        negative = *p == '-';
+        ++p;
+    }
+    int value = 0;
+    valid = false;
+    for(; p < end && *p >= '0' && *p <= '9' ; ++p){
+        value = value * 10 + (*p - '0');
+        valid = true;
+    }
+    out = negative ? -value : value;
+    return p;
+}
+
+//the rest of the line without leading and trailing white spaces
+std::string parseName(const char* p, const char* end){
+    p = skipSpaces(p,end);
+    const char* e = p;
+    while(e < end && *e != '\n')
+        ++e;
+    while(e > p && isSpace(e[-1]))
+        --e;
+    return std::string(p,e);
+}
+
+//Converts a 1 based obj index to a 0 based index.
+//Relative indices are converted relative to the start of the chunk and marked in 'relative'.
+inline int resolveIndex(int index, int localCount, int component, int& relative){
+    if(index > 0)
+        return index - 1;
+    relative |= 1 << component;
+    return localCount + index;
+}
+
+//parsing index vertex
+//examples:
+//v1/vt1/vn1        12/51/1
+//v1//vn1           51//4
+const char* parseIV(const char* p, const char* end, IndexedVertex2& iv, int& relative, ObjChunk& chunk){
+    int value;
+    bool valid;
+    relative = 0;
+    p = parseInt(p,end,value,valid);
+    if(valid && value != 0)
+        iv.v = resolveIndex(value,chunk.vertices.size(),0,relative);
+    if(p < end && *p == '/'){
+        ++p;
+        p = parseInt(p,end,value,valid);
+        if(valid && value != 0)
+            iv.t = resolveIndex(value,chunk.texCoords.size(),1,relative);
+        if(p < end && *p == '/'){
+            ++p;
+            p = parseInt(p,end,value,valid);
+            if(valid && value != 0)
+                iv.n = resolveIndex(value,chunk.normals.size(),2,relative);
+        }
+    }
+    //skip unknown characters of this corner
+    while(p < end && !isSpace(*p) && *p != '\n')
+        ++p;
+    return p;
+}
+
+inline void addCorner(ObjChunk& chunk, const IndexedVertex2& iv, int relative){
+    int position = chunk.faces.size() * 3;
+    for(int c = 0 ; c < 3 ; ++c){
+        if(relative & (1 << c))
+            chunk.relativeIndices.push_back(position + c);
+    }
+    chunk.faces.push_back(iv);
+}
+
+//Polygons are triangulated as a fan around the first vertex.
+const char* parseF(const char* p, const char* end, ObjChunk& chunk){
+    size_t facesBefore = chunk.faces.size();
+    size_t relativeBefore = chunk.relativeIndices.size();
+    IndexedVertex2 first, last;
+    int firstRelative = 0, lastRelative = 0;
+    int corner = 0;
+    while(true){
+        p = skipSpaces(p,end);
+        if(p >= end || *p == '\n' || *p == '#')
+            break;
+        IndexedVertex2 iv;
+        int relative;
+        p = parseIV(p,end,iv,relative,chunk);
+        if(corner < 3){
+            addCorner(chunk,iv,relative);
+        }else{
+            //same winding as before: last, current, first
+            addCorner(chunk,last,lastRelative);
+            addCorner(chunk,iv,relative);
+            addCorner(chunk,first,firstRelative);
+        }
+        if(corner == 0){
+            first = iv;
+            firstRelative = relative;
+        }
+        last = iv;
+        lastRelative = relative;
+        corner++;
+    }
+    if(corner < 3){
+        //degenerated face
+        chunk.faces.resize(facesBefore);
+        chunk.relativeIndices.resize(relativeBefore);
+    }
+    return p;
+}
+
+void parseChunk(ObjChunk& chunk){
+    const char* p = chunk.begin;
+    const char* end = chunk.end;
+    while(p < end){
+        p = skipSpaces(p,end);
+        if(p >= end)
+            break;
+        const char* lineStart = p;
+        size_t remaining = end - p;
+        if(p[0] == 'v' && remaining > 1){
+            if(isSpace(p[1])){
+                vec3 v;
+                p = parseFloat(p + 1,end,v.x);
+                p = parseFloat(p,end,v.y);
+                p = parseFloat(p,end,v.z);
+                chunk.vertices.push_back(v);
+            }else if(p[1] == 't' && remaining > 2 && isSpace(p[2])){
+                vec2 v;
+                p = parseFloat(p + 2,end,v.x);
+                p = parseFloat(p,end,v.y);
+                chunk.texCoords.push_back(v);
+            }else if(p[1] == 'n' && remaining > 2 && isSpace(p[2])){
+                vec3 v;
+                p = parseFloat(p + 2,end,v.x);
+                p = parseFloat(p,end,v.y);
+                p = parseFloat(p,end,v.z);
+                chunk.normals.push_back(glm::normalize(v));
+            }
+        }else if(p[0] == 'f' && remaining > 1 && isSpace(p[1])){
+            p = parseF(p + 1,end,chunk);
+        }else if(remaining > 6 && (memcmp(p,"usemtl",6) == 0 || memcmp(p,"mtllib",6) == 0) && isSpace(p[6])){
+            ObjStatement s;
+            s.type = p[0] == 'u' ? ObjStatementType::UseMaterial : ObjStatementType::MaterialLibrary;
+            s.face = chunk.faces.size() / 3;
+            s.name = parseName(p + 6,end);
+            chunk.statements.push_back(s);
+        }
+        //comments, groups, objects, smoothing groups and the rest of the line are ignored
+        p = skipLine(std::max(p,lineStart),end);
+    }
+}
 
+template<typename T>
+void appendParallel(std::vector<T>& dst, const std::vector<ObjChunk>& chunks, std::vector<T> ObjChunk::* member, int ObjChunk::* offset){
+    size_t total = 0;
+    for(const ObjChunk& c : chunks)
+        total += (c.*member).size();
+    dst.resize(total);
+    parallelFor(defaultTaskScheduler(),0,chunks.size(),1,[&](int i){
+        const std::vector<T>& src = chunks[i].*member;
+        if(!src.empty())
+            memcpy(&dst[chunks[i].*offset],src.data(),src.size() * sizeof(T));
+    });
+}
+
+}
 
 //======================================================================
 
-ObjLoader2::ObjLoader2(const std::string &file):file(file)
+ObjLoader2::ObjLoader2(const std::string &file, bool useBinaryCache):file(file),useBinaryCache(useBinaryCache)
 {
     loadFile(file);
 }
 
+void ObjLoader2::clear()
+{
+    vertices.clear();
+    normals.clear();
+    texCoords.clear();
+    faces.clear();
+    materialFiles.clear();
+    outVertices.clear();
+    outTriangles.clear();
+    triangleGroups.clear();
+}
+
 bool ObjLoader2::loadFile(const std::string &_file){
 	this->file = _file;
-    std::ifstream stream(file, std::ios::in);
-    if(!stream.is_open()) {
-        return false;
-    }
+    clear();
 
+    if(useBinaryCache && loadCache()){
+        if(verbose)
+            cout << "objloader: loaded cache " << cacheFile() << endl;
+        return true;
+    }
 
     cout<<"objloader: loading file "<<file<<endl;
 
-    ObjTriangleGroup tg;
-    tg.startFace = 0;
-    tg.faces = 0;
-    triangleGroups.push_back(tg);
-
-    while(!stream.eof()) {
-        std::string line;
-        std::getline(stream, line);
-        //remove carriage return from windows
-        line.erase( std::remove(line.begin(), line.end(), '\r'), line.end() );
-        parseLine(line);
-    }
-
-    //finish last group
-    ObjTriangleGroup &lastGroup = triangleGroups[triangleGroups.size()-1];
-    lastGroup.faces = faces.size() - lastGroup.startFace;
+    if(!parseFile())
+        return false;
 
-    cout << ".obj parsing finished. " << "V " << vertices.size() << " N " << normals.size() << " T " << texCoords.size() << " F " << faces.size() << endl;
+    cout << ".obj parsing finished. " << "V " << vertices.size() << " N " << normals.size() << " T " << texCoords.size() << " F " << faces.size() / 3 << endl;
 
 
 
@@ -62,10 +367,115 @@ bool ObjLoader2::loadFile(const std::string &_file){
 
     calculateMissingNormals();
 
+    //the temporary data is not needed anymore
+    std::vector<vec3>().swap(vertices);
+    std::vector<vec3>().swap(normals);
+    std::vector<vec2>().swap(texCoords);
+    std::vector<IndexedVertex2>().swap(faces);
+
+    if(useBinaryCache)
+        saveCache();
+
 //    cout<<"objloader finished :)"<<endl;
     return true;
 }
 
+bool ObjLoader2::parseFile()
+{
+    MappedFile mapped;
+    if(!mapped.open(file)) {
+        return false;
+    }
+
+    const char* data = mapped.data();
+    const char* end = data + mapped.size();
+
+    //split at line boundaries
+    TaskScheduler& scheduler = defaultTaskScheduler();
+    size_t numChunks = std::max<size_t>(1,std::min<size_t>(mapped.size() / OBJ_MIN_CHUNK_SIZE, scheduler.numThreads() * 4));
+    size_t chunkSize = mapped.size() / numChunks + 1;
+    std::vector<ObjChunk> chunks;
+    const char* p = data;
+    while(p < end){
+        ObjChunk c;
+        c.begin = p;
+        c.end = p + std::min<size_t>(chunkSize,end - p);
+        c.end = c.end < end ? skipLine(c.end - 1,end) : end;
+        chunks.push_back(std::move(c));
+        p = chunks.back().end;
+    }
+
+    parallelFor(scheduler,0,chunks.size(),1,[&](int i){
+        parseChunk(chunks[i]);
+    });
+
+    //offsets of the chunks
+    int v = 0, n = 0, t = 0, f = 0;
+    for(ObjChunk& c : chunks){
+        c.vertexOffset = v;
+        c.normalOffset = n;
+        c.texCoordOffset = t;
+        c.faceOffset = f;
+        v += c.vertices.size();
+        n += c.normals.size();
+        t += c.texCoords.size();
+        f += c.faces.size();
+    }
+
+    //the indices are already absolute, except the relative ones
+    parallelFor(scheduler,0,chunks.size(),1,[&](int i){
+        ObjChunk& c = chunks[i];
+        for(int position : c.relativeIndices){
+            IndexedVertex2& iv = c.faces[position / 3];
+            switch(position % 3){
+            case 0: iv.v += c.vertexOffset; break;
+            case 1: iv.t += c.texCoordOffset; break;
+            case 2: iv.n += c.normalOffset; break;
+            }
+        }
+    });
+
+    appendParallel(vertices,chunks,&ObjChunk::vertices,&ObjChunk::vertexOffset);
+    appendParallel(normals,chunks,&ObjChunk::normals,&ObjChunk::normalOffset);
+    appendParallel(texCoords,chunks,&ObjChunk::texCoords,&ObjChunk::texCoordOffset);
+    appendParallel(faces,chunks,&ObjChunk::faces,&ObjChunk::faceOffset);
+
+    //create the triangle groups
+    ObjTriangleGroup tg;
+    tg.startFace = 0;
+    tg.faces = 0;
+    triangleGroups.push_back(tg);
+
+    for(ObjChunk& c : chunks){
+        for(ObjStatement& s : c.statements){
+            if(s.type == ObjStatementType::MaterialLibrary){
+                loadMaterialFile(s.name);
+                continue;
+            }
+            //finish current group and create new one
+            int face = c.faceOffset / 3 + s.face;
+            ObjTriangleGroup &currentGroup = triangleGroups.back();
+            currentGroup.faces = face - currentGroup.startFace;
+            ObjTriangleGroup newGroup;
+            newGroup.startFace = face;
+            newGroup.material = materialLoader.getMaterial(s.name);
+            triangleGroups.push_back(newGroup);
+        }
+    }
+
+    //finish last group
+    ObjTriangleGroup &lastGroup = triangleGroups.back();
+    lastGroup.faces = faces.size() / 3 - lastGroup.startFace;
+    return true;
+}
+
+void ObjLoader2::loadMaterialFile(const std::string &name)
+{
+    materialFiles.push_back(name);
+    FileChecker fc;
+    materialLoader.loadFile(fc.getRelative(file,name));
+}
+
 void ObjLoader2::separateVerticesByGroup()
 {
     //make sure faces from different triangle groups do not reference the same vertex
@@ -109,11 +519,12 @@ void ObjLoader2::createVertexIndexList()
 
 
     outVertices.resize(vertices.size());
+    outTriangles.resize(faces.size() / 3);
 
-    for(std::vector<IndexedVertex2> &f : faces){
-        ObjTriangle fa;
+    for(size_t f = 0 ; f < outTriangles.size() ; ++f){
+        ObjTriangle& fa = outTriangles[f];
         for(int i=0;i<3;i++){
-            IndexedVertex2 &currentVertex = f[i];
+            IndexedVertex2 &currentVertex = faces[f * 3 + i];
             int vert = currentVertex.v;
             int norm = currentVertex.n;
             int tex = currentVertex.t;
@@ -150,176 +561,116 @@ void ObjLoader2::createVertexIndexList()
             }
             fa.v[i] = index;
         }
-
-        outTriangles.push_back(fa);
     }
 }
 
-std::vector<std::vector<IndexedVertex2> > ObjLoader2::triangulateFace(const std::vector<IndexedVertex2> &f)
-{
-    std::vector<std::vector<IndexedVertex2>> newFaces;
-
-    //more than 3 indices -> triangulate
-    std::vector<IndexedVertex2> face;
-    int cornerCount = 1;
-    IndexedVertex2 startVertex, lastVertex;
-    for(const IndexedVertex2 &currentVertex : f){
-        if(cornerCount<=3){
-            if(cornerCount==1)
-                startVertex = currentVertex;
-            face.push_back(currentVertex);
-            if(cornerCount==3)
-                newFaces.push_back(face);
-        }else{
-            face.resize(3);
-            face[0] = lastVertex;
-            face[1] = currentVertex;
-            face[2] = startVertex;
-            newFaces.push_back(face);
-        }
-
-        lastVertex = currentVertex;
-        cornerCount++;
-    }
-    return newFaces;
-}
-
-void ObjLoader2::parseLine(const std::string &line)
-{
-    std::stringstream sstream(line);
-
-    std::string header;
-    sstream >> header;
-
-    std::string rest;
-    std::getline(sstream,rest);
-
-    //remove first white space
-    if(rest[0]==' ' && rest.size()>1){
-        rest = rest.substr(1);
-    }
-
-
-    if(header == "#"){
-    }else if(header == "usemtl"){
-        parseUM(rest);
-    }else if(header == "mtllib"){
-        parseM(rest);
-    }else if(header == "g"){
-        //        cout<<"Found Group: "<<line<<endl;
-    }else if(header == "o"){
-        //        cout<<"Found Object: "<<line<<endl;
-    }else if(header == "s"){
-        //smooth shading
-    }else if(header == "v"){
-        parseV(rest);
-    }else if(header == "vt"){
-        parseVT(rest);
-    }else if(header == "vn"){
-        parseVN(rest);
-    }else if(header == "f"){
-        parseF(rest);
-    }
-}
-
-void ObjLoader2::parseV(const std::string &line)
-{
-    std::stringstream sstream(line);
-    vec3 v;
-    sstream >> v;
-    vertices.push_back(v);
-}
-
-void ObjLoader2::parseVT(const std::string &line)
-{
-    std::stringstream sstream(line);
-    vec2 v;
-    sstream >> v;
-    texCoords.push_back(v);
+//======================================================================
+//Binary cache
+
+struct ObjCacheHeader{
+    uint32_t magic;
+    uint32_t version;
+    //the cache is only valid for the source file with this size and modification time (MappedFile::fileStats)
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    uint32_t vertices;
+    uint32_t triangles;
+    uint32_t groups;
+    uint32_t materialFiles;
+};
+
+static void writeString(std::ofstream& stream, const std::string& s){
+    uint32_t size = s.size();
+    stream.write(reinterpret_cast<const char*>(&size),sizeof(size));
+    stream.write(s.data(),size);
 }
 
-void ObjLoader2::parseVN(const std::string &line)
-{
-    std::stringstream sstream(line);
-    vec3 v;
-    sstream >> v;
-    normals.push_back(glm::normalize(v));
+static bool readString(std::ifstream& stream, std::string& s){
+    uint32_t size = 0;
+    if(!stream.read(reinterpret_cast<char*>(&size),sizeof(size)))
+        return false;
+    s.resize(size);
+    return size == 0 || (bool)stream.read(&s[0],size);
 }
 
-void ObjLoader2::parseF(std::string &line)
+bool ObjLoader2::loadCache()
 {
+    ObjCacheHeader expected;
+    if(!MappedFile::fileStats(file,expected.sourceSize,expected.sourceTime))
+        return false;
 
-    //    std::replace( line.begin(), line.end(), '/', ' ');
-
-    std::stringstream sstream(line);
-    std::string t;
+    std::ifstream stream(cacheFile(), std::ios::in | std::ios::binary);
+    if(!stream.is_open())
+        return false;
 
-    //    cout<<"parse F "<<line<<endl;
+    ObjCacheHeader header;
+    if(!stream.read(reinterpret_cast<char*>(&header),sizeof(header)))
+        return false;
+    if(header.magic != OBJ_CACHE_MAGIC || header.version != OBJ_CACHE_VERSION ||
+            header.sourceSize != expected.sourceSize || header.sourceTime != expected.sourceTime)
+        return false;
 
-    std::vector<IndexedVertex2> ivs;
-    while(sstream >> t){
-        ivs.push_back(parseIV(t));
+    outVertices.resize(header.vertices);
+    outTriangles.resize(header.triangles);
+    stream.read(reinterpret_cast<char*>(outVertices.data()),outVertices.size() * sizeof(VertexNT));
+    stream.read(reinterpret_cast<char*>(outTriangles.data()),outTriangles.size() * sizeof(ObjTriangle));
+
+    //only the names of the materials are stored, the material files are loaded again
+    std::vector<std::string> materialNames(header.groups);
+    triangleGroups.resize(header.groups);
+    for(uint32_t i = 0 ; i < header.groups ; ++i){
+        int32_t range[2];
+        stream.read(reinterpret_cast<char*>(range),sizeof(range));
+        triangleGroups[i].startFace = range[0];
+        triangleGroups[i].faces = range[1];
+        readString(stream,materialNames[i]);
     }
+    std::vector<std::string> files(header.materialFiles);
+    for(std::string& f : files)
+        readString(stream,f);
 
-    auto nf = triangulateFace(ivs);
-
-    //relative indexing, when the index is negativ
-    for(auto &f : nf){
-        for(auto &i : f){
-            if(i.v < 0 && i.v != INVALID_VERTEX_ID){
-                int absIndex = vertices.size() + i.v + 1;
-                i.v = absIndex;
-            }
-            if(i.n < 0 && i.n != INVALID_VERTEX_ID){
-                int absIndex = normals.size() + i.n + 1;
-                i.n = absIndex;
-            }
-            if(i.t < 0 && i.t != INVALID_VERTEX_ID){
-                int absIndex = texCoords.size() + i.t + 1;
-                i.t = absIndex;
-            }
-        }
+    if(!stream){
+        cout << "objloader: invalid cache file " << cacheFile() << endl;
+        clear();
+        return false;
     }
 
-    faces.insert(faces.end(),nf.begin(),nf.end());
-}
-
-//parsing index vertex
-//examples:
-//v1/vt1/vn1        12/51/1
-//v1//vn1           51//4
-IndexedVertex2 ObjLoader2::parseIV(std::string &line)
-{
-    IndexedVertex2 iv;
-    std::vector<std::string> s = split(line, '/');
-    if(s.size()>0 && s[0].size()>0)
-        iv.v = std::atoi(s[0].c_str()) - 1;
-    if(s.size()>1 && s[1].size()>0)
-        iv.t = std::atoi(s[1].c_str()) - 1;
-    if(s.size()>2 && s[2].size()>0)
-        iv.n = std::atoi(s[2].c_str()) - 1;
-    return iv;
-}
-
-void ObjLoader2::parseUM(const std::string &line)
-{
-    //finish current group and create new one
-    if(!triangleGroups.empty()){
-        ObjTriangleGroup &currentGroup = triangleGroups[triangleGroups.size()-1];
-        currentGroup.faces = faces.size() - currentGroup.startFace;
+    for(std::string& f : files)
+        loadMaterialFile(f);
+    for(uint32_t i = 0 ; i < header.groups ; ++i){
+        if(!materialNames[i].empty())
+            triangleGroups[i].material = materialLoader.getMaterial(materialNames[i]);
     }
-    ObjTriangleGroup newGroup;
-    newGroup.startFace = faces.size();
-    newGroup.material = materialLoader.getMaterial(line);
-    triangleGroups.push_back(newGroup);
-
-
+    return true;
 }
 
-void ObjLoader2::parseM(const std::string &line)
+void ObjLoader2::saveCache()
 {
-    FileChecker fc;
-    materialLoader.loadFile(fc.getRelative(file,line));
+    ObjCacheHeader header;
+    if(!MappedFile::fileStats(file,header.sourceSize,header.sourceTime))
+        return;
+    header.magic = OBJ_CACHE_MAGIC;
+    header.version = OBJ_CACHE_VERSION;
+    header.vertices = outVertices.size();
+    header.triangles = outTriangles.size();
+    header.groups = triangleGroups.size();
+    header.materialFiles = materialFiles.size();
+
+    std::ofstream stream(cacheFile(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!stream.is_open()){
+        cout << "objloader: could not write cache file " << cacheFile() << endl;
+        return;
+    }
+    stream.write(reinterpret_cast<const char*>(&header),sizeof(header));
+    stream.write(reinterpret_cast<const char*>(outVertices.data()),outVertices.size() * sizeof(VertexNT));
+    stream.write(reinterpret_cast<const char*>(outTriangles.data()),outTriangles.size() * sizeof(ObjTriangle));
+    for(ObjTriangleGroup& tg : triangleGroups){
+        int32_t range[2] = {tg.startFace, tg.faces};
+        stream.write(reinterpret_cast<const char*>(range),sizeof(range));
+        writeString(stream,tg.material.name);
+    }
+    for(std::string& f : materialFiles)
+        writeString(stream,f);
 }
 
 }
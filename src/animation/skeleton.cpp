@@ -0,0 +1,205 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/animation/skeleton.h"
+#include "saiga/animation/animation.h"
+#include "saiga/util/taskScheduler.h"
+#include "saiga/util/assert.h"
+
+#include <algorithm>
+
+namespace Saiga {
+
+void SkeletonPose::resize(int animatedCount)
+{
+    positions.resize(animatedCount);
+    rotations.resize(animatedCount);
+    scalings.resize(animatedCount);
+}
+
+void Skeleton::create(const Animation &animation)
+{
+    SAIGA_ASSERT(animation.keyFrames.size() > 0);
+    const std::vector<AnimationNode>& nodes = animation.keyFrames[0].nodes;
+
+    parents.clear();
+    boneIndices.clear();
+    trackIndices.clear();
+    sourceNodes.clear();
+    localMatrices.clear();
+    unusedBones.clear();
+    boneCount = animation.boneCount;
+    boneOffsets = animation.boneOffsets;
+    animatedCount = 0;
+
+    //depth first traversal from the root, same as AnimationNode::traverse
+    std::vector<std::pair<int,int>> stack; //node, parent in flat order
+    stack.emplace_back(0,-1);
+    while(!stack.empty()){
+        int node = stack.back().first;
+        int parent = stack.back().second;
+        stack.pop_back();
+
+        const AnimationNode& n = nodes[node];
+        int flatIndex = parents.size();
+        parents.push_back(parent);
+        boneIndices.push_back(n.boneIndex);
+        sourceNodes.push_back(node);
+        trackIndices.push_back(n.keyFramed ? animatedCount++ : -1);
+        localMatrices.push_back(n.matrix);
+
+        for(auto it = n.children.rbegin() ; it != n.children.rend() ; ++it){
+            stack.emplace_back(*it,flatIndex);
+        }
+    }
+    nodeCount = parents.size();
+
+    std::vector<bool> used(boneCount,false);
+    for(int b : boneIndices){
+        if(b != -1)
+            used[b] = true;
+    }
+    for(int b = 0 ; b < boneCount ; ++b){
+        if(!used[b])
+            unusedBones.push_back(b);
+    }
+}
+
+void Skeleton::evaluate(const SkeletonPose &pose, mat4 *out, std::vector<mat4> &worldMatrices) const
+{
+    worldMatrices.resize(nodeCount);
+    mat4* world = worldMatrices.data();
+    for(int i = 0 ; i < nodeCount ; ++i){
+        int track = trackIndices[i];
+        mat4 local = track == -1 ? localMatrices[i] : createTRSmatrix(pose.positions[track],pose.rotations[track],pose.scalings[track]);
+
+        int parent = parents[i];
+        world[i] = parent == -1 ? local : world[parent] * local;
+
+        int bone = boneIndices[i];
+        if(bone != -1){
+            out[bone] = world[i] * boneOffsets[bone];
+        }
+    }
+    for(int bone : unusedBones){
+        out[bone] = mat4() * boneOffsets[bone];
+    }
+}
+
+void SkeletonAnimation::create(const Animation &animation)
+{
+    skeleton.create(animation);
+    duration = animation.duration;
+    frameCount = animation.keyFrames.size();
+
+    int n = skeleton.animatedCount;
+    times.resize(frameCount);
+    positions.resize(frameCount * n);
+    rotations.resize(frameCount * n);
+    scalings.resize(frameCount * n);
+
+    for(int f = 0 ; f < frameCount ; ++f){
+        const AnimationFrame& frame = animation.keyFrames[f];
+        times[f] = frame.time;
+        for(int i = 0 ; i < skeleton.nodeCount ; ++i){
+            int track = skeleton.trackIndices[i];
+            if(track == -1)
+                continue;
+            const AnimationNode& node = frame.nodes[skeleton.sourceNodes[i]];
+            positions[f * n + track] = node.position;
+            rotations[f * n + track] = node.rotation;
+            scalings[f * n + track] = node.scaling;
+        }
+    }
+}
+
+void SkeletonAnimation::evaluate(animationtime_t time, mat4 *out, std::vector<mat4> &worldMatrices) const
+{
+    const Skeleton& s = skeleton;
+    int n = s.animatedCount;
+
+    //same keyframe selection as Animation::getFrame
+    time = std::max(std::min(time,duration),animationtime_t(0));
+    int frame = 0;
+    while(frame < frameCount - 1 && times[frame] < time){
+        frame++;
+    }
+    int prevFrame = std::max(0,frame - 1);
+
+    float alpha = 0;
+    if(frame != prevFrame){
+        alpha = ((time - times[prevFrame]).count() / (times[frame] - times[prevFrame]).count());
+    }
+    //AnimationFrame copies the keyframe for alpha 0 and 1
+    if(alpha == 1){
+        prevFrame = frame;
+        alpha = 0;
+    }
+    const vec4* p0 = positions.data() + prevFrame * n;
+    const quat* r0 = rotations.data() + prevFrame * n;
+    const vec4* s0 = scalings.data() + prevFrame * n;
+    const vec4* p1 = positions.data() + frame * n;
+    const quat* r1 = rotations.data() + frame * n;
+    const vec4* s1 = scalings.data() + frame * n;
+
+    worldMatrices.resize(s.nodeCount);
+    mat4* world = worldMatrices.data();
+    for(int i = 0 ; i < s.nodeCount ; ++i){
+        int track = s.trackIndices[i];
+        mat4 local;
+        if(track == -1){
+            local = s.localMatrices[i];
+        }else if(alpha == 0){
+            local = createTRSmatrix(p0[track],r0[track],s0[track]);
+        }else{
+            quat rotation = glm::normalize(glm::slerp(r0[track],r1[track],alpha));
+            vec4 scaling = glm::mix(s0[track],s1[track],alpha);
+            vec4 position = glm::mix(p0[track],p1[track],alpha);
+            local = createTRSmatrix(position,rotation,scaling);
+        }
+
+        int parent = s.parents[i];
+        world[i] = parent == -1 ? local : world[parent] * local;
+
+        int bone = s.boneIndices[i];
+        if(bone != -1){
+            out[bone] = world[i] * s.boneOffsets[bone];
+        }
+    }
+    for(int bone : s.unusedBones){
+        out[bone] = mat4() * s.boneOffsets[bone];
+    }
+}
+
+void evaluateSkeletons(const std::vector<SkeletonEvaluation> &evaluations, bool parallel)
+{
+    int count = evaluations.size();
+    if(!parallel){
+        std::vector<mat4> worldMatrices;
+        for(const SkeletonEvaluation& e : evaluations){
+            e.animation->evaluate(e.time,e.boneMatrices,worldMatrices);
+        }
+        return;
+    }
+
+    //one scratch buffer per task
+    TaskScheduler& scheduler = defaultTaskScheduler();
+    int chunkSize = std::max(1,std::min(64, count / (4 * scheduler.numThreads())));
+    TaskGroup group(scheduler);
+    for(int start = 0 ; start < count ; start += chunkSize){
+        int stop = std::min(start + chunkSize, count);
+        group.run([&evaluations,start,stop](){
+            std::vector<mat4> worldMatrices;
+            for(int i = start ; i < stop ; ++i){
+                const SkeletonEvaluation& e = evaluations[i];
+                e.animation->evaluate(e.time,e.boneMatrices,worldMatrices);
+            }
+        });
+    }
+    group.wait();
+}
+
+}
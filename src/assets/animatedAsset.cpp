@@ -9,6 +9,13 @@
 
 namespace Saiga {
 
+void AnimatedAsset::createSkeletonAnimations()
+{
+    skeletonAnimations.resize(animations.size());
+    for(unsigned int i = 0 ; i < animations.size() ; ++i){
+        skeletonAnimations[i].create(animations[i]);
+    }
+}
 
 void AnimatedAsset::render(Camera *cam, const mat4 &model, UniformBuffer& boneMatrices)
 {
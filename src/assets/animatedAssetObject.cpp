@@ -23,6 +23,8 @@ void AnimatedAssetObject::setAnimation(int id)
 void AnimatedAssetObject::init(std::shared_ptr<AnimatedAsset> _asset)
 {
     SAIGA_ASSERT(_asset);
+    //the loader creates them once for the shared asset
+    SAIGA_ASSERT(_asset->skeletonAnimations.size() == _asset->animations.size());
     this->asset = _asset;
     std::shared_ptr<BoneShader> bs = std::static_pointer_cast<BoneShader>(asset->shader);
 
@@ -40,15 +42,50 @@ void AnimatedAssetObject::updateAnimation(float dt)
 }
 
 void AnimatedAssetObject::interpolateAnimation(float dt, float alpha)
+{
+    updateRenderTime(dt,alpha);
+    SkeletonEvaluation e = getEvaluation();
+    e.animation->evaluate(e.time,e.boneMatrices,worldMatrices);
+    uploadBoneMatrices();
+}
+
+void AnimatedAssetObject::interpolateAnimations(const std::vector<AnimatedAssetObject *> &objects, float dt, float alpha)
+{
+    std::vector<SkeletonEvaluation> evaluations;
+    evaluations.reserve(objects.size());
+    for(AnimatedAssetObject* o : objects){
+        o->updateRenderTime(dt,alpha);
+        evaluations.push_back(o->getEvaluation());
+    }
+    evaluateSkeletons(evaluations);
+    //the uniform buffers have to be updated in the OpenGL thread
+    for(AnimatedAssetObject* o : objects){
+        o->uploadBoneMatrices();
+    }
+}
+
+void AnimatedAssetObject::updateRenderTime(float dt, float alpha)
 {
     animationTimeAtRender = animationTimeAtUpdate + animationtime_t(dt*alpha);
     if(animationTimeAtRender >= animationTotalTime)
         animationTimeAtRender -= animationTotalTime;
-    asset->animations[activeAnimation].getFrame(animationTimeAtRender,currentFrame);
-    boneMatricesBuffer.updateBuffer(
-                currentFrame.getBoneMatrices(asset->animations[activeAnimation]).data(),
-                currentFrame.getBoneMatrices(asset->animations[activeAnimation]).size()*sizeof(mat4),
-                0);
+}
+
+SkeletonEvaluation AnimatedAssetObject::getEvaluation()
+{
+    const SkeletonAnimation& animation = asset->skeletonAnimations[activeAnimation];
+    boneMatrices.resize(animation.skeleton.boneCount);
+
+    SkeletonEvaluation e;
+    e.animation = &animation;
+    e.time = animationTimeAtRender;
+    e.boneMatrices = boneMatrices.data();
+    return e;
+}
+
+void AnimatedAssetObject::uploadBoneMatrices()
+{
+    boneMatricesBuffer.updateBuffer(boneMatrices.data(),boneMatrices.size()*sizeof(mat4),0);
 }
 
 
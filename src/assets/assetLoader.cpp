@@ -31,6 +31,8 @@ void AssetLoader2::loadDefaultShaders()
     basicAssetForwardShader = ShaderLoader::instance()->load<MVPShader>("geometry/deferred_mvp_model_forward.glsl");
     basicAssetDepthshader = ShaderLoader::instance()->load<MVPShader>("geometry/deferred_mvp_model_depth.glsl");
     basicAssetWireframeShader = ShaderLoader::instance()->load<MVPShader>("geometry/deferred_mvp_model_wireframe.glsl");
+    basicAssetInstancedShader = ShaderLoader::instance()->load<MVPShader>("geometry/deferred_mvp_model_instancing.glsl");
+    basicAssetInstancedDepthShader = ShaderLoader::instance()->load<MVPShader>("geometry/deferred_mvp_model_depth_instancing.glsl");
 
     texturedAssetShader = ShaderLoader::instance()->load<MVPTextureShader>("geometry/texturedAsset.glsl");
     texturedAssetDepthShader = ShaderLoader::instance()->load<MVPTextureShader>("geometry/texturedAsset_depth.glsl");
@@ -104,6 +106,8 @@ std::shared_ptr<ColoredAsset> AssetLoader2::loadDebugArrow(float radius, float l
     }
 
     asset->create("Arrow",basicAssetShader,basicAssetForwardShader,basicAssetDepthshader,basicAssetWireframeShader);
+    asset->instancedShader = basicAssetInstancedShader;
+    asset->instancedDepthShader = basicAssetInstancedDepthShader;
     return asset;
 }
 
@@ -119,6 +123,8 @@ std::shared_ptr<ColoredAsset> AssetLoader2::assetFromMesh(std::shared_ptr<Triang
     }
 
     asset->create("Fromsdfg",basicAssetShader,basicAssetForwardShader,basicAssetDepthshader,basicAssetWireframeShader);
+    asset->instancedShader = basicAssetInstancedShader;
+    asset->instancedDepthShader = basicAssetInstancedDepthShader;
     return asset;
 }
 
@@ -137,6 +143,8 @@ std::shared_ptr<ColoredAsset> AssetLoader2::nonTriangleMesh(std::vector<vec3> ve
 //        v.data = vec4(0.5,0,0,0);
 //    }
     asset->create("Fromsdfg",basicAssetShader,basicAssetForwardShader,basicAssetDepthshader,basicAssetWireframeShader);
+    asset->instancedShader = basicAssetInstancedShader;
+    asset->instancedDepthShader = basicAssetInstancedDepthShader;
     asset->buffer.set(asset->mesh.vertices,indices,GL_STATIC_DRAW);
     asset->buffer.setDrawMode(mode);
     return asset;
@@ -51,4 +51,22 @@ void TexturedAsset::renderDepth(Camera *cam, const mat4 &model)
 	 dshader->unbind();
 }
 
+void TexturedAsset::renderDepth(Camera *cam, const mat4 *models, int count)
+{
+    (void)cam;
+    auto dshader = std::static_pointer_cast<MVPTextureShader>(this->depthshader);
+
+    dshader->bind();
+    buffer.bind();
+    for(int i = 0 ; i < count ; ++i){
+        dshader->uploadModel(models[i]);
+        for(TextureGroup& tg : groups){
+            dshader->uploadTexture(tg.texture);
+            buffer.draw(tg.indices, tg.startIndex);
+        }
+    }
+    buffer.unbind();
+    dshader->unbind();
+}
+
 }
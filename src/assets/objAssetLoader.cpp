@@ -9,6 +9,7 @@
 #include "saiga/opengl/shader/shaderLoader.h"
 #include "saiga/opengl/texture/textureLoader.h"
 #include "saiga/animation/objLoader2.h"
+#include "saiga/geometry/triangle_mesh_optimizer.h"
 
 namespace Saiga {
 
@@ -53,9 +54,11 @@ std::shared_ptr<ColoredAsset> ObjAssetLoader::loadBasicAsset(const std::string &
         }
     }
 
-
+    optimizeMesh(tmesh);
 
     asset->create(file,basicAssetShader,basicAssetForwardShader,basicAssetDepthshader,basicAssetWireframeShader,normalize,false);
+    asset->instancedShader = basicAssetInstancedShader;
+    asset->instancedDepthShader = basicAssetInstancedDepthShader;
 
     return  std::shared_ptr<ColoredAsset>(asset);
 }
@@ -102,6 +105,12 @@ std::shared_ptr<TexturedAsset> ObjAssetLoader::loadTexturedAsset(const std::stri
         }
     }
 
+    //the faces of each group stay in their range
+    for(ObjTriangleGroup &tg : ol.triangleGroups){
+        optimizeVertexCache(tmesh,tg.startFace,tg.faces);
+    }
+    optimizeVertexFetch(tmesh);
+
     asset->create(file,texturedAssetShader,texturedAssetForwardShader,texturedAssetDepthShader,texturedAssetWireframeShader,normalize,false);
 
     return std::shared_ptr<TexturedAsset>(asset);
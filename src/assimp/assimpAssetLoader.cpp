@@ -9,6 +9,7 @@
 #include "saiga/assimp/assimpLoader.h"
 #include "saiga/opengl/shader/shaderLoader.h"
 #include "saiga/opengl/texture/textureLoader.h"
+#include "saiga/geometry/triangle_mesh_optimizer.h"
 
 namespace Saiga {
 
@@ -44,10 +45,13 @@ std::shared_ptr<ColoredAsset> AssimpAssetLoader::loadBasicAsset(const std::strin
         al.getNormals(i,tmesh3);
         al.getColors(i,tmesh3);
         al.getData(i,tmesh3);
+        optimizeMesh(tmesh3);
         tmesh.addMesh(tmesh3);
     }
 
     asset->create(file,basicAssetShader,basicAssetForwardShader,basicAssetDepthshader,basicAssetWireframeShader,normalize,false);
+    asset->instancedShader = basicAssetInstancedShader;
+    asset->instancedDepthShader = basicAssetInstancedDepthShader;
 
 
     return std::shared_ptr<ColoredAsset>(asset);
@@ -85,7 +89,7 @@ std::shared_ptr<TexturedAsset> AssimpAssetLoader::loadTexturedAsset(const std::s
         al.getTextureCoordinates(i,tmesh3);
 
         al.getFaces(i,tmesh3);
-
+        optimizeMesh(tmesh3);
 
 
 
@@ -133,6 +137,7 @@ std::shared_ptr<AnimatedAsset> AssimpAssetLoader::loadAnimatedAsset(const std::s
         al.getColors(i,tmesh3);
         al.getBones(i,tmesh3);
         al.getData(i,tmesh3);
+        optimizeMesh(tmesh3);
         tmesh.addMesh(tmesh3);
     }
 
@@ -156,6 +161,7 @@ std::shared_ptr<AnimatedAsset> AssimpAssetLoader::loadAnimatedAsset(const std::s
     for(int i=0;i<animationCount;++i){
         al.getAnimation(i,0,asset->animations[i]);
     }
+    asset->createSkeletonAnimations();
 
 //    for(BoneVertexCD &v : asset->mesh.vertices){
 //        vec3 c = v.color;
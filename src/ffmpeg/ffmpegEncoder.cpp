@@ -6,10 +6,14 @@
 
 #include "saiga/ffmpeg/ffmpegEncoder.h"
 #include "saiga/util/assert.h"
+#include "saiga/util/taskScheduler.h"
 
 namespace Saiga {
 
-FFMPEGEncoder::FFMPEGEncoder(int bufferSize) : imageStorage(bufferSize + 1), imageQueue(bufferSize), frameStorage(bufferSize + 1), frameQueue(bufferSize)
+FFMPEGEncoder::FFMPEGEncoder(int bufferSize, int scaleThreads)
+    : bufferSize(bufferSize), scaleThreads(scaleThreads),
+      imageStorage(bufferSize), inputFrameStorage(bufferSize), imageQueue(bufferSize),
+      frameStorage(bufferSize), frameQueue(bufferSize + 1), finishedFrames(0)
 {
     av_log_set_level(AV_LOG_DEBUG);
     avcodec_register_all();
@@ -17,42 +21,57 @@ FFMPEGEncoder::FFMPEGEncoder(int bufferSize) : imageStorage(bufferSize + 1), ima
 }
 
 void FFMPEGEncoder::scaleThreadFunc(){
-    while (running){
-        scaleFrame();
-    }
-    while (scaleFrame()){
+    bool stop = false;
+    while(!stop){
+        //blocks until the next frame is added. the frames that are already waiting are scaled together.
+        scaleJobs.clear();
+        InputFrame input = imageQueue.get();
+        for(;;){
+            if(!input.image && !input.frame){
+                stop = true;
+                break;
+            }
+            ScaleJob job;
+            job.input = input;
+            job.frame = frameStorage.get();
+            scaleJobs.push_back(job);
+            if(scaleJobs.size() == scaleContexts.size() || !imageQueue.tryGet(input)){
+                break;
+            }
+        }
 
-    }
-    finishScale = true;
-}
+        if(scaleJobs.size() == 1){
+            scaleFrame(scaleContexts[0], scaleJobs[0].input, scaleJobs[0].frame);
+        }else{
+            parallelFor(defaultTaskScheduler(), 0, scaleJobs.size(), 1, [this](int i){
+                scaleFrame(scaleContexts[i], scaleJobs[i].input, scaleJobs[i].frame);
+            });
+        }
 
-bool FFMPEGEncoder::scaleFrame()
-{
-    std::shared_ptr<Image> image;
-    if (!imageQueue.tryGet(image)){
-        return false;
+        //in the order of addFrame
+        for(ScaleJob& job : scaleJobs){
+            job.frame->pts = getNextFramePts();
+            if(job.input.image){
+                imageStorage.add(job.input.image);
+            }else{
+                inputFrameStorage.add(job.input.frame);
+            }
+            frameQueue.add(job.frame);
+        }
     }
-    AVFrame *frame = frameStorage.get();
-    scaleFrame(image, frame);
-    imageStorage.add(image);
-    frameQueue.add(frame);
-    return true;
+    scaleJobs.clear();
+    frameQueue.add(nullptr);
 }
 
-void FFMPEGEncoder::scaleFrame(std::shared_ptr<Image> image, AVFrame *frame)
+void FFMPEGEncoder::scaleFrame(SwsContext *ctx, const InputFrame &input, AVFrame *frame)
 {
+    const uint8_t* data = input.image ? input.image->getRawData() : input.frame->data[0];
+    int linesize = input.image ? input.image->getBytesPerRow() : input.frame->linesize[0];
 
-    uint8_t * inData[1] = { image->getRawData() }; // RGB24 have one plane
-    int inLinesize[1] = { image->getBytesPerRow() }; // RGB stride
-
-    //flip
-    if (true) {
-        inData[0] += inLinesize[0] * (image->height - 1);
-        inLinesize[0] = -inLinesize[0];
-    }
-
-    sws_scale(ctx, inData, inLinesize, 0, image->height, frame->data, frame->linesize);
-    frame->pts = getNextFramePts();
+    //flip, because the first row of the input is the bottom of the image
+    const uint8_t * inData[1] = { data + linesize * (inHeight - 1) };
+    int inLinesize[1] = { -linesize };
+    sws_scale(ctx, inData, inLinesize, 0, inHeight, frame->data, frame->linesize);
 }
 
 int64_t FFMPEGEncoder::getNextFramePts(){
@@ -60,30 +79,19 @@ int64_t FFMPEGEncoder::getNextFramePts(){
 }
 
 void FFMPEGEncoder::encodeThreadFunc(){
-    while (!finishScale){
-        encodeFrame();
-    }
-    while (encodeFrame()){
-
-    }
-    finishEncode = true;
-}
-
-bool FFMPEGEncoder::encodeFrame()
-{
-    AVFrame *frame;
-    if (!frameQueue.tryGet(frame)){
-        return false;
-    }
-    AVPacket _pkt;
-    bool hasOutput = encodeFrame(frame, _pkt);
-    if (hasOutput){
-        //        cout << "write frame " << frame->pts << " " << pkt.pts << endl;
-        writeFrame(_pkt);
+    for(;;){
+        AVFrame *frame = frameQueue.get();
+        if(!frame){
+            break;
+        }
+        AVPacket _pkt;
+        bool hasOutput = encodeFrame(frame, _pkt);
+        if (hasOutput){
+            writeFrame(_pkt);
+        }
+        frameStorage.add(frame);
+        finishedFrames++;
     }
-    frameStorage.add(frame);
-    finishedFrames++;
-    return true;
 }
 
 bool FFMPEGEncoder::encodeFrame(AVFrame *frame, AVPacket& pkt)
@@ -94,15 +102,7 @@ bool FFMPEGEncoder::encodeFrame(AVFrame *frame, AVPacket& pkt)
     pkt.data = NULL;    // packet data will be allocated by the encoder
     pkt.size = 0;
 
-    //    packet.data = outbuf;
-    //    packet.size = numBytes;
-    //    packet.stream_index = m_formatCtx->streams[0]->index;
-    //    packet.flags |= AV_PKT_FLAG_KEY;
-    //    packet.pts = packet.dts = pts;
-    //    m_codecContext->coded_frame->pts = pts;
-
     int got_output;
-    //	int ret = avcodec_encode_video2(c, &pkt, frame, &got_output);
     int ret = avcodec_encode_video2(m_codecContext, &pkt, frame, &got_output);
 
     if (ret < 0) {
@@ -114,39 +114,75 @@ bool FFMPEGEncoder::encodeFrame(AVFrame *frame, AVPacket& pkt)
 
 void FFMPEGEncoder::writeFrame(AVPacket& pkt)
 {
-    //    cout << "Write frame "<<pkt.pts << "(size="<<pkt.size<<")"<<endl;
-    //	outputStream.write((const char*)pkt.data, pkt.size);
-    //fwrite(pkt.data, 1, pkt.size, f);
     av_interleaved_write_frame(m_formatCtx, &pkt);
-    //    av_interleaved_write_frame(m_formatCtx, &packet);
     av_free_packet(&pkt);
 }
 
 void FFMPEGEncoder::addFrame(std::shared_ptr<Image> image)
 {
-
-    //    cout << "Add frame. Queue states: Scale="<<imageQueue.count()<<" Encode="<<frameQueue.count()<<endl;
-    imageQueue.add(image);
-
-
+    InputFrame input;
+    input.image = image;
+    imageQueue.add(input);
 }
 
 std::shared_ptr<Image> FFMPEGEncoder::getFrameBuffer()
 {
+    std::shared_ptr<Image> img;
+    if(imageStorage.tryGet(img)){
+        return img;
+    }
+    if(allocatedImages < bufferSize){
+        allocatedImages++;
+        img = std::make_shared<Image>();
+        img->width = inWidth;
+        img->height = inHeight;
+        img->Format() = ImageFormat(4, 8);
+        img->create();
+        return img;
+    }
+    //wait until the scale thread returns one
     return imageStorage.get();
 }
 
+void FFMPEGEncoder::addFrame(AVFrame *frame)
+{
+    InputFrame input;
+    input.frame = frame;
+    imageQueue.add(input);
+}
+
+AVFrame *FFMPEGEncoder::getInputFrame()
+{
+    AVFrame* frame;
+    if(inputFrameStorage.tryGet(frame)){
+        return frame;
+    }
+    if(allocatedInputFrames < bufferSize){
+        allocatedInputFrames++;
+        frame = av_frame_alloc();
+        SAIGA_ASSERT(frame);
+        frame->format = AV_PIX_FMT_RGBA;
+        frame->width = inWidth;
+        frame->height = inHeight;
+        int ret = av_image_alloc(frame->data, frame->linesize, inWidth, inHeight, AV_PIX_FMT_RGBA, 32);
+        SAIGA_ASSERT(ret >= 0);
+        return frame;
+    }
+    return inputFrameStorage.get();
+}
+
 void FFMPEGEncoder::finishEncoding()
 {
     std::cout << "finishEncoding()" << endl;
-    running = false;
+
+    //an empty frame stops the scale thread, which then stops the encode thread
+    imageQueue.add(InputFrame());
 
     scaleThread.join();
     encodeThread.join();
 
     int got_packet_ptr = 1;
 
-    //    int ret;
     while (got_packet_ptr)
     {
 
@@ -155,7 +191,6 @@ void FFMPEGEncoder::finishEncoding()
         packet.data = NULL;    // packet data will be allocated by the encoder
         packet.size = 0;
 
-        //        ret =
         avcodec_encode_video2(m_codecContext, &packet, NULL, &got_packet_ptr);
         if (got_packet_ptr)
         {
@@ -168,11 +203,12 @@ void FFMPEGEncoder::finishEncoding()
     av_write_trailer(m_formatCtx);
 
     avcodec_close(m_codecContext);
-    sws_freeContext(ctx);
-    //    avformat_free_context(m_formatCtx);
+    for(SwsContext* ctx : scaleContexts){
+        sws_freeContext(ctx);
+    }
+    scaleContexts.clear();
     avcodec_free_context(&m_codecContext);
-
-    //    av_free(m_codecContext);
+    freeBuffers();
 }
 
 void FFMPEGEncoder::startEncoding(const std::string &filename, int outWidth, int outHeight, int inWidth, int inHeight, int outFps, int bitRate, AVCodecID videoCodecId)
@@ -263,32 +299,34 @@ void FFMPEGEncoder::startEncoding(const std::string &filename, int outWidth, int
     //  av_init_packet(&pkt);
 
 
-    SAIGA_ASSERT(ctx == nullptr);
-    ctx = sws_getContext(inWidth, inHeight,
-                         AV_PIX_FMT_RGBA, m_codecContext->width, m_codecContext->height,
-                         AV_PIX_FMT_YUV420P, 0, 0, 0, 0);
-    SAIGA_ASSERT(ctx);
-
+    createScaleContexts();
     createBuffers();
-    running = true;
 
     scaleThread = std::thread(&FFMPEGEncoder::scaleThreadFunc, this);
     encodeThread = std::thread(&FFMPEGEncoder::encodeThreadFunc, this);
 
 }
 
-void FFMPEGEncoder::createBuffers()
+void FFMPEGEncoder::createScaleContexts()
 {
-    for (int i = 0; i < imageStorage.capacity; ++i){
-        std::shared_ptr<Image> img = std::make_shared<Image>();
-        img->width = inWidth;
-        img->height = inHeight;
-        img->Format() = ImageFormat(4, 8);
-        img->create();
-        imageStorage.add(img);
+    SAIGA_ASSERT(scaleContexts.empty());
+
+    int numContexts = scaleThreads > 0 ? scaleThreads : defaultTaskScheduler().numThreads();
+    //more parallel frames than buffers are not possible
+    numContexts = std::max(1, std::min(numContexts, bufferSize));
+
+    for(int i = 0; i < numContexts; ++i){
+        SwsContext* ctx = sws_getContext(inWidth, inHeight,
+                                         AV_PIX_FMT_RGBA, m_codecContext->width, m_codecContext->height,
+                                         AV_PIX_FMT_YUV420P, 0, 0, 0, 0);
+        SAIGA_ASSERT(ctx);
+        scaleContexts.push_back(ctx);
     }
+}
 
-    for (int i = 0; i < frameStorage.capacity; ++i){
+void FFMPEGEncoder::createBuffers()
+{
+    for (int i = 0; i < bufferSize; ++i){
         AVFrame* frame = av_frame_alloc();
         if (!frame) {
             fprintf(stderr, "Could not allocate video frame\n");
@@ -308,9 +346,21 @@ void FFMPEGEncoder::createBuffers()
         }
         frameStorage.add(frame);
     }
+}
 
-
-
+void FFMPEGEncoder::freeBuffers()
+{
+    //all buffers are back in the storage queues after the threads are finished
+    AVFrame* frame;
+    while(frameStorage.tryGet(frame) || inputFrameStorage.tryGet(frame)){
+        av_freep(&frame->data[0]);
+        av_frame_free(&frame);
+    }
+    std::shared_ptr<Image> img;
+    while(imageStorage.tryGet(img)){
+    }
+    allocatedImages = 0;
+    allocatedInputFrames = 0;
 }
 
 }
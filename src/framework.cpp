@@ -7,6 +7,7 @@
 #include "saiga/framework.h"
 
 #include "saiga/opengl/shader/shaderLoader.h"
+#include "saiga/opengl/shader/shaderBinaryCache.h"
 #include "saiga/opengl/texture/textureLoader.h"
 
 #include "saiga/util/configloader.h"
@@ -23,6 +24,7 @@ std::string SHADER_PATH;
 std::string TEXTURE_PATH;
 std::string MATERIAL_PATH;
 std::string OBJ_PATH;
+std::string SHADER_CACHE_PATH;
 
 void readConfigFile(){
     ConfigLoader cl;
@@ -30,6 +32,8 @@ void readConfigFile(){
 
     SHADER_PATH = cl.getString("SHADER_PATH","/usr/local/share/saiga/shader");
     TEXTURE_PATH = cl.getString("TEXTURE_PATH","textures");
+    //linked shader programs are stored here, for example "shader_cache". empty: no cache (default)
+    SHADER_CACHE_PATH = cl.getString("SHADER_CACHE_PATH","");
 
     cl.writeFile();
 
@@ -72,6 +76,7 @@ void initSaiga()
     //    shaderPathes.addSearchPath(SHADER_PATH+"/geometry");
     //    shaderPathes.addSearchPath(SHADER_PATH+"/lighting");
     //    shaderPathes.addSearchPath(SHADER_PATH+"/post_processing");
+    shaderBinaryCache.setDirectory(SHADER_CACHE_PATH);
 
     TextureLoader::instance()->addPath(TEXTURE_PATH);
     TextureLoader::instance()->addPath(OBJ_PATH);
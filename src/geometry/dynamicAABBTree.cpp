@@ -0,0 +1,343 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/geometry/dynamicAABBTree.h"
+#include "saiga/util/assert.h"
+
+namespace Saiga {
+
+static AABB combine(const AABB& a, const AABB& b){
+    return AABB(glm::min(a.min,b.min),glm::max(a.max,b.max));
+}
+
+static float area(const AABB& box){
+    vec3 d = box.max - box.min;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+static bool contains(const AABB& outer, const AABB& inner){
+    return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z
+            && outer.max.x >= inner.max.x && outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+}
+
+int DynamicAABBTree::insert(const AABB &box, int userData)
+{
+    int proxy = allocateNode();
+    Node& n = nodes[proxy];
+    n.tight = box;
+    n.box = AABB(box.min - vec3(margin),box.max + vec3(margin));
+    n.userData = userData;
+    n.height = 0;
+    insertLeaf(proxy);
+    proxyCount++;
+    return proxy;
+}
+
+void DynamicAABBTree::remove(int proxy)
+{
+    SAIGA_ASSERT(proxy >= 0 && proxy < (int)nodes.size() && nodes[proxy].isLeaf());
+    removeLeaf(proxy);
+    freeNode(proxy);
+    proxyCount--;
+}
+
+bool DynamicAABBTree::move(int proxy, const AABB &box)
+{
+    SAIGA_ASSERT(proxy >= 0 && proxy < (int)nodes.size() && nodes[proxy].isLeaf());
+    Node& n = nodes[proxy];
+    n.tight = box;
+    //the boxes of the parents are still valid
+    if(contains(n.box,box))
+        return false;
+
+    removeLeaf(proxy);
+    nodes[proxy].box = AABB(box.min - vec3(margin),box.max + vec3(margin));
+    insertLeaf(proxy);
+    return true;
+}
+
+void DynamicAABBTree::clear()
+{
+    nodes.clear();
+    root = -1;
+    freeList = -1;
+    proxyCount = 0;
+}
+
+void DynamicAABBTree::query(const FrustumCuller &culler, std::vector<int> &result, QueryBuffer &buffer) const
+{
+    if(root == -1)
+        return;
+
+    AABBArray& candidates = buffer.candidates;
+    std::vector<int>& candidateData = buffer.candidateData;
+    std::vector<std::pair<int,int>>& stack = buffer.stack;
+
+    candidates.clear();
+    candidateData.clear();
+    stack.clear();
+    //every leaf is at most one candidate, so the arrays only grow on the first queries
+    candidates.reserve(proxyCount);
+    candidateData.reserve(proxyCount);
+    stack.emplace_back(root,culler.allPlanes());
+    while(!stack.empty()){
+        int node = stack.back().first;
+        int planeMask = stack.back().second;
+        stack.pop_back();
+
+        const Node& n = nodes[node];
+        FrustumCuller::IntersectionResult r = culler.classifyAABB(n.box,planeMask);
+        if(r == FrustumCuller::OUTSIDE)
+            continue;
+        if(r == FrustumCuller::INSIDE){
+            collectLeaves(node,result);
+        }else if(n.isLeaf()){
+            candidates.push_back(n.tight);
+            candidateData.push_back(n.userData);
+        }else{
+            stack.emplace_back(n.left,planeMask);
+            stack.emplace_back(n.right,planeMask);
+        }
+    }
+
+    buffer.candidateVisible.resize(candidates.size());
+    culler.cullAABBs(candidates,buffer.candidateVisible.data());
+    for(int i = 0 ; i < (int)candidateData.size() ; ++i){
+        if(buffer.candidateVisible[i])
+            result.push_back(candidateData[i]);
+    }
+}
+
+int DynamicAABBTree::allocateNode()
+{
+    if(freeList == -1){
+        nodes.push_back(Node());
+        return nodes.size() - 1;
+    }
+    int node = freeList;
+    freeList = nodes[node].parent;
+    nodes[node] = Node();
+    return node;
+}
+
+void DynamicAABBTree::freeNode(int node)
+{
+    nodes[node].parent = freeList;
+    nodes[node].height = -1;
+    freeList = node;
+}
+
+void DynamicAABBTree::insertLeaf(int leaf)
+{
+    if(root == -1){
+        root = leaf;
+        nodes[root].parent = -1;
+        return;
+    }
+
+    //find the best sibling with the surface area heuristic
+    AABB leafBox = nodes[leaf].box;
+    int index = root;
+    while(!nodes[index].isLeaf()){
+        const Node& n = nodes[index];
+        float a = area(n.box);
+        float combinedArea = area(combine(n.box,leafBox));
+
+        //cost of creating a new parent for this node and the new leaf
+        float cost = 2.0f * combinedArea;
+        //minimum cost of pushing the leaf further down the tree
+        float inheritanceCost = 2.0f * (combinedArea - a);
+
+        float costs[2];
+        int children[2] = {n.left, n.right};
+        for(int i = 0 ; i < 2 ; ++i){
+            const Node& c = nodes[children[i]];
+            float newArea = area(combine(leafBox,c.box));
+            costs[i] = (c.isLeaf() ? newArea : newArea - area(c.box)) + inheritanceCost;
+        }
+
+        if(cost < costs[0] && cost < costs[1])
+            break;
+        index = costs[0] < costs[1] ? children[0] : children[1];
+    }
+    int sibling = index;
+
+    int oldParent = nodes[sibling].parent;
+    int newParent = allocateNode();
+    Node& p = nodes[newParent];
+    p.parent = oldParent;
+    p.box = combine(leafBox,nodes[sibling].box);
+    p.height = nodes[sibling].height + 1;
+    p.left = sibling;
+    p.right = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if(oldParent != -1){
+        if(nodes[oldParent].left == sibling)
+            nodes[oldParent].left = newParent;
+        else
+            nodes[oldParent].right = newParent;
+    }else{
+        root = newParent;
+    }
+
+    //refit and balance the ancestors
+    index = nodes[leaf].parent;
+    while(index != -1){
+        index = balance(index);
+        Node& n = nodes[index];
+        n.height = 1 + std::max(nodes[n.left].height,nodes[n.right].height);
+        n.box = combine(nodes[n.left].box,nodes[n.right].box);
+        index = n.parent;
+    }
+}
+
+void DynamicAABBTree::removeLeaf(int leaf)
+{
+    if(leaf == root){
+        root = -1;
+        return;
+    }
+
+    int parent = nodes[leaf].parent;
+    int grandParent = nodes[parent].parent;
+    int sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+    if(grandParent == -1){
+        root = sibling;
+        nodes[sibling].parent = -1;
+        freeNode(parent);
+        return;
+    }
+
+    //replace the parent with the sibling
+    if(nodes[grandParent].left == parent)
+        nodes[grandParent].left = sibling;
+    else
+        nodes[grandParent].right = sibling;
+    nodes[sibling].parent = grandParent;
+    freeNode(parent);
+
+    int index = grandParent;
+    while(index != -1){
+        index = balance(index);
+        Node& n = nodes[index];
+        n.height = 1 + std::max(nodes[n.left].height,nodes[n.right].height);
+        n.box = combine(nodes[n.left].box,nodes[n.right].box);
+        index = n.parent;
+    }
+}
+
+//Rotates the higher child up, if the subtree of 'iA' is unbalanced. Returns the new root of the subtree.
+int DynamicAABBTree::balance(int iA)
+{
+    Node& A = nodes[iA];
+    if(A.isLeaf() || A.height < 2)
+        return iA;
+
+    int iB = A.left;
+    int iC = A.right;
+    Node& B = nodes[iB];
+    Node& C = nodes[iC];
+
+    int diff = C.height - B.height;
+
+    if(diff > 1){
+        //rotate C up
+        int iF = C.left;
+        int iG = C.right;
+        Node& F = nodes[iF];
+        Node& G = nodes[iG];
+
+        C.left = iA;
+        C.parent = A.parent;
+        A.parent = iC;
+
+        if(C.parent != -1){
+            if(nodes[C.parent].left == iA)
+                nodes[C.parent].left = iC;
+            else
+                nodes[C.parent].right = iC;
+        }else{
+            root = iC;
+        }
+
+        if(F.height > G.height){
+            C.right = iF;
+            A.right = iG;
+            G.parent = iA;
+            A.box = combine(B.box,G.box);
+            C.box = combine(A.box,F.box);
+            A.height = 1 + std::max(B.height,G.height);
+            C.height = 1 + std::max(A.height,F.height);
+        }else{
+            C.right = iG;
+            A.right = iF;
+            F.parent = iA;
+            A.box = combine(B.box,F.box);
+            C.box = combine(A.box,G.box);
+            A.height = 1 + std::max(B.height,F.height);
+            C.height = 1 + std::max(A.height,G.height);
+        }
+        return iC;
+    }
+
+    if(diff < -1){
+        //rotate B up
+        int iD = B.left;
+        int iE = B.right;
+        Node& D = nodes[iD];
+        Node& E = nodes[iE];
+
+        B.left = iA;
+        B.parent = A.parent;
+        A.parent = iB;
+
+        if(B.parent != -1){
+            if(nodes[B.parent].left == iA)
+                nodes[B.parent].left = iB;
+            else
+                nodes[B.parent].right = iB;
+        }else{
+            root = iB;
+        }
+
+        if(D.height > E.height){
+            B.right = iD;
+            A.left = iE;
+            E.parent = iA;
+            A.box = combine(C.box,E.box);
+            B.box = combine(A.box,D.box);
+            A.height = 1 + std::max(C.height,E.height);
+            B.height = 1 + std::max(A.height,D.height);
+        }else{
+            B.right = iE;
+            A.left = iD;
+            D.parent = iA;
+            A.box = combine(C.box,D.box);
+            B.box = combine(A.box,E.box);
+            A.height = 1 + std::max(C.height,D.height);
+            B.height = 1 + std::max(A.height,E.height);
+        }
+        return iB;
+    }
+
+    return iA;
+}
+
+void DynamicAABBTree::collectLeaves(int node, std::vector<int> &result) const
+{
+    const Node& n = nodes[node];
+    if(n.isLeaf()){
+        result.push_back(n.userData);
+    }else{
+        collectLeaves(n.left,result);
+        collectLeaves(n.right,result);
+    }
+}
+
+}
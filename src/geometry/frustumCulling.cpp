@@ -0,0 +1,185 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/geometry/frustumCulling.h"
+#include "saiga/util/assert.h"
+#include "saiga/util/simd.h"
+
+namespace Saiga {
+
+void FrustumCuller::setPlanes(const Plane *p, int count)
+{
+    SAIGA_ASSERT(count >= 0 && count <= maxPlanes);
+    planeCount = count;
+    for(int i = 0 ; i < count ; ++i){
+        planes[i] = vec4(p[i].normal,p[i].d);
+    }
+}
+
+bool FrustumCuller::sphereVisible(const Sphere &s) const
+{
+    for(int i = 0 ; i < planeCount ; ++i){
+        //same as Plane::distance
+        float distance = planes[i].w + glm::dot(s.pos,vec3(planes[i]));
+        if(distance >= s.r)
+            return false;
+    }
+    return true;
+}
+
+bool FrustumCuller::aabbVisible(const AABB &box) const
+{
+    int mask = allPlanes();
+    return classifyAABB(box,mask) != OUTSIDE;
+}
+
+FrustumCuller::IntersectionResult FrustumCuller::classifyAABB(const AABB &box, int &planeMask) const
+{
+    vec3 center = (box.min + box.max) * 0.5f;
+    vec3 extends = (box.max - box.min) * 0.5f;
+
+    IntersectionResult result = INSIDE;
+    for(int i = 0 ; i < planeCount ; ++i){
+        if(!(planeMask & (1 << i)))
+            continue;
+        vec3 n = vec3(planes[i]);
+        float distance = planes[i].w + glm::dot(center,n);
+        float radius = glm::dot(extends,glm::abs(n));
+        if(distance >= radius)
+            return OUTSIDE;
+        if(distance > -radius)
+            result = INTERSECT;
+        else
+            planeMask &= ~(1 << i);
+    }
+    return result;
+}
+
+int FrustumCuller::cullSpheres(const SphereArray &spheres, unsigned char *visible) const
+{
+    int n = spheres.size();
+    int count = 0;
+    int i = 0;
+
+#if defined(SAIGA_HAS_AVX)
+    for(; i + 8 <= n ; i += 8){
+        __m256 x = _mm256_loadu_ps(spheres.x.data() + i);
+        __m256 y = _mm256_loadu_ps(spheres.y.data() + i);
+        __m256 z = _mm256_loadu_ps(spheres.z.data() + i);
+        __m256 r = _mm256_loadu_ps(spheres.r.data() + i);
+        __m256 outside = _mm256_setzero_ps();
+        for(int p = 0 ; p < planeCount ; ++p){
+            __m256 dot = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(planes[p].x),x),_mm256_mul_ps(_mm256_set1_ps(planes[p].y),y)),
+                                       _mm256_mul_ps(_mm256_set1_ps(planes[p].z),z));
+            __m256 distance = _mm256_add_ps(_mm256_set1_ps(planes[p].w),dot);
+            outside = _mm256_or_ps(outside,_mm256_cmp_ps(distance,r,_CMP_GE_OQ));
+        }
+        int mask = ~_mm256_movemask_ps(outside);
+        for(int k = 0 ; k < 8 ; ++k){
+            visible[i + k] = (mask >> k) & 1;
+            count += visible[i + k];
+        }
+    }
+#endif
+
+#if defined(SAIGA_HAS_SSE2)
+    for(; i + 4 <= n ; i += 4){
+        __m128 x = _mm_loadu_ps(spheres.x.data() + i);
+        __m128 y = _mm_loadu_ps(spheres.y.data() + i);
+        __m128 z = _mm_loadu_ps(spheres.z.data() + i);
+        __m128 r = _mm_loadu_ps(spheres.r.data() + i);
+        __m128 outside = _mm_setzero_ps();
+        for(int p = 0 ; p < planeCount ; ++p){
+            __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes[p].x),x),_mm_mul_ps(_mm_set1_ps(planes[p].y),y)),
+                                    _mm_mul_ps(_mm_set1_ps(planes[p].z),z));
+            __m128 distance = _mm_add_ps(_mm_set1_ps(planes[p].w),dot);
+            outside = _mm_or_ps(outside,_mm_cmpge_ps(distance,r));
+        }
+        int mask = ~_mm_movemask_ps(outside);
+        for(int k = 0 ; k < 4 ; ++k){
+            visible[i + k] = (mask >> k) & 1;
+            count += visible[i + k];
+        }
+    }
+#endif
+
+    for(; i < n ; ++i){
+        Sphere s(vec3(spheres.x[i],spheres.y[i],spheres.z[i]),spheres.r[i]);
+        visible[i] = sphereVisible(s);
+        count += visible[i];
+    }
+    return count;
+}
+
+int FrustumCuller::cullAABBs(const AABBArray &boxes, unsigned char *visible) const
+{
+    int n = boxes.size();
+    int count = 0;
+    int i = 0;
+
+#if defined(SAIGA_HAS_AVX)
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    for(; i + 8 <= n ; i += 8){
+        __m256 minx = _mm256_loadu_ps(boxes.minx.data() + i), maxx = _mm256_loadu_ps(boxes.maxx.data() + i);
+        __m256 miny = _mm256_loadu_ps(boxes.miny.data() + i), maxy = _mm256_loadu_ps(boxes.maxy.data() + i);
+        __m256 minz = _mm256_loadu_ps(boxes.minz.data() + i), maxz = _mm256_loadu_ps(boxes.maxz.data() + i);
+        __m256 cx = _mm256_mul_ps(_mm256_add_ps(minx,maxx),half), ex = _mm256_mul_ps(_mm256_sub_ps(maxx,minx),half);
+        __m256 cy = _mm256_mul_ps(_mm256_add_ps(miny,maxy),half), ey = _mm256_mul_ps(_mm256_sub_ps(maxy,miny),half);
+        __m256 cz = _mm256_mul_ps(_mm256_add_ps(minz,maxz),half), ez = _mm256_mul_ps(_mm256_sub_ps(maxz,minz),half);
+        __m256 outside = _mm256_setzero_ps();
+        for(int p = 0 ; p < planeCount ; ++p){
+            __m256 nx = _mm256_set1_ps(planes[p].x), ny = _mm256_set1_ps(planes[p].y), nz = _mm256_set1_ps(planes[p].z);
+            __m256 dot = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(cx,nx),_mm256_mul_ps(cy,ny)),_mm256_mul_ps(cz,nz));
+            __m256 distance = _mm256_add_ps(_mm256_set1_ps(planes[p].w),dot);
+            __m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ex,_mm256_and_ps(nx,absMask)),_mm256_mul_ps(ey,_mm256_and_ps(ny,absMask))),
+                                          _mm256_mul_ps(ez,_mm256_and_ps(nz,absMask)));
+            outside = _mm256_or_ps(outside,_mm256_cmp_ps(distance,radius,_CMP_GE_OQ));
+        }
+        int mask = ~_mm256_movemask_ps(outside);
+        for(int k = 0 ; k < 8 ; ++k){
+            visible[i + k] = (mask >> k) & 1;
+            count += visible[i + k];
+        }
+    }
+#endif
+
+#if defined(SAIGA_HAS_SSE2)
+    const __m128 half4 = _mm_set1_ps(0.5f);
+    const __m128 absMask4 = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    for(; i + 4 <= n ; i += 4){
+        __m128 minx = _mm_loadu_ps(boxes.minx.data() + i), maxx = _mm_loadu_ps(boxes.maxx.data() + i);
+        __m128 miny = _mm_loadu_ps(boxes.miny.data() + i), maxy = _mm_loadu_ps(boxes.maxy.data() + i);
+        __m128 minz = _mm_loadu_ps(boxes.minz.data() + i), maxz = _mm_loadu_ps(boxes.maxz.data() + i);
+        __m128 cx = _mm_mul_ps(_mm_add_ps(minx,maxx),half4), ex = _mm_mul_ps(_mm_sub_ps(maxx,minx),half4);
+        __m128 cy = _mm_mul_ps(_mm_add_ps(miny,maxy),half4), ey = _mm_mul_ps(_mm_sub_ps(maxy,miny),half4);
+        __m128 cz = _mm_mul_ps(_mm_add_ps(minz,maxz),half4), ez = _mm_mul_ps(_mm_sub_ps(maxz,minz),half4);
+        __m128 outside = _mm_setzero_ps();
+        for(int p = 0 ; p < planeCount ; ++p){
+            __m128 nx = _mm_set1_ps(planes[p].x), ny = _mm_set1_ps(planes[p].y), nz = _mm_set1_ps(planes[p].z);
+            __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx,nx),_mm_mul_ps(cy,ny)),_mm_mul_ps(cz,nz));
+            __m128 distance = _mm_add_ps(_mm_set1_ps(planes[p].w),dot);
+            __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex,_mm_and_ps(nx,absMask4)),_mm_mul_ps(ey,_mm_and_ps(ny,absMask4))),
+                                       _mm_mul_ps(ez,_mm_and_ps(nz,absMask4)));
+            outside = _mm_or_ps(outside,_mm_cmpge_ps(distance,radius));
+        }
+        int mask = ~_mm_movemask_ps(outside);
+        for(int k = 0 ; k < 4 ; ++k){
+            visible[i + k] = (mask >> k) & 1;
+            count += visible[i + k];
+        }
+    }
+#endif
+
+    for(; i < n ; ++i){
+        AABB box(vec3(boxes.minx[i],boxes.miny[i],boxes.minz[i]),vec3(boxes.maxx[i],boxes.maxy[i],boxes.maxz[i]));
+        visible[i] = aabbVisible(box);
+        count += visible[i];
+    }
+    return count;
+}
+
+}
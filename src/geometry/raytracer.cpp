@@ -9,6 +9,36 @@
 namespace Saiga {
 
 Raytracer::Result Raytracer::trace(Ray &r){
+    Result res;
+    res.valid = bvh.getClosest(r,res.triangle,res.distance,res.back);
+    return res;
+}
+
+
+int Raytracer::trace(Ray &r, std::vector<Result> &output){
+    int count = 0;
+
+    bvh.forEachIntersection(r,[&](unsigned int triangle, float d, bool back){
+        Result res;
+        res.valid = true;
+        res.distance = d;
+        res.triangle = triangle;
+        res.back = back;
+        output.push_back(res);
+        count++;
+    });
+
+    return count;
+}
+
+void Raytracer::trace(const Ray *rays, size_t n, Result *out){
+    for(size_t i = 0 ; i < n ; ++i){
+        Result& res = out[i];
+        res.valid = bvh.getClosest(rays[i],res.triangle,res.distance,res.back);
+    }
+}
+
+Raytracer::Result Raytracer::traceBruteForce(Ray &r){
     Result res;
     res.distance = std::numeric_limits<float>::infinity();
 
@@ -30,7 +60,7 @@ Raytracer::Result Raytracer::trace(Ray &r){
 }
 
 
-int Raytracer::trace(Ray &r, std::vector<Result> &output){
+int Raytracer::traceBruteForce(Ray &r, std::vector<Result> &output){
     int count = 0;
 
     for(unsigned int i =0;i<triangles.size();++i){
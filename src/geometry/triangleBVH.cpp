@@ -0,0 +1,444 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/geometry/triangleBVH.h"
+#include "saiga/util/assert.h"
+#include "saiga/util/simd.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace Saiga {
+
+//after this depth only median splits are done, which guarantees a maximum depth of 64
+//for the traversal stack.
+#define BVH_MAX_SAH_DEPTH 32
+
+static float surfaceArea(const AABB& box){
+    vec3 d = box.max - box.min;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+void TriangleBVH::construct(const std::vector<Triangle> &triangles)
+{
+    nodes.clear();
+    indices.resize(triangles.size());
+
+    if(triangles.empty())
+        return;
+
+    std::vector<BuildTriangle> bt(triangles.size());
+    for(unsigned int i = 0 ; i < triangles.size() ; ++i){
+        const Triangle& tri = triangles[i];
+        bt[i].box.makeNegative();
+        bt[i].box.growBox(tri.a);
+        bt[i].box.growBox(tri.b);
+        bt[i].box.growBox(tri.c);
+        bt[i].center = (tri.a + tri.b + tri.c) / 3.0f;
+        indices[i] = i;
+    }
+
+    //a binary tree with at least 1 triangle per leaf has at most 2n-1 nodes
+    nodes.reserve(2 * triangles.size());
+    build(bt,0,triangles.size(),0);
+    createBlocks(triangles);
+}
+
+void TriangleBVH::createBlocks(const std::vector<Triangle> &triangles)
+{
+    blocks.clear();
+    for(Node& node : nodes){
+        if(!node.isLeaf())
+            continue;
+
+        node.block = blocks.size();
+        for(int b = 0 ; b < node.blockCount() ; ++b){
+            TriangleBlock block;
+            int first = node.start + b * TriangleBlock::size;
+            block.count = std::min(TriangleBlock::size, node.start + node.count - first);
+
+            for(int i = 0 ; i < TriangleBlock::size ; ++i){
+                //the unused lanes are filled with degenerated triangles which are never hit
+                Triangle tri(vec3(0),vec3(0),vec3(0));
+                unsigned int id = 0;
+                if(i < block.count){
+                    id = indices[first + i];
+                    tri = triangles[id];
+                }
+                vec3 e1 = tri.b - tri.a;
+                vec3 e2 = tri.c - tri.a;
+                block.ax[i] = tri.a.x;
+                block.ay[i] = tri.a.y;
+                block.az[i] = tri.a.z;
+                block.e1x[i] = e1.x;
+                block.e1y[i] = e1.y;
+                block.e1z[i] = e1.z;
+                block.e2x[i] = e2.x;
+                block.e2y[i] = e2.y;
+                block.e2z[i] = e2.z;
+                block.id[i] = id;
+            }
+            blocks.push_back(block);
+        }
+    }
+}
+
+int TriangleBVH::build(std::vector<BuildTriangle> &bt, int start, int end, int currentDepth)
+{
+    int nodeId = nodes.size();
+    nodes.push_back(Node());
+
+    AABB box, centerBox;
+    box.makeNegative();
+    centerBox.makeNegative();
+    for(int i = start ; i < end ; ++i){
+        box.growBox(bt[indices[i]].box);
+        centerBox.growBox(bt[indices[i]].center);
+    }
+    nodes[nodeId].box = box;
+
+    int count = end - start;
+    if(count <= maxLeafSize){
+        nodes[nodeId].start = start;
+        nodes[nodeId].count = count;
+        return nodeId;
+    }
+
+    int axis = centerBox.maxDimension();
+    float cmin = centerBox.min[axis];
+    float extent = centerBox.max[axis] - cmin;
+
+    int mid = -1;
+
+    if(extent > 0 && currentDepth < BVH_MAX_SAH_DEPTH){
+        //binned SAH: sort the triangle centers into equally sized bins
+        //and evaluate the cost function at all bin boundaries.
+        struct Bin{
+            AABB box;
+            int count = 0;
+        };
+        std::vector<Bin> bins(sahBins);
+        for(Bin& b : bins)
+            b.box.makeNegative();
+
+        float binScale = sahBins / extent;
+        auto binId = [&](unsigned int id){
+            int b = int((bt[id].center[axis] - cmin) * binScale);
+            return std::min(b, sahBins - 1);
+        };
+
+        for(int i = start ; i < end ; ++i){
+            Bin& b = bins[binId(indices[i])];
+            b.count++;
+            b.box.growBox(bt[indices[i]].box);
+        }
+
+        //sweep from the right to get the cost of the right side of each split
+        std::vector<float> rightCost(sahBins);
+        AABB rightBox;
+        rightBox.makeNegative();
+        int rightCount = 0;
+        for(int i = sahBins - 1 ; i > 0 ; --i){
+            rightBox.growBox(bins[i].box);
+            rightCount += bins[i].count;
+            rightCost[i] = rightCount == 0 ? 0 : rightCount * surfaceArea(rightBox);
+        }
+
+        //sweep from the left and combine
+        float bestCost = std::numeric_limits<float>::infinity();
+        int bestSplit = -1;
+        AABB leftBox;
+        leftBox.makeNegative();
+        int leftCount = 0;
+        for(int i = 0 ; i < sahBins - 1 ; ++i){
+            leftBox.growBox(bins[i].box);
+            leftCount += bins[i].count;
+            if(leftCount == 0 || leftCount == count)
+                continue;
+            float cost = leftCount * surfaceArea(leftBox) + rightCost[i+1];
+            if(cost < bestCost){
+                bestCost = cost;
+                bestSplit = i;
+            }
+        }
+
+        //relative costs: 1 for traversing a node, 1 for each triangle intersection
+        float splitCost = 1.0f + bestCost / surfaceArea(box);
+        if(bestSplit == -1 || (splitCost >= count && count <= 4 * maxLeafSize)){
+            nodes[nodeId].start = start;
+            nodes[nodeId].count = count;
+            return nodeId;
+        }
+
+        auto it = std::partition(indices.begin() + start, indices.begin() + end,
+                                 [&](unsigned int id){ return binId(id) <= bestSplit; });
+        mid = it - indices.begin();
+    }
+
+    if(mid <= start || mid >= end){
+        //all centers are at the same position or the maximum depth is reached
+        //-> object median split
+        mid = (start + end) / 2;
+        std::nth_element(indices.begin() + start, indices.begin() + mid, indices.begin() + end,
+                         [&](unsigned int a, unsigned int b){ return bt[a].center[axis] < bt[b].center[axis]; });
+    }
+
+    int left = build(bt,start,mid,currentDepth+1);
+    int right = build(bt,mid,end,currentDepth+1);
+    //don't use a reference here, because the vector may be resized in the recursive calls
+    nodes[nodeId].left = left;
+    nodes[nodeId].right = right;
+    return nodeId;
+}
+
+//The triangle intersection below is a vectorized version of 'Ray::intersectTriangle'.
+//The operations are done in the same order to get bitwise identical results.
+#define BVH_EPSILON 0.000001f
+
+#if defined(SAIGA_HAS_AVX)
+
+static int intersectBlockAVX(const TriangleBVH::TriangleBlock& b, const Ray &r, float* t, int& backMask)
+{
+    const __m256 eps = _mm256_set1_ps(BVH_EPSILON);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+
+    __m256 dx = _mm256_set1_ps(r.direction.x);
+    __m256 dy = _mm256_set1_ps(r.direction.y);
+    __m256 dz = _mm256_set1_ps(r.direction.z);
+
+    __m256 e1x = _mm256_loadu_ps(b.e1x);
+    __m256 e1y = _mm256_loadu_ps(b.e1y);
+    __m256 e1z = _mm256_loadu_ps(b.e1z);
+    __m256 e2x = _mm256_loadu_ps(b.e2x);
+    __m256 e2y = _mm256_loadu_ps(b.e2y);
+    __m256 e2z = _mm256_loadu_ps(b.e2z);
+
+    //n = cross(e1,e2)
+    __m256 nx = _mm256_sub_ps(_mm256_mul_ps(e1y,e2z),_mm256_mul_ps(e2y,e1z));
+    __m256 ny = _mm256_sub_ps(_mm256_mul_ps(e1z,e2x),_mm256_mul_ps(e2z,e1x));
+    __m256 nz = _mm256_sub_ps(_mm256_mul_ps(e1x,e2y),_mm256_mul_ps(e2x,e1y));
+    __m256 dn = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx,nx),_mm256_mul_ps(dy,ny)),_mm256_mul_ps(dz,nz));
+    __m256 back = _mm256_cmp_ps(dn,zero,_CMP_GT_OQ);
+
+    //P = cross(dir,e2)
+    __m256 px = _mm256_sub_ps(_mm256_mul_ps(dy,e2z),_mm256_mul_ps(e2y,dz));
+    __m256 py = _mm256_sub_ps(_mm256_mul_ps(dz,e2x),_mm256_mul_ps(e2z,dx));
+    __m256 pz = _mm256_sub_ps(_mm256_mul_ps(dx,e2y),_mm256_mul_ps(e2x,dy));
+    __m256 det = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e1x,px),_mm256_mul_ps(e1y,py)),_mm256_mul_ps(e1z,pz));
+    __m256 mask = _mm256_or_ps(_mm256_cmp_ps(det,_mm256_sub_ps(zero,eps),_CMP_LE_OQ),_mm256_cmp_ps(det,eps,_CMP_GE_OQ));
+    __m256 invDet = _mm256_div_ps(one,det);
+
+    //T = origin - a
+    __m256 tx = _mm256_sub_ps(_mm256_set1_ps(r.origin.x),_mm256_loadu_ps(b.ax));
+    __m256 ty = _mm256_sub_ps(_mm256_set1_ps(r.origin.y),_mm256_loadu_ps(b.ay));
+    __m256 tz = _mm256_sub_ps(_mm256_set1_ps(r.origin.z),_mm256_loadu_ps(b.az));
+
+    __m256 u = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(tx,px),_mm256_mul_ps(ty,py)),_mm256_mul_ps(tz,pz)),invDet);
+    mask = _mm256_and_ps(mask,_mm256_and_ps(_mm256_cmp_ps(u,zero,_CMP_GE_OQ),_mm256_cmp_ps(u,one,_CMP_LE_OQ)));
+
+    //Q = cross(T,e1)
+    __m256 qx = _mm256_sub_ps(_mm256_mul_ps(ty,e1z),_mm256_mul_ps(e1y,tz));
+    __m256 qy = _mm256_sub_ps(_mm256_mul_ps(tz,e1x),_mm256_mul_ps(e1z,tx));
+    __m256 qz = _mm256_sub_ps(_mm256_mul_ps(tx,e1y),_mm256_mul_ps(e1x,ty));
+
+    __m256 v = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx,qx),_mm256_mul_ps(dy,qy)),_mm256_mul_ps(dz,qz)),invDet);
+    mask = _mm256_and_ps(mask,_mm256_and_ps(_mm256_cmp_ps(v,zero,_CMP_GE_OQ),_mm256_cmp_ps(_mm256_add_ps(u,v),one,_CMP_LE_OQ)));
+
+    __m256 dist = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e2x,qx),_mm256_mul_ps(e2y,qy)),_mm256_mul_ps(e2z,qz)),invDet);
+    mask = _mm256_and_ps(mask,_mm256_cmp_ps(dist,eps,_CMP_GT_OQ));
+
+    _mm256_storeu_ps(t,dist);
+    backMask = _mm256_movemask_ps(back);
+    return _mm256_movemask_ps(mask);
+}
+
+#elif defined(SAIGA_HAS_SSE2)
+
+//intersects the 4 triangles starting at lane 'o'
+static int intersectBlockSSE(const TriangleBVH::TriangleBlock& b, int o, const Ray &r, float* t, int& backMask)
+{
+    const __m128 eps = _mm_set1_ps(BVH_EPSILON);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    __m128 dx = _mm_set1_ps(r.direction.x);
+    __m128 dy = _mm_set1_ps(r.direction.y);
+    __m128 dz = _mm_set1_ps(r.direction.z);
+
+    __m128 e1x = _mm_loadu_ps(b.e1x + o);
+    __m128 e1y = _mm_loadu_ps(b.e1y + o);
+    __m128 e1z = _mm_loadu_ps(b.e1z + o);
+    __m128 e2x = _mm_loadu_ps(b.e2x + o);
+    __m128 e2y = _mm_loadu_ps(b.e2y + o);
+    __m128 e2z = _mm_loadu_ps(b.e2z + o);
+
+    //n = cross(e1,e2)
+    __m128 nx = _mm_sub_ps(_mm_mul_ps(e1y,e2z),_mm_mul_ps(e2y,e1z));
+    __m128 ny = _mm_sub_ps(_mm_mul_ps(e1z,e2x),_mm_mul_ps(e2z,e1x));
+    __m128 nz = _mm_sub_ps(_mm_mul_ps(e1x,e2y),_mm_mul_ps(e2x,e1y));
+    __m128 dn = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx,nx),_mm_mul_ps(dy,ny)),_mm_mul_ps(dz,nz));
+    __m128 back = _mm_cmpgt_ps(dn,zero);
+
+    //P = cross(dir,e2)
+    __m128 px = _mm_sub_ps(_mm_mul_ps(dy,e2z),_mm_mul_ps(e2y,dz));
+    __m128 py = _mm_sub_ps(_mm_mul_ps(dz,e2x),_mm_mul_ps(e2z,dx));
+    __m128 pz = _mm_sub_ps(_mm_mul_ps(dx,e2y),_mm_mul_ps(e2x,dy));
+    __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x,px),_mm_mul_ps(e1y,py)),_mm_mul_ps(e1z,pz));
+    __m128 mask = _mm_or_ps(_mm_cmple_ps(det,_mm_sub_ps(zero,eps)),_mm_cmpge_ps(det,eps));
+    __m128 invDet = _mm_div_ps(one,det);
+
+    //T = origin - a
+    __m128 tx = _mm_sub_ps(_mm_set1_ps(r.origin.x),_mm_loadu_ps(b.ax + o));
+    __m128 ty = _mm_sub_ps(_mm_set1_ps(r.origin.y),_mm_loadu_ps(b.ay + o));
+    __m128 tz = _mm_sub_ps(_mm_set1_ps(r.origin.z),_mm_loadu_ps(b.az + o));
+
+    __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx,px),_mm_mul_ps(ty,py)),_mm_mul_ps(tz,pz)),invDet);
+    mask = _mm_and_ps(mask,_mm_and_ps(_mm_cmpge_ps(u,zero),_mm_cmple_ps(u,one)));
+
+    //Q = cross(T,e1)
+    __m128 qx = _mm_sub_ps(_mm_mul_ps(ty,e1z),_mm_mul_ps(e1y,tz));
+    __m128 qy = _mm_sub_ps(_mm_mul_ps(tz,e1x),_mm_mul_ps(e1z,tx));
+    __m128 qz = _mm_sub_ps(_mm_mul_ps(tx,e1y),_mm_mul_ps(e1x,ty));
+
+    __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx,qx),_mm_mul_ps(dy,qy)),_mm_mul_ps(dz,qz)),invDet);
+    mask = _mm_and_ps(mask,_mm_and_ps(_mm_cmpge_ps(v,zero),_mm_cmple_ps(_mm_add_ps(u,v),one)));
+
+    __m128 dist = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x,qx),_mm_mul_ps(e2y,qy)),_mm_mul_ps(e2z,qz)),invDet);
+    mask = _mm_and_ps(mask,_mm_cmpgt_ps(dist,eps));
+
+    _mm_storeu_ps(t + o,dist);
+    backMask |= _mm_movemask_ps(back) << o;
+    return _mm_movemask_ps(mask) << o;
+}
+
+#endif
+
+int TriangleBVH::intersectBlock(const TriangleBlock &b, const Ray &r, float *t, int &backMask)
+{
+#if defined(SAIGA_HAS_AVX)
+    return intersectBlockAVX(b,r,t,backMask);
+#elif defined(SAIGA_HAS_SSE2)
+    backMask = 0;
+    int hits = intersectBlockSSE(b,0,r,t,backMask);
+    if(b.count > 4)
+        hits |= intersectBlockSSE(b,4,r,t,backMask);
+    return hits;
+#else
+    backMask = 0;
+    int hits = 0;
+    for(int i = 0 ; i < b.count ; ++i){
+        vec3 e1(b.e1x[i],b.e1y[i],b.e1z[i]);
+        vec3 e2(b.e2x[i],b.e2y[i],b.e2z[i]);
+
+        vec3 n = glm::cross(e1,e2);
+        bool back = glm::dot(r.direction,n) > 0;
+
+        vec3 P = glm::cross(r.direction,e2);
+        float det = glm::dot(e1,P);
+        if(det > -BVH_EPSILON && det < BVH_EPSILON) continue;
+        float invDet = 1.f / det;
+
+        vec3 T = r.origin - vec3(b.ax[i],b.ay[i],b.az[i]);
+        float u = glm::dot(T,P) * invDet;
+        if(u < 0.f || u > 1.f) continue;
+
+        vec3 Q = glm::cross(T,e1);
+        float v = glm::dot(r.direction,Q) * invDet;
+        if(v < 0.f || u + v > 1.f) continue;
+
+        float d = glm::dot(e2,Q) * invDet;
+        if(d > BVH_EPSILON){
+            t[i] = d;
+            hits |= 1 << i;
+            backMask |= int(back) << i;
+        }
+    }
+    return hits;
+#endif
+}
+
+bool TriangleBVH::getClosest(const Ray &r, unsigned int &triangle, float &distance, bool &back) const
+{
+    distance = std::numeric_limits<float>::infinity();
+
+    if(nodes.empty())
+        return false;
+
+    float t;
+    if(!r.intersectAabb(nodes[0].box,t))
+        return false;
+
+    //stack of (node,distance to the node's bounding box)
+    std::pair<int,float> stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = std::make_pair(0,t);
+
+    bool found = false;
+
+    while(stackSize > 0){
+        std::pair<int,float> current = stack[--stackSize];
+        //a closer triangle was found after this node was pushed
+        if(current.second > distance)
+            continue;
+
+        const Node& node = nodes[current.first];
+
+        if(node.isLeaf()){
+            for(int b = node.block ; b < node.block + node.blockCount() ; ++b){
+                const TriangleBlock& block = blocks[b];
+                float d[TriangleBlock::size];
+                int backMask;
+                int hits = intersectBlock(block,r,d,backMask);
+                for(int i = 0 ; i < block.count ; ++i){
+                    //on equal distance prefer the smaller index, like a linear search would
+                    if((hits & (1 << i)) && (d[i] < distance || (d[i] == distance && block.id[i] < triangle))){
+                        distance = d[i];
+                        triangle = block.id[i];
+                        back = (backMask & (1 << i)) != 0;
+                        found = true;
+                    }
+                }
+            }
+        }else{
+            float tl, tr;
+            bool hitLeft = r.intersectAabb(nodes[node.left].box,tl) && tl <= distance;
+            bool hitRight = r.intersectAabb(nodes[node.right].box,tr) && tr <= distance;
+
+            //push the far node first so the near node is processed next
+            if(hitLeft && hitRight){
+                if(tl < tr){
+                    stack[stackSize++] = std::make_pair(node.right,tr);
+                    stack[stackSize++] = std::make_pair(node.left,tl);
+                }else{
+                    stack[stackSize++] = std::make_pair(node.left,tl);
+                    stack[stackSize++] = std::make_pair(node.right,tr);
+                }
+            }else if(hitLeft){
+                stack[stackSize++] = std::make_pair(node.left,tl);
+            }else if(hitRight){
+                stack[stackSize++] = std::make_pair(node.right,tr);
+            }
+        }
+    }
+
+    return found;
+}
+
+int TriangleBVH::depth() const
+{
+    return nodes.empty() ? 0 : depth(0);
+}
+
+int TriangleBVH::depth(int node) const
+{
+    const Node& n = nodes[node];
+    if(n.isLeaf())
+        return 1;
+    return 1 + std::max(depth(n.left),depth(n.right));
+}
+
+}
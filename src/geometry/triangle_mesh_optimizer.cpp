@@ -0,0 +1,211 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/geometry/triangle_mesh_optimizer.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace Saiga {
+
+std::ostream& operator<<(std::ostream& os, const VertexCacheStatistics& s){
+    os << "ACMR: " << s.acmr() << " ATVR: " << s.atvr() << " (cache size " << s.cacheSize << ", "
+       << s.triangles << " triangles, " << s.transformedVertices << " transformed vertices)";
+    return os;
+}
+
+VertexCacheStatistics simulateVertexCache(const uint32_t *indices, int numIndices, int numVertices, int cacheSize)
+{
+    VertexCacheStatistics s;
+    s.cacheSize = cacheSize;
+    s.triangles = numIndices / 3;
+
+    //a vertex is in the cache if less than 'cacheSize' vertices were transformed after it
+    std::vector<int> timestamp(numVertices,-1);
+    for(int i = 0 ; i < numIndices ; ++i){
+        uint32_t v = indices[i];
+        SAIGA_ASSERT((int)v < numVertices);
+        if(timestamp[v] < 0)
+            s.vertices++;
+        if(timestamp[v] < 0 || s.transformedVertices - timestamp[v] >= cacheSize){
+            timestamp[v] = s.transformedVertices;
+            s.transformedVertices++;
+        }
+    }
+    return s;
+}
+
+
+//Parameters from the paper
+static const int maxCacheSize = 32;
+static const float cacheDecayPower = 1.5f;
+static const float lastTriScore = 0.75f;
+static const float valenceBoostScale = 2.0f;
+static const float valenceBoostPower = 0.5f;
+static const int maxValence = 64;
+
+struct ForsythScores{
+    float cache[maxCacheSize];
+    float valence[maxValence];
+
+    ForsythScores(){
+        for(int i = 0 ; i < maxCacheSize ; ++i){
+            if(i < 3){
+                //the vertices of the last triangle are not favored, so the strips don't get too long
+                cache[i] = lastTriScore;
+            }else{
+                float s = 1.0f - float(i - 3) / (maxCacheSize - 3);
+                cache[i] = std::pow(s,cacheDecayPower);
+            }
+        }
+        valence[0] = 0;
+        for(int i = 1 ; i < maxValence ; ++i){
+            valence[i] = valenceBoostScale * std::pow(float(i),-valenceBoostPower);
+        }
+    }
+
+    float score(int cachePosition, int remainingTriangles) const{
+        if(remainingTriangles == 0)
+            return -1;
+        float s = cachePosition >= 0 ? cache[cachePosition] : 0;
+        return s + valence[std::min(remainingTriangles,maxValence - 1)];
+    }
+};
+
+void optimizeVertexCache(const uint32_t *indices, int numIndices, int numVertices, uint32_t *out)
+{
+    SAIGA_ASSERT(indices != out);
+    static const ForsythScores scores;
+
+    int numTriangles = numIndices / 3;
+
+    //triangles of every vertex in CSR layout. The not emitted triangles of vertex v are at
+    //adjacency[adjacencyStart[v]] ... adjacency[adjacencyStart[v] + remaining[v] - 1]
+    std::vector<int> remaining(numVertices,0);
+    for(int i = 0 ; i < numTriangles * 3 ; ++i){
+        remaining[indices[i]]++;
+    }
+    std::vector<int> adjacencyStart(numVertices + 1,0);
+    for(int v = 0 ; v < numVertices ; ++v){
+        adjacencyStart[v + 1] = adjacencyStart[v] + remaining[v];
+    }
+    std::vector<int> adjacency(numTriangles * 3);
+    {
+        std::vector<int> fill(adjacencyStart.begin(),adjacencyStart.end() - 1);
+        for(int i = 0 ; i < numTriangles * 3 ; ++i){
+            adjacency[fill[indices[i]]++] = i / 3;
+        }
+    }
+
+    std::vector<int> cachePosition(numVertices,-1);
+    std::vector<float> vertexScore(numVertices);
+    for(int v = 0 ; v < numVertices ; ++v){
+        vertexScore[v] = scores.score(-1,remaining[v]);
+    }
+
+    std::vector<char> emitted(numTriangles,0);
+    int best = -1;
+    float bestScore = -1;
+    for(int t = 0 ; t < numTriangles ; ++t){
+        const uint32_t* tri = indices + t * 3;
+        float s = vertexScore[tri[0]] + vertexScore[tri[1]] + vertexScore[tri[2]];
+        if(s > bestScore){
+            bestScore = s;
+            best = t;
+        }
+    }
+
+    //the 3 extra entries hold the vertices that are pushed out by the current triangle
+    int cache[maxCacheSize + 3];
+    int cacheSize = 0;
+    int newCache[maxCacheSize + 3];
+
+    //scan position for the next triangle when nothing in the cache has triangles left
+    int cursor = 0;
+
+    for(int outTri = 0 ; outTri < numTriangles ; ++outTri){
+        if(best < 0){
+            while(emitted[cursor])
+                cursor++;
+            best = cursor;
+        }
+
+        const uint32_t* tri = indices + best * 3;
+        out[outTri * 3 + 0] = tri[0];
+        out[outTri * 3 + 1] = tri[1];
+        out[outTri * 3 + 2] = tri[2];
+        emitted[best] = 1;
+
+        //remove the triangle from the adjacency of its vertices
+        int newCacheSize = 0;
+        for(int k = 0 ; k < 3 ; ++k){
+            int v = tri[k];
+            int* adj = adjacency.data() + adjacencyStart[v];
+            int last = remaining[v] - 1;
+            for(int j = 0 ; j <= last ; ++j){
+                if(adj[j] == best){
+                    std::swap(adj[j],adj[last]);
+                    break;
+                }
+            }
+            remaining[v]--;
+            newCache[newCacheSize++] = v;
+        }
+
+        //LRU: the triangle's vertices move to the front
+        for(int i = 0 ; i < cacheSize ; ++i){
+            int v = cache[i];
+            if(v != (int)tri[0] && v != (int)tri[1] && v != (int)tri[2])
+                newCache[newCacheSize++] = v;
+        }
+
+        for(int i = 0 ; i < newCacheSize ; ++i){
+            int v = newCache[i];
+            cachePosition[v] = i < maxCacheSize ? i : -1;
+            vertexScore[v] = scores.score(cachePosition[v],remaining[v]);
+        }
+
+        //only triangles of vertices in the cache change their score
+        best = -1;
+        bestScore = -1;
+        for(int i = 0 ; i < newCacheSize ; ++i){
+            int v = newCache[i];
+            const int* adj = adjacency.data() + adjacencyStart[v];
+            for(int j = 0 ; j < remaining[v] ; ++j){
+                int t = adj[j];
+                const uint32_t* ot = indices + t * 3;
+                float s = vertexScore[ot[0]] + vertexScore[ot[1]] + vertexScore[ot[2]];
+                if(s > bestScore){
+                    bestScore = s;
+                    best = t;
+                }
+            }
+        }
+
+        cacheSize = std::min(newCacheSize,maxCacheSize);
+        std::copy(newCache,newCache + cacheSize,cache);
+    }
+}
+
+std::vector<uint32_t> optimizeVertexFetch(uint32_t *indices, int numIndices, int numVertices)
+{
+    const uint32_t unused = ~0u;
+    std::vector<uint32_t> remap(numVertices,unused);
+    uint32_t next = 0;
+    for(int i = 0 ; i < numIndices ; ++i){
+        uint32_t& r = remap[indices[i]];
+        if(r == unused)
+            r = next++;
+        indices[i] = r;
+    }
+    for(int v = 0 ; v < numVertices ; ++v){
+        if(remap[v] == unused)
+            remap[v] = next++;
+    }
+    return remap;
+}
+
+}
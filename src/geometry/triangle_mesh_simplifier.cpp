@@ -0,0 +1,310 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/geometry/triangle_mesh_simplifier.h"
+
+#include <algorithm>
+
+namespace Saiga {
+
+namespace {
+
+//Symmetric 4x4 matrix
+struct Quadric{
+    double a2 = 0, ab = 0, ac = 0, ad = 0;
+    double b2 = 0, bc = 0, bd = 0;
+    double c2 = 0, cd = 0;
+    double d2 = 0;
+
+    //squared distance to the plane ax + by + cz + d = 0
+    void addPlane(double a, double b, double c, double d, double w){
+        a2 += w * a * a; ab += w * a * b; ac += w * a * c; ad += w * a * d;
+        b2 += w * b * b; bc += w * b * c; bd += w * b * d;
+        c2 += w * c * c; cd += w * c * d;
+        d2 += w * d * d;
+    }
+
+    void operator+=(const Quadric& q){
+        a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+        b2 += q.b2; bc += q.bc; bd += q.bd;
+        c2 += q.c2; cd += q.cd;
+        d2 += q.d2;
+    }
+
+    double error(const vec3& p) const{
+        double x = p.x, y = p.y, z = p.z;
+        double e = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+                + b2 * y * y + 2 * bc * y * z + 2 * bd * y
+                + c2 * z * z + 2 * cd * z
+                + d2;
+        return std::max(e,0.0);
+    }
+
+    double error(const Quadric& other, const vec3& p) const{
+        Quadric q = *this;
+        q += other;
+        return q.error(p);
+    }
+};
+
+enum VertexKind : uint8_t{
+    INTERIOR,
+    BORDER,
+    //part of a non manifold edge
+    LOCKED
+};
+
+//Lock state of a vertex in one pass
+enum CollapseLock : uint8_t{
+    UNLOCKED = 0,
+    //can not be removed, but other vertices can collapse into it
+    LOCKED_REMOVE,
+    LOCKED_BOTH
+};
+
+struct Collapse{
+    uint32_t from, to;
+    float cost;
+    //number of faces adjacent to the edge
+    int faces;
+
+    bool operator<(const Collapse& o) const { return cost < o.cost; }
+};
+
+//Vertex to face adjacency of the current index buffer
+struct Adjacency{
+    std::vector<int> start;
+    std::vector<int> faces;
+
+    void build(const std::vector<uint32_t>& indices, int numVertices){
+        start.assign(numVertices + 1,0);
+        for(uint32_t i : indices)
+            start[i + 1]++;
+        for(int v = 0 ; v < numVertices ; ++v)
+            start[v + 1] += start[v];
+        faces.resize(indices.size());
+        std::vector<int> fill(start.begin(),start.end() - 1);
+        for(int i = 0 ; i < (int)indices.size() ; ++i)
+            faces[fill[indices[i]]++] = i / 3;
+    }
+
+    const int* begin(int v) const { return faces.data() + start[v]; }
+    const int* end(int v) const { return faces.data() + start[v + 1]; }
+};
+
+//All neighbour vertices of v with duplicates (every edge appears once per adjacent face)
+static void neighbours(const Adjacency& adj, const std::vector<uint32_t>& indices, uint32_t v, std::vector<uint32_t>& out){
+    out.clear();
+    for(const int* f = adj.begin(v) ; f != adj.end(v) ; ++f){
+        for(int k = 0 ; k < 3 ; ++k){
+            uint32_t w = indices[*f * 3 + k];
+            if(w != v)
+                out.push_back(w);
+        }
+    }
+    std::sort(out.begin(),out.end());
+}
+
+static vec3 faceNormal(const vec3& a, const vec3& b, const vec3& c){
+    return glm::cross(b - a,c - a);
+}
+
+//Moving 'from' to 'to' must not flip or degenerate the faces of 'from' that don't contain 'to'.
+static bool flips(const vec3* positions, const Adjacency& adj, const std::vector<uint32_t>& indices, uint32_t from, uint32_t to){
+    for(const int* f = adj.begin(from) ; f != adj.end(from) ; ++f){
+        const uint32_t* tri = indices.data() + *f * 3;
+        if(tri[0] == to || tri[1] == to || tri[2] == to)
+            continue;
+        vec3 p[3], q[3];
+        for(int k = 0 ; k < 3 ; ++k){
+            p[k] = positions[tri[k]];
+            q[k] = tri[k] == from ? positions[to] : p[k];
+        }
+        vec3 n0 = faceNormal(p[0],p[1],p[2]);
+        vec3 n1 = faceNormal(q[0],q[1],q[2]);
+        float l = glm::length(n0) * glm::length(n1);
+        if(glm::dot(n0,n1) <= 0.25f * l || l == 0)
+            return true;
+    }
+    return false;
+}
+
+}
+
+void simplifyMesh(const vec3 *positions, int numVertices, const uint32_t *indices, int numIndices,
+                  const std::vector<int> &targetTriangles, std::vector<std::vector<uint32_t>> &lods, std::vector<float> *errors)
+{
+    lods.clear();
+    if(errors)
+        errors->clear();
+
+    std::vector<uint32_t> current(indices,indices + numIndices);
+
+    std::vector<Quadric> quadrics(numVertices);
+    for(int i = 0 ; i < numIndices ; i += 3){
+        vec3 a = positions[indices[i]], b = positions[indices[i + 1]], c = positions[indices[i + 2]];
+        vec3 n = faceNormal(a,b,c);
+        float l = glm::length(n);
+        if(l == 0)
+            continue;
+        n /= l;
+        double d = -glm::dot(n,a);
+        for(int k = 0 ; k < 3 ; ++k)
+            quadrics[indices[i + k]].addPlane(n.x,n.y,n.z,d,1);
+    }
+
+    Adjacency adj;
+    std::vector<uint8_t> kind(numVertices);
+    std::vector<uint8_t> locked(numVertices);
+    std::vector<uint32_t> remap(numVertices);
+    std::vector<Collapse> collapses;
+    std::vector<uint32_t> nFrom, nTo, common;
+    double maxError = 0;
+    bool borderQuadrics = false;
+
+    for(int target : targetTriangles){
+        while((int)current.size() / 3 > target){
+            adj.build(current,numVertices);
+
+            //classify the vertices and collect the edges (once per direction with from < to)
+            collapses.clear();
+            for(int v = 0 ; v < numVertices ; ++v){
+                neighbours(adj,current,v,nFrom);
+                kind[v] = INTERIOR;
+                for(int i = 0 ; i < (int)nFrom.size() ; ){
+                    int j = i;
+                    while(j < (int)nFrom.size() && nFrom[j] == nFrom[i])
+                        ++j;
+                    int count = j - i;
+                    if(count == 1 && kind[v] == INTERIOR)
+                        kind[v] = BORDER;
+                    if(count > 2)
+                        kind[v] = LOCKED;
+                    if((uint32_t)v < nFrom[i]){
+                        Collapse c;
+                        c.from = v;
+                        c.to = nFrom[i];
+                        c.faces = count;
+                        collapses.push_back(c);
+                    }
+                    i = j;
+                }
+            }
+
+            //the border planes are added once, so the border is kept in place
+            if(!borderQuadrics){
+                borderQuadrics = true;
+                for(int i = 0 ; i < (int)current.size() ; i += 3){
+                    for(int k = 0 ; k < 3 ; ++k){
+                        uint32_t a = current[i + k], b = current[i + (k + 1) % 3];
+                        if(kind[a] == INTERIOR || kind[b] == INTERIOR)
+                            continue;
+                        //check if ab is a border edge
+                        int count = 0;
+                        for(const int* f = adj.begin(a) ; f != adj.end(a) ; ++f){
+                            const uint32_t* tri = current.data() + *f * 3;
+                            count += tri[0] == b || tri[1] == b || tri[2] == b;
+                        }
+                        if(count != 1)
+                            continue;
+                        vec3 pa = positions[a], pb = positions[b];
+                        vec3 n = glm::cross(faceNormal(pa,pb,positions[current[i + (k + 2) % 3]]),pb - pa);
+                        float l = glm::length(n);
+                        if(l == 0)
+                            continue;
+                        n /= l;
+                        double d = -glm::dot(n,pa);
+                        quadrics[a].addPlane(n.x,n.y,n.z,d,10);
+                        quadrics[b].addPlane(n.x,n.y,n.z,d,10);
+                    }
+                }
+            }
+
+            //cost and direction of each edge
+            int valid = 0;
+            for(Collapse c : collapses){
+                bool forward = kind[c.from] == INTERIOR || (kind[c.from] == BORDER && kind[c.to] != INTERIOR && c.faces == 1);
+                bool backward = kind[c.to] == INTERIOR || (kind[c.to] == BORDER && kind[c.from] != INTERIOR && c.faces == 1);
+                if(!forward && !backward)
+                    continue;
+                double ef = forward ? quadrics[c.from].error(quadrics[c.to],positions[c.to]) : 1e300;
+                double eb = backward ? quadrics[c.from].error(quadrics[c.to],positions[c.from]) : 1e300;
+                if(eb < ef){
+                    std::swap(c.from,c.to);
+                    ef = eb;
+                }
+                c.cost = ef;
+                collapses[valid++] = c;
+            }
+            collapses.resize(valid);
+            //most edges are locked by a cheaper collapse anyway, so only the cheapest quarter is used in this pass
+            int candidates = std::min(valid,std::max(valid / 4,1024));
+            std::nth_element(collapses.begin(),collapses.begin() + candidates,collapses.end());
+            collapses.resize(candidates);
+            std::sort(collapses.begin(),collapses.end());
+
+            //collapse independent edges. The faces of 'from' and the neighbours of 'to' must not change
+            //for the rest of the pass: the 1-ring of 'from' is locked, and the 1-ring of 'to' can only be the target of a collapse.
+            std::fill(locked.begin(),locked.end(),0);
+            for(int v = 0 ; v < numVertices ; ++v)
+                remap[v] = v;
+            int triangles = current.size() / 3;
+            int collapsed = 0;
+            for(const Collapse& c : collapses){
+                if(triangles <= target)
+                    break;
+                if(locked[c.from] || locked[c.to] == LOCKED_BOTH)
+                    continue;
+
+                //link condition: the only common neighbours are the opposite vertices of the edge faces
+                neighbours(adj,current,c.from,nFrom);
+                neighbours(adj,current,c.to,nTo);
+                nFrom.erase(std::unique(nFrom.begin(),nFrom.end()),nFrom.end());
+                nTo.erase(std::unique(nTo.begin(),nTo.end()),nTo.end());
+                common.clear();
+                std::set_intersection(nFrom.begin(),nFrom.end(),nTo.begin(),nTo.end(),std::back_inserter(common));
+                if((int)common.size() != c.faces)
+                    continue;
+
+                if(flips(positions,adj,current,c.from,c.to))
+                    continue;
+
+                remap[c.from] = c.to;
+                quadrics[c.to] += quadrics[c.from];
+                maxError = std::max(maxError,(double)c.cost);
+                triangles -= c.faces;
+                collapsed++;
+
+                for(uint32_t w : nTo)
+                    locked[w] = std::max(locked[w],(uint8_t)LOCKED_REMOVE);
+                for(uint32_t w : nFrom)
+                    locked[w] = LOCKED_BOTH;
+                locked[c.from] = locked[c.to] = LOCKED_BOTH;
+            }
+
+            if(collapsed == 0)
+                break;
+
+            //apply the collapses and remove the degenerate faces
+            int out = 0;
+            for(int i = 0 ; i < (int)current.size() ; i += 3){
+                uint32_t a = remap[current[i]], b = remap[current[i + 1]], c = remap[current[i + 2]];
+                if(a == b || a == c || b == c)
+                    continue;
+                current[out++] = a;
+                current[out++] = b;
+                current[out++] = c;
+            }
+            current.resize(out);
+        }
+
+        lods.push_back(current);
+        if(errors)
+            errors->push_back(std::sqrt(maxError));
+    }
+}
+
+}
@@ -0,0 +1,173 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/geometry/vertexQuantization.h"
+
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+namespace Saiga {
+
+static inline vec2 signNotZero(const vec2& v){
+    return vec2(v.x >= 0 ? 1.0f : -1.0f, v.y >= 0 ? 1.0f : -1.0f);
+}
+
+vec2 encodeOctahedral(const vec3 &n)
+{
+    float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    //zero length (or NaN) normals are encoded as (0,0,1)
+    if(!(l1 > 0))
+        return vec2(0);
+    vec2 e(n.x / l1, n.y / l1);
+    if(n.z < 0){
+        vec2 s = signNotZero(e);
+        e = vec2((1 - std::abs(e.y)) * s.x, (1 - std::abs(e.x)) * s.y);
+    }
+    return e;
+}
+
+vec3 decodeOctahedral(const vec2 &e)
+{
+    vec3 v(e.x, e.y, 1 - std::abs(e.x) - std::abs(e.y));
+    if(v.z < 0){
+        vec2 s = signNotZero(vec2(v.x,v.y));
+        float x = (1 - std::abs(v.y)) * s.x;
+        float y = (1 - std::abs(v.x)) * s.y;
+        v.x = x;
+        v.y = y;
+    }
+    return glm::normalize(v);
+}
+
+//Based on "float_to_half_fast3_rtne" and "half_to_float_fast5" by Fabian Giesen:
+//https://gist.github.com/rygorous/2156668
+uint16_t floatToHalf(float f)
+{
+    const uint32_t f32infty = 255u << 23;
+    const uint32_t f16max = (127u + 16) << 23;
+    const uint32_t denormMagicBits = ((127u - 15) + (23 - 10) + 1) << 23;
+
+    uint32_t u;
+    std::memcpy(&u,&f,4);
+    uint32_t sign = u & 0x80000000u;
+    u ^= sign;
+
+    uint16_t h;
+    if(u >= f16max){
+        //Inf or NaN
+        h = u > f32infty ? 0x7e00 : 0x7c00;
+    }else if(u < (113u << 23)){
+        //the result is a denormal or zero: let the fpu do the rounding
+        float denormMagic, v;
+        std::memcpy(&denormMagic,&denormMagicBits,4);
+        std::memcpy(&v,&u,4);
+        v += denormMagic;
+        std::memcpy(&u,&v,4);
+        h = u - denormMagicBits;
+    }else{
+        uint32_t mantOdd = (u >> 13) & 1;
+        //rebias the exponent and round to nearest even
+        u += ((uint32_t)(15 - 127) << 23) + 0xfff;
+        u += mantOdd;
+        h = u >> 13;
+    }
+    return h | (sign >> 16);
+}
+
+float halfToFloat(uint16_t h)
+{
+    const uint32_t shiftedExp = 0x7c00u << 13;
+    const uint32_t magicBits = 113u << 23;
+
+    uint32_t u = (h & 0x7fffu) << 13;
+    uint32_t exp = shiftedExp & u;
+    u += (127u - 15) << 23;
+
+    float f;
+    if(exp == shiftedExp){
+        //Inf or NaN
+        u += (128u - 16) << 23;
+        std::memcpy(&f,&u,4);
+    }else if(exp == 0){
+        //zero or denormal
+        float magic;
+        std::memcpy(&magic,&magicBits,4);
+        u += 1u << 23;
+        std::memcpy(&f,&u,4);
+        f -= magic;
+    }else{
+        std::memcpy(&f,&u,4);
+    }
+    return (h & 0x8000) ? -f : f;
+}
+
+static inline int16_t toSnorm16(float f){
+    f = std::min(std::max(f,-1.0f),1.0f);
+    return (int16_t)std::lround(f * 32767.0f);
+}
+
+static inline float fromSnorm16(int16_t s){
+    //same as OpenGL
+    return std::max(s / 32767.0f,-1.0f);
+}
+
+
+VertexQuantizer::VertexQuantizer(const AABB &box) : box(box)
+{
+    size = box.max - box.min;
+    //flat meshes have a zero extend in one dimension
+    for(int i = 0 ; i < 3 ; ++i){
+        size[i] = std::max(size[i],1e-10f);
+        invStep[i] = 65535.0f / size[i];
+    }
+}
+
+void VertexQuantizer::quantize(const VertexN &in, VertexNQ &out) const
+{
+    for(int i = 0 ; i < 3 ; ++i){
+        float q = (in.position[i] - box.min[i]) * invStep[i];
+        q = std::min(std::max(q,0.0f),65535.0f);
+        out.position[i] = (uint16_t)(q + 0.5f);
+    }
+    out.position[3] = 65535;
+
+    vec2 e = encodeOctahedral(vec3(in.normal));
+    out.normal[0] = toSnorm16(e.x);
+    out.normal[1] = toSnorm16(e.y);
+}
+
+void VertexQuantizer::quantize(const VertexN *in, VertexNQ *out, int count) const
+{
+    for(int i = 0 ; i < count ; ++i){
+        quantize(in[i],out[i]);
+    }
+}
+
+void VertexQuantizer::quantize(const VertexNT *in, VertexNTQ *out, int count) const
+{
+    for(int i = 0 ; i < count ; ++i){
+        quantize(in[i],out[i]);
+        out[i].texture[0] = floatToHalf(in[i].texture.x);
+        out[i].texture[1] = floatToHalf(in[i].texture.y);
+    }
+}
+
+VertexN VertexQuantizer::dequantize(const VertexNQ &v) const
+{
+    vec3 p(v.position[0],v.position[1],v.position[2]);
+    p = box.min + p * (size / 65535.0f);
+    vec3 n = decodeOctahedral(vec2(fromSnorm16(v.normal[0]),fromSnorm16(v.normal[1])));
+    return VertexN(p,n);
+}
+
+VertexNT VertexQuantizer::dequantize(const VertexNTQ &v) const
+{
+    VertexN vn = dequantize(static_cast<const VertexNQ&>(v));
+    return VertexNT(vn.position,vn.normal,vec2(halfToFloat(v.texture[0]),halfToFloat(v.texture[1])));
+}
+
+}
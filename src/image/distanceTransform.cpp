@@ -0,0 +1,149 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/image/distanceTransform.h"
+#include "saiga/util/assert.h"
+
+#include <vector>
+#include <cmath>
+
+namespace Saiga {
+namespace DistanceTransform {
+
+void squaredDistance1D(const float *f, float *d, int n, int stride, int *v, float *z)
+{
+    if(n <= 0)
+        return;
+
+    //the parabolas of the lower envelope are v[0..k], parabola v[i] is the minimum in [z[i],z[i+1]]
+    int k = 0;
+    v[0] = 0;
+    z[0] = -infinity;
+    z[1] = infinity;
+    for(int q = 1 ; q < n ; ++q){
+        float fq = f[q * stride] + float(q) * float(q);
+        float s;
+        while(true){
+            int p = v[k];
+            //intersection of the parabolas of q and p
+            s = (fq - (f[p * stride] + float(p) * float(p))) / float(2 * q - 2 * p);
+            if(s > z[k])
+                break;
+            k--;
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = infinity;
+    }
+
+    k = 0;
+    for(int q = 0 ; q < n ; ++q){
+        while(z[k + 1] < q)
+            k++;
+        float dq = float(q - v[k]);
+        d[q * stride] = dq * dq + f[v[k] * stride];
+    }
+}
+
+void squaredDistance(float *data, int width, int height)
+{
+    int n = std::max(width,height);
+    std::vector<float> f(n), z(n + 1);
+    std::vector<int> v(n);
+
+    for(int y = 0 ; y < height ; ++y){
+        float* row = data + y * width;
+        std::copy(row,row + width,f.begin());
+        squaredDistance1D(f.data(),row,width,1,v.data(),z.data());
+    }
+    for(int x = 0 ; x < width ; ++x){
+        for(int y = 0 ; y < height ; ++y)
+            f[y] = data[y * width + x];
+        squaredDistance1D(f.data(),data + x,height,width,v.data(),z.data());
+    }
+}
+
+void bitmapToSDF(Image &bitmap, Image &sdf, int divisor, int searchRadius)
+{
+    SAIGA_ASSERT(divisor % 2 == 1);
+    int halfDivisor = divisor / 2;
+    int w = bitmap.width;
+    int h = bitmap.height;
+
+    sdf.width = w / divisor;
+    sdf.height = h / divisor;
+    sdf.Format() = bitmap.Format();
+    sdf.create();
+    sdf.makeZero();
+    if(sdf.width == 0 || sdf.height == 0)
+        return;
+
+    //inside: distance of the non zero pixels to the nearest zero pixel
+    //outside: distance of the zero pixels to the nearest non zero pixel
+    std::vector<float> inside(w * h), outside(w * h);
+    int n = std::max(w,h);
+    std::vector<float> f(n), z(n + 1), insideColumn(h), outsideColumn(h);
+    std::vector<int> v(n);
+
+    //first pass on all rows
+    for(int y = 0 ; y < h ; ++y){
+        const unsigned char* src = reinterpret_cast<const unsigned char*>(bitmap.positionPtr(0,y));
+        float* in = inside.data() + y * w;
+        float* out = outside.data() + y * w;
+        int count = 0;
+        for(int x = 0 ; x < w ; ++x){
+            bool set = src[x] != 0;
+            in[x] = set ? infinity : 0;
+            out[x] = set ? 0 : infinity;
+            count += set;
+        }
+        //rows without a zero or without a non zero pixel do not change (for example the padding of glyphs)
+        if(count != 0 && count != w){
+            std::copy(in,in + w,f.begin());
+            squaredDistance1D(f.data(),in,w,1,v.data(),z.data());
+            std::copy(out,out + w,f.begin());
+            squaredDistance1D(f.data(),out,w,1,v.data(),z.data());
+        }
+    }
+
+    //second pass only on the columns of the samples
+    for(int x = 0 ; x < sdf.width ; ++x){
+        int bx = x * divisor + halfDivisor;
+        for(int y = 0 ; y < h ; ++y){
+            f[y] = inside[y * w + bx];
+        }
+        squaredDistance1D(f.data(),insideColumn.data(),h,1,v.data(),z.data());
+        for(int y = 0 ; y < h ; ++y){
+            f[y] = outside[y * w + bx];
+        }
+        squaredDistance1D(f.data(),outsideColumn.data(),h,1,v.data(),z.data());
+
+        for(int y = 0 ; y < sdf.height ; ++y){
+            int by = y * divisor + halfDivisor;
+            bool current = outside[by * w + bx] == 0;
+            float d = std::sqrt(current ? insideColumn[by] : outsideColumn[by]);
+
+            //map to 0-1
+            d = d / (float)searchRadius;
+            d = std::min(std::max(d,0.0f),1.0f);
+            d = d * 0.5f;
+
+            //set 0.5 to border and >0.5 to inside and <0.5 to outside
+            if(current){
+                d = d + 0.5f;
+            }else{
+                d = 0.5f - d;
+            }
+
+            unsigned char out = d * 255.0f;
+            sdf.setPixel(x,y,out);
+        }
+    }
+}
+
+}
+}
@@ -0,0 +1,374 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/image/imageResampler.h"
+#include "saiga/util/assert.h"
+#include "saiga/util/simd.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace Saiga {
+namespace ImageResampler {
+
+static const double PI = 3.14159265358979323846;
+
+//Tile size in pixels of the first level for the single pass box mip chain.
+#define MIP_TILE_SIZE 64
+//Number of destination rows that are processed together by the resampler.
+#define RESAMPLE_BAND_HEIGHT 16
+#define RESAMPLE_MAX_ROWS 64
+
+static double sinc(double x){
+    if(std::abs(x) < 1e-8)
+        return 1.0;
+    x *= PI;
+    return std::sin(x) / x;
+}
+
+//modified bessel function of the first kind (order 0)
+static double besselI0(double x){
+    double sum = 1, term = 1;
+    double q = x * x / 4;
+    for(int k = 1 ; k < 50 ; ++k){
+        term *= q / (k * k);
+        sum += term;
+        if(term < sum * 1e-12)
+            break;
+    }
+    return sum;
+}
+
+static double filterSupport(ResampleFilter filter){
+    switch(filter){
+    case ResampleFilter::Box: return 0.5;
+    case ResampleFilter::Bilinear: return 1;
+    case ResampleFilter::Lanczos: return 3;
+    case ResampleFilter::Kaiser: return 3;
+    }
+    return 1;
+}
+
+static double filterWeight(ResampleFilter filter, double x){
+    switch(filter){
+    case ResampleFilter::Box:
+        return (x >= -0.5 && x < 0.5) ? 1 : 0;
+    case ResampleFilter::Bilinear:
+        return std::max(0.0, 1 - std::abs(x));
+    case ResampleFilter::Lanczos:
+        return std::abs(x) < 3 ? sinc(x) * sinc(x / 3) : 0;
+    case ResampleFilter::Kaiser:{
+        const double width = 3, alpha = 4;
+        double t = x / width;
+        if(std::abs(t) >= 1)
+            return 0;
+        return sinc(x) * besselI0(alpha * std::sqrt(1 - t * t)) / besselI0(alpha);
+    }
+    }
+    return 0;
+}
+
+
+//The filter weights of all destination pixels in one dimension.
+//The taps of pixel i are the source pixels [start[i],start[i]+count[i]) with the weights at i*maxTaps.
+struct FilterWeights{
+    std::vector<int> start, count;
+    std::vector<float> weights;
+    int maxTaps;
+
+    FilterWeights(int srcSize, int dstSize, ResampleFilter filter){
+        double scale = double(srcSize) / dstSize;
+        //when downsampling the filter is stretched over all covered source pixels
+        double filterScale = std::max(1.0, scale);
+        double support = filterSupport(filter) * filterScale;
+
+        maxTaps = int(std::ceil(support * 2)) + 2;
+        start.resize(dstSize);
+        count.resize(dstSize);
+        weights.resize(dstSize * maxTaps, 0);
+
+        std::vector<double> w(maxTaps);
+        for(int i = 0 ; i < dstSize ; ++i){
+            double center = (i + 0.5) * scale;
+            int first = int(std::floor(center - support));
+            int last = int(std::ceil(center + support));
+
+            //clamped taps are merged into the border pixel
+            int s = std::max(0, std::min(first, srcSize - 1));
+            int e = std::max(0, std::min(last, srcSize - 1));
+            SAIGA_ASSERT(e - s + 1 <= maxTaps);
+            std::fill(w.begin(), w.end(), 0.0);
+            double sum = 0;
+            for(int j = first ; j <= last ; ++j){
+                double v = filterWeight(filter, (j + 0.5 - center) / filterScale);
+                int clamped = std::max(0, std::min(j, srcSize - 1));
+                w[clamped - s] += v;
+                sum += v;
+            }
+            if(sum == 0){
+                //can happen for the box filter when upsampling exactly between two pixels
+                int nearest = std::max(0, std::min(int(center), srcSize - 1));
+                w[nearest - s] = 1;
+                sum = 1;
+            }
+
+            //remove zero weights at the ends
+            while(s < e && w[0] == 0){
+                w.erase(w.begin());
+                w.push_back(0);
+                s++;
+            }
+            while(e > s && w[e - s] == 0){
+                e--;
+            }
+
+            start[i] = s;
+            count[i] = e - s + 1;
+            for(int k = 0 ; k < count[i] ; ++k){
+                weights[i * maxTaps + k] = float(w[k] / sum);
+            }
+        }
+    }
+};
+
+//out[x] = sum_k w_k * rows_k[x]
+//with accumulate = true the sum is added to out
+static void weightedRowSum(const float* const* rows, const float* w, int numRows, float* out, int n, bool accumulate){
+    int i = 0;
+#if defined(SAIGA_HAS_SSE2)
+    for(; i + 8 <= n ; i += 8){
+        __m128 a = accumulate ? _mm_loadu_ps(out + i) : _mm_setzero_ps();
+        __m128 b = accumulate ? _mm_loadu_ps(out + i + 4) : _mm_setzero_ps();
+        for(int k = 0 ; k < numRows ; ++k){
+            __m128 wk = _mm_set1_ps(w[k]);
+            a = _mm_add_ps(a,_mm_mul_ps(wk,_mm_loadu_ps(rows[k] + i)));
+            b = _mm_add_ps(b,_mm_mul_ps(wk,_mm_loadu_ps(rows[k] + i + 4)));
+        }
+        _mm_storeu_ps(out + i,a);
+        _mm_storeu_ps(out + i + 4,b);
+    }
+#endif
+    for(; i < n ; ++i){
+        float sum = accumulate ? out[i] : 0;
+        for(int k = 0 ; k < numRows ; ++k){
+            sum += w[k] * rows[k][i];
+        }
+        out[i] = sum;
+    }
+}
+
+static void horizontalRow(const float* src, float* dst, int dstW, int channels, const FilterWeights& fw){
+#if defined(SAIGA_HAS_SSE2)
+    if(channels == 4){
+        //one pixel is one sse register
+        for(int x = 0 ; x < dstW ; ++x){
+            const float* w = &fw.weights[x * fw.maxTaps];
+            const float* s = src + fw.start[x] * 4;
+            __m128 sum = _mm_setzero_ps();
+            for(int k = 0 ; k < fw.count[x] ; ++k){
+                sum = _mm_add_ps(sum,_mm_mul_ps(_mm_set1_ps(w[k]),_mm_loadu_ps(s + k * 4)));
+            }
+            _mm_storeu_ps(dst + x * 4,sum);
+        }
+        return;
+    }
+#endif
+    for(int x = 0 ; x < dstW ; ++x){
+        const float* w = &fw.weights[x * fw.maxTaps];
+        const float* s = src + fw.start[x] * channels;
+        for(int c = 0 ; c < channels ; ++c){
+            float sum = 0;
+            for(int k = 0 ; k < fw.count[x] ; ++k){
+                sum += w[k] * s[k * channels + c];
+            }
+            dst[x * channels + c] = sum;
+        }
+    }
+}
+
+//Per thread scratch memory. Reusing it avoids the page faults of large temporary allocations.
+static float* scratchMemory(size_t size){
+    static thread_local std::vector<float> scratch;
+    if(scratch.size() < size)
+        scratch.resize(size);
+    return scratch.data();
+}
+
+void resample(int srcW, int srcH, const ReadFunction &read, int dstW, int dstH, const WriteFunction &write, int channels, ResampleFilter filter, bool parallel)
+{
+    SAIGA_ASSERT(srcW > 0 && srcH > 0 && dstW > 0 && dstH > 0);
+    FilterWeights fx(srcW,dstW,filter);
+    FilterWeights fy(srcH,dstH,filter);
+
+    //The destination rows are processed in bands. Each band filters the source rows it needs
+    //horizontally into a small buffer, so the intermediate image is never stored completely.
+    int rowSize = dstW * channels;
+    int numBands = (dstH + RESAMPLE_BAND_HEIGHT - 1) / RESAMPLE_BAND_HEIGHT;
+    PixelConversion::forEachRow(numBands,parallel,[&](int band){
+        int y0 = band * RESAMPLE_BAND_HEIGHT;
+        int y1 = std::min(y0 + RESAMPLE_BAND_HEIGHT, dstH);
+        int sy0 = fy.start[y0];
+        int sy1 = sy0;
+        for(int y = y0 ; y < y1 ; ++y){
+            sy1 = std::max(sy1, fy.start[y] + fy.count[y]);
+        }
+
+        int numSrcRows = sy1 - sy0;
+        float* srcRow = scratchMemory(size_t(srcW * channels) + size_t(numSrcRows + 1) * rowSize);
+        float* tmp = srcRow + srcW * channels;
+        float* out = tmp + numSrcRows * rowSize;
+
+        for(int y = sy0 ; y < sy1 ; ++y){
+            read(0, y, srcW, srcRow);
+            horizontalRow(srcRow, tmp + (y - sy0) * rowSize, dstW, channels, fx);
+        }
+
+        const float* rows[RESAMPLE_MAX_ROWS];
+        for(int y = y0 ; y < y1 ; ++y){
+            int n = fy.count[y];
+            const float* w = &fy.weights[y * fy.maxTaps];
+            //very large reductions are done in multiple steps of RESAMPLE_MAX_ROWS rows
+            for(int k = 0 ; k < n ; k += RESAMPLE_MAX_ROWS){
+                int m = std::min(RESAMPLE_MAX_ROWS, n - k);
+                for(int j = 0 ; j < m ; ++j){
+                    rows[j] = tmp + (fy.start[y] + k + j - sy0) * rowSize;
+                }
+                weightedRowSum(rows, w + k, m, out, rowSize, k > 0);
+            }
+            write(0, y, dstW, out);
+        }
+    });
+}
+
+void resample(const float *src, int srcW, int srcH, float *dst, int dstW, int dstH, int channels, ResampleFilter filter, bool parallel)
+{
+    resample(srcW, srcH, [=](int x, int y, int n, float* out){
+        memcpy(out, src + (y * srcW + x) * channels, n * channels * sizeof(float));
+    }, dstW, dstH, [=](int x, int y, int n, float* data){
+        memcpy(dst + (y * dstW + x) * channels, data, n * channels * sizeof(float));
+    }, channels, filter, parallel);
+}
+
+int mipLevelCount(int width, int height)
+{
+    int levels = 1;
+    while(width > 1 || height > 1){
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+        levels++;
+    }
+    return levels;
+}
+
+//2x2 box reduction of a square tile with tightly packed rows. Computed like the
+//separable resampler (first horizontal then vertical), so the results are identical.
+static void boxReduce(const float* src, float* dst, int dstSize, int channels){
+    int srcRow = 2 * dstSize * channels;
+    for(int y = 0 ; y < dstSize ; ++y){
+        const float* r0 = src + (2 * y) * srcRow;
+        const float* r1 = r0 + srcRow;
+        float* out = dst + y * dstSize * channels;
+        for(int x = 0 ; x < dstSize ; ++x){
+            for(int c = 0 ; c < channels ; ++c){
+                int i = 2 * x * channels + c;
+                float a = 0.5f * r0[i] + 0.5f * r0[i + channels];
+                float b = 0.5f * r1[i] + 0.5f * r1[i + channels];
+                out[x * channels + c] = 0.5f * a + 0.5f * b;
+            }
+        }
+    }
+}
+
+void generateMipChain(int width, int height, const ReadFunction &read, const MipWriteFunction &write, int channels, ResampleFilter filter, bool parallel)
+{
+    int numLevels = mipLevelCount(width,height);
+    std::vector<int> ws(numLevels), hs(numLevels);
+    for(int i = 0 ; i < numLevels ; ++i){
+        ws[i] = std::max(1, width >> i);
+        hs[i] = std::max(1, height >> i);
+    }
+
+    //the last computed level as float, the next one is computed from it
+    std::vector<float> previous, current;
+    int first = 1;
+
+    if(numLevels == 1)
+        return;
+
+    if(filter == ResampleFilter::Box && width % MIP_TILE_SIZE == 0 && height % MIP_TILE_SIZE == 0){
+        //Every 64x64 tile of level 0 is reduced down to a single pixel, while it is in the cache.
+        //The tiles are independent, so they can be processed in parallel.
+        int tilesX = width / MIP_TILE_SIZE;
+        int tilesY = height / MIP_TILE_SIZE;
+        int tileLevels = 0;
+        while((MIP_TILE_SIZE >> tileLevels) > 1)
+            tileLevels++;
+        previous.resize(tilesX * tilesY * channels);
+
+        PixelConversion::forEachRow(tilesX * tilesY,parallel,[&](int t){
+            int tx = t % tilesX, ty = t / tilesX;
+            //all levels of this tile: 64x64, 32x32, ..., 1x1
+            float* a = scratchMemory(2 * MIP_TILE_SIZE * MIP_TILE_SIZE * channels);
+            float* b = a + MIP_TILE_SIZE * MIP_TILE_SIZE * channels;
+            for(int y = 0 ; y < MIP_TILE_SIZE ; ++y){
+                read(tx * MIP_TILE_SIZE, ty * MIP_TILE_SIZE + y, MIP_TILE_SIZE, a + y * MIP_TILE_SIZE * channels);
+            }
+            for(int l = 1 ; l <= tileLevels ; ++l){
+                int size = MIP_TILE_SIZE >> l;
+                boxReduce(a, b, size, channels);
+                std::swap(a,b);
+                if(l == tileLevels){
+                    memcpy(&previous[t * channels], a, channels * sizeof(float));
+                }
+                //the writer is allowed to modify the data, so it gets a copy
+                for(int y = 0 ; y < size ; ++y){
+                    memcpy(b, a + y * size * channels, size * channels * sizeof(float));
+                    write(l, tx * size, ty * size + y, size, b);
+                }
+            }
+        });
+        first = tileLevels + 1;
+    }
+
+    for(int l = first ; l < numLevels ; ++l){
+        current.resize(ws[l] * hs[l] * channels);
+        float* cur = current.data();
+        int w = ws[l];
+        ReadFunction readPrevious = read;
+        if(l > 1){
+            const float* prev = previous.data();
+            int pw = ws[l-1];
+            readPrevious = [=](int x, int y, int n, float* out){
+                memcpy(out, prev + (y * pw + x) * channels, n * channels * sizeof(float));
+            };
+        }
+        resample(ws[l-1], hs[l-1], readPrevious, ws[l], hs[l], [&,cur,w,l](int x, int y, int n, float* data){
+            memcpy(cur + (y * w + x) * channels, data, n * channels * sizeof(float));
+            write(l, x, y, n, data);
+        }, channels, filter, parallel);
+        previous.swap(current);
+    }
+}
+
+void generateMipChain(std::vector<std::vector<float> > &levels, int width, int height, int channels, ResampleFilter filter, bool parallel)
+{
+    int numLevels = mipLevelCount(width,height);
+    levels.resize(numLevels);
+    std::vector<int> ws(numLevels);
+    for(int i = 0 ; i < numLevels ; ++i){
+        ws[i] = std::max(1, width >> i);
+        levels[i].resize(ws[i] * std::max(1, height >> i) * channels);
+    }
+    const float* src = levels[0].data();
+    generateMipChain(width, height, [=](int x, int y, int n, float* out){
+        memcpy(out, src + (y * width + x) * channels, n * channels * sizeof(float));
+    }, [&](int level, int x, int y, int n, float* data){
+        memcpy(&levels[level][(y * ws[level] + x) * channels], data, n * channels * sizeof(float));
+    }, channels, filter, parallel);
+}
+
+}
+}
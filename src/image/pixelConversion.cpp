@@ -0,0 +1,217 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/image/pixelConversion.h"
+#include "saiga/util/simd.h"
+
+namespace Saiga {
+namespace PixelConversion {
+
+//The scalar versions are identical to TexelElementToFloatConversion and TexelElementFromFloatConversion.
+//The simd versions use a division (not a multiplication with 1/255) and truncation, so they produce the same bits.
+
+namespace Scalar {
+
+void u8ToFloat(const uint8_t *src, float *dst, int n)
+{
+    for(int i = 0 ; i < n ; ++i){
+        dst[i] = src[i] / 255.0f;
+    }
+}
+
+void floatToU8(const float *src, uint8_t *dst, int n)
+{
+    for(int i = 0 ; i < n ; ++i){
+        float f = src[i] * 255.0f;
+        dst[i] = f <= 0 ? 0 : (f >= 255.0f ? 255 : (uint8_t)f);
+    }
+}
+
+void rgbToRgba(const uint8_t *src, uint8_t *dst, int n, uint8_t alpha)
+{
+    for(int i = 0 ; i < n ; ++i){
+        dst[i * 4 + 0] = src[i * 3 + 0];
+        dst[i * 4 + 1] = src[i * 3 + 1];
+        dst[i * 4 + 2] = src[i * 3 + 2];
+        dst[i * 4 + 3] = alpha;
+    }
+}
+
+void rgbaToRgb(const uint8_t *src, uint8_t *dst, int n)
+{
+    for(int i = 0 ; i < n ; ++i){
+        dst[i * 3 + 0] = src[i * 4 + 0];
+        dst[i * 3 + 1] = src[i * 4 + 1];
+        dst[i * 3 + 2] = src[i * 4 + 2];
+    }
+}
+
+void flipRBRgba(uint8_t *data, int n)
+{
+    for(int i = 0 ; i < n ; ++i){
+        uint8_t tmp = data[i * 4];
+        data[i * 4] = data[i * 4 + 2];
+        data[i * 4 + 2] = tmp;
+    }
+}
+
+}
+
+void u8ToFloat(const uint8_t *src, float *dst, int n)
+{
+    int i = 0;
+#if defined(SAIGA_HAS_AVX2)
+    const __m256 scale = _mm256_set1_ps(255.0f);
+    for(; i + 8 <= n ; i += 8){
+        __m128i b = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+        __m256 f = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(b));
+        _mm256_storeu_ps(dst + i, _mm256_div_ps(f,scale));
+    }
+#elif defined(SAIGA_HAS_SSE2)
+    const __m128 scale = _mm_set1_ps(255.0f);
+    const __m128i zero = _mm_setzero_si128();
+    for(; i + 16 <= n ; i += 16){
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i lo = _mm_unpacklo_epi8(b,zero);
+        __m128i hi = _mm_unpackhi_epi8(b,zero);
+        _mm_storeu_ps(dst + i     , _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo,zero)),scale));
+        _mm_storeu_ps(dst + i + 4 , _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo,zero)),scale));
+        _mm_storeu_ps(dst + i + 8 , _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi,zero)),scale));
+        _mm_storeu_ps(dst + i + 12, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi,zero)),scale));
+    }
+#endif
+    Scalar::u8ToFloat(src + i, dst + i, n - i);
+}
+
+void floatToU8(const float *src, uint8_t *dst, int n)
+{
+    int i = 0;
+#if defined(SAIGA_HAS_AVX2)
+    const __m256 scale = _mm256_set1_ps(255.0f);
+    for(; i + 16 <= n ; i += 16){
+        __m256i a = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_loadu_ps(src + i),scale));
+        __m256i b = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_loadu_ps(src + i + 8),scale));
+        //the packs work on 128 bit lanes, so the result has to be permuted
+        __m256i s = _mm256_permute4x64_epi64(_mm256_packs_epi32(a,b),0xD8);
+        __m128i r = _mm_packus_epi16(_mm256_castsi256_si128(s),_mm256_extracti128_si256(s,1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),r);
+    }
+#elif defined(SAIGA_HAS_SSE2)
+    const __m128 scale = _mm_set1_ps(255.0f);
+    for(; i + 16 <= n ; i += 16){
+        __m128i a = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i     ),scale));
+        __m128i b = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i + 4 ),scale));
+        __m128i c = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i + 8 ),scale));
+        __m128i d = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i + 12),scale));
+        __m128i r = _mm_packus_epi16(_mm_packs_epi32(a,b),_mm_packs_epi32(c,d));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),r);
+    }
+#endif
+    Scalar::floatToU8(src + i, dst + i, n - i);
+}
+
+void rgbToRgba(const uint8_t *src, uint8_t *dst, int n, uint8_t alpha)
+{
+    int i = 0;
+#if defined(SAIGA_HAS_SSSE3)
+    //4 pixels per iteration. 16 bytes are loaded, so the last 2 pixels are done by the scalar loop.
+    const __m128i shuffle = _mm_setr_epi8(0,1,2,-1, 3,4,5,-1, 6,7,8,-1, 9,10,11,-1);
+    const __m128i alphaMask = _mm_set1_epi32(uint32_t(alpha) << 24);
+    for(; i + 6 <= n ; i += 4){
+        __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+        p = _mm_or_si128(_mm_shuffle_epi8(p,shuffle),alphaMask);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4),p);
+    }
+#endif
+    Scalar::rgbToRgba(src + i * 3, dst + i * 4, n - i, alpha);
+}
+
+void rgbaToRgb(const uint8_t *src, uint8_t *dst, int n)
+{
+    int i = 0;
+#if defined(SAIGA_HAS_SSSE3)
+    //4 pixels per iteration. 16 bytes are stored, the 4 extra bytes are overwritten by the next iteration.
+    const __m128i shuffle = _mm_setr_epi8(0,1,2, 4,5,6, 8,9,10, 12,13,14, -1,-1,-1,-1);
+    for(; i + 6 <= n ; i += 4){
+        __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 3),_mm_shuffle_epi8(p,shuffle));
+    }
+#endif
+    Scalar::rgbaToRgb(src + i * 4, dst + i * 3, n - i);
+}
+
+void flipRBRgba(uint8_t *data, int n)
+{
+    int i = 0;
+#if defined(SAIGA_HAS_SSE2)
+    //with the pixels as 32 bit integers: swap byte 0 and byte 2
+    const __m128i keep = _mm_set1_epi32(0xFF00FF00);
+    const __m128i low = _mm_set1_epi32(0xFF);
+    for(; i + 4 <= n ; i += 4){
+        __m128i* ptr = reinterpret_cast<__m128i*>(data + i * 4);
+        __m128i p = _mm_loadu_si128(ptr);
+        __m128i r = _mm_slli_epi32(_mm_and_si128(p,low),16);
+        __m128i b = _mm_and_si128(_mm_srli_epi32(p,16),low);
+        _mm_storeu_si128(ptr,_mm_or_si128(_mm_and_si128(p,keep),_mm_or_si128(r,b)));
+    }
+#endif
+    Scalar::flipRBRgba(data + i * 4, n - i);
+}
+
+
+//The tables are created with the same float operations as the texel wise conversion.
+struct SRGBTables{
+    uint8_t toLinear[256];
+    uint8_t toSrgb[256];
+
+    SRGBTables(){
+        typedef TexelElementToFloatConversion<GLubyte,ImageElementFormat::UnsignedNormalized> toFloat;
+        typedef TexelElementFromFloatConversion<GLubyte,ImageElementFormat::UnsignedNormalized> fromFloat;
+        for(int i = 0 ; i < 256 ; ++i){
+            float f = toFloat::toFloat(i);
+            toLinear[i] = fromFloat::fromFloat(Color::srgb2linearrgb(vec3(f)).x);
+            toSrgb[i] = fromFloat::fromFloat(Color::linearrgb2srgb(vec3(f)).x);
+        }
+    }
+};
+
+static const SRGBTables& srgbTables(){
+    static SRGBTables tables;
+    return tables;
+}
+
+const uint8_t *srgbToLinearLUT()
+{
+    return srgbTables().toLinear;
+}
+
+const uint8_t *linearToSrgbLUT()
+{
+    return srgbTables().toSrgb;
+}
+
+void applyLUT(uint8_t *data, int n, int channels, const uint8_t *lut)
+{
+    if(channels == 4){
+        for(int i = 0 ; i < n ; ++i){
+            uint8_t* p = data + i * 4;
+            p[0] = lut[p[0]];
+            p[1] = lut[p[1]];
+            p[2] = lut[p[2]];
+        }
+        return;
+    }
+    int colorChannels = std::min(channels,3);
+    for(int i = 0 ; i < n ; ++i){
+        uint8_t* p = data + i * channels;
+        for(int c = 0 ; c < colorChannels ; ++c){
+            p[c] = lut[p[c]];
+        }
+    }
+}
+
+}
+}
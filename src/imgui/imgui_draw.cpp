@@ -81,7 +81,7 @@ namespace IMGUI_STB_NAMESPACE
 
 #define STBRP_ASSERT(x)    IM_ASSERT(x)
 #ifndef IMGUI_DISABLE_STB_RECT_PACK_IMPLEMENTATION
-#define STBRP_STATIC
+//not static, the SkylinePacker of the text atlas uses this implementation
 #define STB_RECT_PACK_IMPLEMENTATION
 #endif
 #include "stb_rect_pack.h"
@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/opengl/asyncReadback.h"
+#include "saiga/image/image.h"
+#include "saiga/util/assert.h"
+
+#include <cstring>
+
+namespace Saiga {
+
+AsyncReadback::AsyncReadback(int ringSize, int frameDelay)
+    : slots(ringSize), frameDelay(frameDelay)
+{
+    SAIGA_ASSERT(ringSize > 0);
+}
+
+AsyncReadback::~AsyncReadback()
+{
+    for(Slot& s : slots){
+        if(s.fence){
+            glDeleteSync(s.fence);
+        }
+    }
+}
+
+void AsyncReadback::request(std::shared_ptr<Image> image, AsyncReadback::Callback callback)
+{
+    Slot* slot = nullptr;
+    for(Slot& s : slots){
+        if(!s.image){
+            slot = &s;
+            break;
+        }
+    }
+    if(!slot){
+        //all buffers are in use: stall on the oldest capture
+        slot = oldest();
+        finish(*slot);
+    }
+
+    unsigned int size = image->getSize();
+    if(slot->pbo.buffer == 0 || slot->pbo.size < size){
+        slot->pbo.deleteGLBuffer();
+        slot->pbo.createGLBuffer(nullptr,size,GL_STREAM_READ);
+    }
+
+    //read data from default framebuffer and restore currently bound fb.
+    GLint fb;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING,&fb);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    slot->pbo.bind();
+    //with a bound pack buffer the last argument is the offset in the buffer
+    glReadPixels(0,0,image->width,image->height,image->Format().getGlFormat(),image->Format().getGlType(),nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER,0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fb);
+
+    slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE,0);
+    slot->frame = frame;
+    slot->order = requests++;
+    slot->image = image;
+    slot->callback = callback;
+    pending++;
+    assert_no_glerror();
+}
+
+void AsyncReadback::update()
+{
+    frame++;
+    Slot* s;
+    while((s = oldest()) && frame - s->frame >= frameDelay){
+        finish(*s);
+    }
+}
+
+void AsyncReadback::flush()
+{
+    Slot* s;
+    while((s = oldest())){
+        finish(*s);
+    }
+}
+
+void AsyncReadback::finish(AsyncReadback::Slot &slot)
+{
+    //after 'frameDelay' frames the fence is usually signaled and this does not block
+    glClientWaitSync(slot.fence,GL_SYNC_FLUSH_COMMANDS_BIT,GLuint64(1000000000));
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+
+    slot.pbo.bind();
+    void* ptr = slot.pbo.mapBuffer(GL_READ_ONLY);
+    memcpy(slot.image->getRawData(),ptr,slot.image->getSize());
+    slot.pbo.unmapBuffer();
+    glBindBuffer(GL_PIXEL_PACK_BUFFER,0);
+
+    std::shared_ptr<Image> image = slot.image;
+    Callback callback = slot.callback;
+    slot.image = nullptr;
+    slot.callback = nullptr;
+    pending--;
+
+    callback(image);
+}
+
+AsyncReadback::Slot *AsyncReadback::oldest()
+{
+    Slot* result = nullptr;
+    for(Slot& s : slots){
+        if(s.image && (!result || s.order < result->order)){
+            result = &s;
+        }
+    }
+    return result;
+}
+
+}
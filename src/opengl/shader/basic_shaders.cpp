@@ -33,6 +33,17 @@ void MVPColorShader::uploadColor(const vec4 &color){
     upload(location_color,color);
 }
 
+void MVPQuantizedShader::checkUniforms(){
+    MVPColorShader::checkUniforms();
+    location_dequantizationScale = getUniformLocation("dequantizationScale");
+    location_dequantizationOffset = getUniformLocation("dequantizationOffset");
+}
+
+void MVPQuantizedShader::uploadDequantization(const vec3 &scale, const vec3 &offset){
+    upload(location_dequantizationScale,scale);
+    upload(location_dequantizationOffset,offset);
+}
+
 void MVPTextureShader::checkUniforms(){
     MVPShader::checkUniforms();
     location_texture = Shader::getUniformLocation("image");
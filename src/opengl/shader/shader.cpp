@@ -5,6 +5,7 @@
  */
 
 #include "saiga/opengl/shader/shader.h"
+#include "saiga/opengl/shader/shaderBinaryCache.h"
 #include "saiga/opengl/texture/raw_texture.h"
 #include "saiga/util/error.h"
 #include <fstream>
@@ -35,6 +36,9 @@ GLuint Shader::createProgram(){
 //        cout << "Attaching shader " << sp->id << endl;
 		glAttachShader(program, sp->id);
 	}
+	if (shaderBinaryCache.isEnabled()){
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
 	assert_no_glerror();
 	glLinkProgram(program);
     assert_no_glerror();
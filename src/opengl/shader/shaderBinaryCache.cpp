@@ -0,0 +1,185 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/opengl/shader/shaderBinaryCache.h"
+#include "saiga/opengl/shader/shader.h"
+#include "saiga/util/error.h"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+#include <direct.h>
+#endif
+
+namespace Saiga {
+
+ShaderBinaryCache shaderBinaryCache;
+
+#define SHADER_CACHE_MAGIC 0x53484243
+#define SHADER_CACHE_VERSION 1
+
+struct ShaderCacheHeader{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t format;
+    uint32_t binarySize;
+    uint32_t driverLength;
+};
+
+//FNV-1a, because the key has to be the same in every run
+static void hashBytes(uint64_t &h, const void* data, size_t size){
+    const unsigned char* c = static_cast<const unsigned char*>(data);
+    for(size_t i = 0 ; i < size ; ++i){
+        h ^= c[i];
+        h *= 1099511628211ULL;
+    }
+}
+
+static void hashString(uint64_t &h, const std::string &str){
+    uint64_t size = str.size();
+    hashBytes(h,&size,sizeof(size));
+    hashBytes(h,str.data(),str.size());
+}
+
+static std::string glString(GLenum name){
+    const GLubyte* str = glGetString(name);
+    return str ? std::string(reinterpret_cast<const char*>(str)) : std::string();
+}
+
+void ShaderBinaryCache::setDirectory(const std::string &dir)
+{
+    directory = dir;
+    if(directory.empty())
+        return;
+#if defined(_WIN32)
+    _mkdir(directory.c_str());
+#else
+    mkdir(directory.c_str(),0755);
+#endif
+}
+
+bool ShaderBinaryCache::isEnabled()
+{
+    if(directory.empty())
+        return false;
+    if(supported == -1){
+        GLint numFormats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS,&numFormats);
+        assert_no_glerror();
+        supported = numFormats > 0;
+        driver = glString(GL_VENDOR) + " " + glString(GL_RENDERER) + " " + glString(GL_VERSION);
+        if(!supported)
+            cout << "ShaderBinaryCache: The driver does not support program binaries." << endl;
+    }
+    return supported == 1;
+}
+
+uint64_t ShaderBinaryCache::computeKey(const std::vector<std::shared_ptr<ShaderPart> > &parts, const ShaderPart::ShaderCodeInjections &injections)
+{
+    uint64_t h = 14695981039346656037ULL;
+    hashString(h,driver);
+    for(auto& sp : parts){
+        uint32_t type = static_cast<uint32_t>(sp->type);
+        hashBytes(h,&type,sizeof(type));
+        //with the length of every line, so moving text between lines changes the key
+        uint64_t lines = sp->code.size();
+        hashBytes(h,&lines,sizeof(lines));
+        for(const std::string& line : sp->code){
+            hashString(h,line);
+        }
+    }
+    //the injections are already part of the code, but they are added
+    //separately so injections that move lines can not collide
+    for(const ShaderCodeInjection& sci : injections){
+        uint32_t type = static_cast<uint32_t>(sci.type);
+        hashBytes(h,&type,sizeof(type));
+        hashBytes(h,&sci.line,sizeof(sci.line));
+        hashString(h,sci.code);
+    }
+    return h;
+}
+
+std::string ShaderBinaryCache::entryFile(uint64_t key)
+{
+    std::stringstream sstream;
+    sstream << directory << "/" << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    return sstream.str();
+}
+
+bool ShaderBinaryCache::load(Shader &shader, uint64_t key)
+{
+    std::ifstream stream(entryFile(key),std::ios::binary);
+    if(!stream.is_open())
+        return false;
+
+    ShaderCacheHeader header;
+    if(!stream.read(reinterpret_cast<char*>(&header),sizeof(header)))
+        return false;
+    if(header.magic != SHADER_CACHE_MAGIC || header.version != SHADER_CACHE_VERSION || header.key != key)
+        return false;
+
+    std::string entryDriver(header.driverLength,' ');
+    std::vector<uint8_t> binary(header.binarySize);
+    if(!stream.read(&entryDriver[0],header.driverLength) || !stream.read(reinterpret_cast<char*>(binary.data()),binary.size()))
+        return false;
+    if(entryDriver != driver)
+        return false;
+
+    shader.program = glCreateProgram();
+    //not Shader::setBinary, because an invalid binary is not an error here
+    glProgramBinary(shader.program,static_cast<GLenum>(header.format),binary.data(),binary.size());
+    //an unsupported format generates GL_INVALID_ENUM, which is consumed here. other binaries fail to link.
+    GLenum error = glGetError();
+
+    GLint status = 0;
+    glGetProgramiv(shader.program,GL_LINK_STATUS,&status);
+    if(error != GL_NO_ERROR || status == 0){
+        cout << "ShaderBinaryCache: The driver rejected " << entryFile(key) << endl;
+        shader.destroyProgram();
+        return false;
+    }
+
+    //the parts are not needed anymore, because the program is already linked
+    for (auto& sp : shader.shaders){
+        sp->deleteGLShader();
+    }
+    shader.checkUniforms();
+    assert_no_glerror();
+    return true;
+}
+
+bool ShaderBinaryCache::store(Shader &shader, uint64_t key)
+{
+    std::vector<uint8_t> binary;
+    GLenum format;
+    if(!shader.getBinary(binary,format))
+        return false;
+
+    std::ofstream stream(entryFile(key),std::ios::binary);
+    if(!stream.is_open()){
+        cout << "ShaderBinaryCache: Could not write " << entryFile(key) << endl;
+        return false;
+    }
+
+    ShaderCacheHeader header;
+    header.magic = SHADER_CACHE_MAGIC;
+    header.version = SHADER_CACHE_VERSION;
+    header.key = key;
+    header.format = static_cast<uint32_t>(format);
+    header.binarySize = binary.size();
+    header.driverLength = driver.size();
+    stream.write(reinterpret_cast<const char*>(&header),sizeof(header));
+    stream.write(driver.data(),driver.size());
+    stream.write(reinterpret_cast<const char*>(binary.data()),binary.size());
+    return stream.good();
+}
+
+}
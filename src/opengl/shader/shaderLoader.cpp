@@ -19,10 +19,10 @@ std::shared_ptr<Shader> ShaderLoader::loadFromFile(const std::string &name, cons
 
 void ShaderLoader::reload(){
     cout<<"ShaderLoader::reload"<<endl;
-    for(auto &object : objects){
-        auto name = std::get<0>(object);
-        auto sci = std::get<1>(object);
-        auto shader = std::get<2>(object);
+    for(CacheEntry &entry : entries){
+        auto name = entry.name;
+        auto sci = entry.params;
+        auto shader = entry.object;
 
 
         std::string fullName = shaderPathes.getFile(name);
@@ -6,11 +6,14 @@
 
 #include "saiga/opengl/shader/shaderPartLoader.h"
 #include "saiga/opengl/shader/shader.h"
+#include "saiga/opengl/shader/shaderBinaryCache.h"
 #include "saiga/util/fileChecker.h"
+#include "saiga/util/mappedFile.h"
 #include "saiga/util/error.h"
 #include <fstream>
 #include <algorithm>
 #include <regex>
+#include <unordered_map>
 
 namespace Saiga {
 
@@ -19,6 +22,19 @@ namespace Saiga {
 
 FileChecker shaderPathes;
 
+//a shader file after the first pass of loadAndPreproccess
+struct CachedShaderFile{
+    uint64_t size;
+    int64_t modificationTime;
+    bool addLineDirectives;
+    std::vector<std::string> lines;
+};
+static std::unordered_map<std::string,CachedShaderFile> fileCache;
+
+void ShaderPartLoader::clearFileCache(){
+    fileCache.clear();
+}
+
 ShaderPartLoader::ShaderPartLoader() : ShaderPartLoader("",ShaderCodeInjections()){
 }
 
@@ -96,9 +112,8 @@ inline std::string getFileFromInclude(const std::string &file, std::string line)
     return includeFileName;
 }
 
-bool ShaderPartLoader::loadAndPreproccess(const std::string &file, std::vector<std::string> &ret)
+bool ShaderPartLoader::readFile(const std::string &file, std::vector<std::string> &ret)
 {
-
     std::ifstream fileStream(file, std::ios::in);
     if(!fileStream.is_open()) {
         return false;
@@ -141,6 +156,34 @@ bool ShaderPartLoader::loadAndPreproccess(const std::string &file, std::vector<s
             ret.push_back(line);
         }
     }
+    return true;
+}
+
+bool ShaderPartLoader::loadAndPreproccess(const std::string &file, std::vector<std::string> &ret)
+{
+    const std::string include("#include ");
+
+    uint64_t fileSize;
+    int64_t modificationTime;
+    if(!MappedFile::fileStats(file,fileSize,modificationTime)){
+        return false;
+    }
+
+    //the includes are expanded from the cache, so only modified files are read again
+    auto cached = fileCache.find(file);
+    if(cached != fileCache.end() && cached->second.size == fileSize && cached->second.modificationTime == modificationTime
+            && cached->second.addLineDirectives == addLineDirectives){
+        ret = cached->second.lines;
+    }else{
+        ret.clear();
+        if(!readFile(file,ret))
+            return false;
+        CachedShaderFile& entry = fileCache[file];
+        entry.size = fileSize;
+        entry.modificationTime = modificationTime;
+        entry.addLineDirectives = addLineDirectives;
+        entry.lines = ret;
+    }
 
     //second pass:
     //loop over vector and replace #include commands with the actual code
@@ -172,18 +215,51 @@ void ShaderPartLoader::addShader(std::vector<std::string> &content, GLenum type)
     shader->code = content;
     shader->type = type;
     shader->addInjections(injections);
+    shaders.push_back(shader);
+}
 
-    shader->createGLShader();
-    if(shader->compile()){
-        shaders.push_back(shader);
-	}
-	else{
-        FileChecker fc;
-        std::string name = fc.getFileName(this->file);
-        shader->writeToFile("debug/" + name);
-	}
+bool ShaderPartLoader::compileShaders()
+{
+    std::vector<std::shared_ptr<ShaderPart>> compiled;
+    for(auto& shader : shaders){
+        shader->createGLShader();
+        if(shader->compile()){
+            compiled.push_back(shader);
+        }
+        else{
+            FileChecker fc;
+            std::string name = fc.getFileName(this->file);
+            shader->writeToFile("debug/" + name);
+        }
+    }
+    shaders = compiled;
 
     assert_no_glerror();
+    return !shaders.empty();
+}
+
+bool ShaderPartLoader::createProgram(std::shared_ptr<Shader> shader)
+{
+    bool useCache = shaderBinaryCache.isEnabled();
+    uint64_t key = 0;
+    if(useCache){
+        key = shaderBinaryCache.computeKey(shaders,injections);
+        shader->shaders = shaders;
+        if(shaderBinaryCache.load(*shader,key)){
+            return true;
+        }
+    }
+
+    //fall back to the source, if the binary is not in the cache or was rejected by the driver
+    if(!compileShaders())
+        return false;
+    shader->shaders = shaders;
+    shader->createProgram();
+
+    if(useCache){
+        shaderBinaryCache.store(*shader,key);
+    }
+    return true;
 }
 
 void ShaderPartLoader::reloadShader(std::shared_ptr<Shader>  shader)
@@ -191,8 +267,9 @@ void ShaderPartLoader::reloadShader(std::shared_ptr<Shader>  shader)
 //    cout<<"ShaderPartLoader::reloadShader"<<endl;
     shader->destroyProgram();
 
-    shader->shaders = shaders;
-    shader->createProgram();
+    if(!createProgram(shader)){
+        std::cerr<<file<<": all shader parts failed to compile."<<endl;
+    }
 
     std::cout<<"Loaded: "<<file<<" ( ";
     for(auto& sp : shaders){
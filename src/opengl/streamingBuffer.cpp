@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/opengl/streamingBuffer.h"
+#include "saiga/util/assert.h"
+
+namespace Saiga {
+
+StreamingBuffer::StreamingBuffer(GLenum _target) : Buffer(_target)
+{
+}
+
+StreamingBuffer::~StreamingBuffer()
+{
+    destroy();
+}
+
+void StreamingBuffer::create(unsigned int _regionSize, int _numRegions)
+{
+    SAIGA_ASSERT(_numRegions > 0);
+    destroy();
+
+    regionSize = _regionSize;
+    numRegions = _numRegions;
+    fences.resize(numRegions,nullptr);
+    unsigned int totalSize = regionSize * numRegions;
+
+    persistent = (getVersionMajor() > 4 || (getVersionMajor() == 4 && getVersionMinor() >= 4)) || hasExtension("GL_ARB_buffer_storage");
+
+    if(persistent){
+        const BufferStorageMask storageFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        const BufferAccessMask accessFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glGenBuffers(1, &buffer);
+        bind();
+        glBufferStorage(target, totalSize, nullptr, storageFlags);
+        mapped = static_cast<unsigned char*>(glMapBufferRange(target, 0, totalSize, accessFlags));
+        SAIGA_ASSERT(mapped);
+        size = totalSize;
+        usage = GL_STREAM_DRAW;
+    }else{
+        createGLBuffer(nullptr,totalSize,GL_STREAM_DRAW);
+        staging.resize(totalSize);
+    }
+    glBindBuffer(target, 0);
+    assert_no_glerror();
+
+    //the first beginFrame switches to region 0
+    currentRegion = numRegions - 1;
+    head = flushed = regionStart();
+}
+
+void StreamingBuffer::destroy()
+{
+    for(GLsync& f : fences){
+        if(f){
+            glDeleteSync(f);
+            f = nullptr;
+        }
+    }
+    if(mapped){
+        bind();
+        glUnmapBuffer(target);
+        mapped = nullptr;
+    }
+    deleteGLBuffer();
+    staging.clear();
+    regionSize = 0;
+}
+
+void StreamingBuffer::beginFrame()
+{
+    currentRegion = (currentRegion + 1) % numRegions;
+    GLsync& f = fences[currentRegion];
+    if(f){
+        //with 3 regions the frame that used it is usually finished, so this returns immediately
+        while(true){
+            GLenum result = glClientWaitSync(f, GL_SYNC_FLUSH_COMMANDS_BIT, GLuint64(1000000));
+            if(result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED)
+                break;
+        }
+        glDeleteSync(f);
+        f = nullptr;
+    }
+    head = flushed = regionStart();
+}
+
+void StreamingBuffer::endFrame()
+{
+    GLsync& f = fences[currentRegion];
+    if(f)
+        glDeleteSync(f);
+    f = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+StreamingBuffer::Allocation StreamingBuffer::allocate(unsigned int bytes, unsigned int alignment)
+{
+    Allocation a;
+    unsigned int offset = (head + alignment - 1) / alignment * alignment;
+    if(offset + bytes > regionStart() + regionSize)
+        return a;
+    head = offset + bytes;
+    a.offset = offset;
+    a.ptr = (mapped ? mapped : staging.data()) + offset;
+    return a;
+}
+
+void StreamingBuffer::flush()
+{
+    if(persistent || head <= flushed)
+        return;
+    updateBuffer(staging.data() + flushed, head - flushed, flushed);
+    flushed = head;
+}
+
+}
@@ -19,6 +19,10 @@ bool operator==(const TextureParameters &lhs, const TextureParameters &rhs) {
     return std::tie(lhs.srgb) == std::tie(rhs.srgb);
 }
 
+size_t loaderHash(const TextureParameters &params){
+    return std::hash<bool>()(params.srgb);
+}
+
 
 
 std::shared_ptr<Texture> TextureLoader::textureFromImage(Image &im, const TextureParameters &params) const{
@@ -56,6 +60,24 @@ std::shared_ptr<Texture> TextureLoader::loadFromFile(const std::string &path, co
     return nullptr;
 }
 
+std::shared_ptr<void> TextureLoader::decodeAsync(const std::string &path, const TextureParameters &params){
+    (void)params;
+    auto im = std::make_shared<Image>();
+    if(loadImage(path,*im)){
+        return im;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<Texture> TextureLoader::finishAsync(std::shared_ptr<void> decoded, const std::string &name, const TextureParameters &params){
+    (void)name;
+    return textureFromImage(*std::static_pointer_cast<Image>(decoded),params);
+}
+
+size_t TextureLoader::memorySize(const std::shared_ptr<Texture> &object){
+    return size_t(object->getWidth()) * object->getHeight() * object->bytesPerPixel();
+}
+
 bool TextureLoader::loadImage(const std::string &path, Image &outImage) const
 {
     bool erg = false;
@@ -6,6 +6,8 @@
 
 #include "saiga/opengl/vertex.h"
 
+#include <algorithm>
+
 namespace Saiga {
 
 template<>
@@ -63,6 +65,25 @@ void VertexBuffer<VertexNC>::setVertexAttributes(){
     glVertexAttribPointer(3,4, GL_FLOAT, GL_FALSE, sizeof(VertexNC), (void*) (12 * sizeof(GLfloat)) );
 }
 
+template<>
+void VertexBuffer<VertexNQ>::setVertexAttributes(){
+    glEnableVertexAttribArray( 0 );
+    glEnableVertexAttribArray( 1 );
+
+    glVertexAttribPointer(0,4, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(VertexNQ), NULL );
+    glVertexAttribPointer(1,2, GL_SHORT, GL_TRUE, sizeof(VertexNQ), (void*) (4 * sizeof(GLushort)) );
+}
+
+template<>
+void VertexBuffer<VertexNTQ>::setVertexAttributes(){
+    glEnableVertexAttribArray( 0 );
+    glEnableVertexAttribArray( 1 );
+    glEnableVertexAttribArray( 2 );
+
+    glVertexAttribPointer(0,4, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(VertexNTQ), NULL );
+    glVertexAttribPointer(1,2, GL_SHORT, GL_TRUE, sizeof(VertexNTQ), (void*) (4 * sizeof(GLushort)) );
+    glVertexAttribPointer(2,2, GL_HALF_FLOAT, GL_FALSE, sizeof(VertexNTQ), (void*) (6 * sizeof(GLushort)) );
+}
 
 
 bool Vertex::operator==(const Vertex &other) const {
@@ -96,7 +117,7 @@ std::ostream &operator<<(std::ostream &os, const VertexNT &vert){
 }
 
 bool VertexNTD::operator==(const VertexNTD &other) const {
-    return VertexNTD::operator==(other) && data == other.data;
+    return VertexNT::operator==(other) && data == other.data;
 }
 
 std::ostream &operator<<(std::ostream &os, const VertexNTD &vert){
@@ -119,4 +140,12 @@ std::ostream &operator<<(std::ostream &os, const VertexNC &vert){
     return os;
 }
 
+bool VertexNQ::operator==(const VertexNQ &other) const {
+    return std::equal(position,position+4,other.position) && std::equal(normal,normal+2,other.normal);
+}
+
+bool VertexNTQ::operator==(const VertexNTQ &other) const {
+    return VertexNQ::operator==(other) && std::equal(texture,texture+2,other.texture);
+}
+
 }
@@ -160,6 +160,7 @@ void Deferred_Renderer::render_intern() {
 
     lighting.initRender();
     lighting.cullLights(*currentCamera);
+    lighting.cullShadowCasters();
     renderDepthMaps();
 
 
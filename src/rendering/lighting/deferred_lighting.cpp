@@ -20,8 +20,11 @@
 
 #include "saiga/opengl/shader/shaderLoader.h"
 #include "saiga/rendering/renderer.h"
+#include "saiga/assets/asset.h"
 #include "saiga/imgui/imgui.h"
 #include "saiga/util/tostring.h"
+#include "saiga/util/taskScheduler.h"
+#include "saiga/time/timer.h"
 
 namespace Saiga {
 
@@ -109,12 +112,21 @@ void DeferredLighting::cullLights(Camera *cam){
 
     visibleLights = directionalLights.size();
 
-    //cull lights that are not visible
+    //test the bounding spheres of all lights in one batch
+    lightSpheres.resize(pointLights.size() + spotLights.size() + boxLights.size());
+    int n = 0;
+
+    for(auto &light : pointLights){
+        if(light->isActive()){
+            lightSpheres.set(n++,Sphere(light->getPosition(),light->cutoffRadius));
+        }
+    }
+
     for(auto &light : spotLights){
         if(light->isActive()){
             light->calculateCamera();
             light->shadowCamera.recalculatePlanes();
-            visibleLights += (light->cullLight(cam))? 0 : 1;
+            lightSpheres.set(n++,light->shadowCamera.boundingSphere);
         }
     }
 
@@ -122,16 +134,86 @@ void DeferredLighting::cullLights(Camera *cam){
         if(light->isActive()){
             light->calculateCamera();
             light->shadowCamera.recalculatePlanes();
-            visibleLights += (light->cullLight(cam))? 0 : 1;
+            lightSpheres.set(n++,light->shadowCamera.boundingSphere);
         }
     }
 
+    lightSpheres.resize(n);
+    lightVisible.resize(n);
+    FrustumCuller culler(cam->planes);
+    culler.cullSpheres(lightSpheres,lightVisible.data());
 
+    n = 0;
     for(auto &light : pointLights){
         if(light->isActive()){
-            visibleLights += (light->cullLight(cam))? 0 : 1;
+            light->culled = !lightVisible[n++];
+            visibleLights += light->culled ? 0 : 1;
+        }
+    }
+
+    //do an exact frustum-frustum intersection if the light casts shadows and the sphere is visible
+    for(auto &light : spotLights){
+        if(light->isActive()){
+            light->culled = !lightVisible[n++] || (light->hasShadows() && !light->shadowCamera.intersectSAT(cam));
+            visibleLights += light->culled ? 0 : 1;
+        }
+    }
+
+    for(auto &light : boxLights){
+        if(light->isActive()){
+            light->culled = !lightVisible[n++] || (light->hasShadows() && !light->shadowCamera.intersectSAT(cam));
+            visibleLights += light->culled ? 0 : 1;
+        }
+    }
+}
+
+void DeferredLighting::cullShadowCasters()
+{
+    shadowViews.clear();
+    if(!shadowCasters)
+        return;
+
+    Timer timer;
+    timer.start();
+
+    //the same shadow cameras as in renderShadowmap
+    for(auto &light : directionalLights){
+        if(light->shouldCalculateShadowMap()){
+            for(int i = 0 ; i < light->getNumCascades() ; ++i){
+                light->shadowCamera.setProj(light->orthoBoxes[i]);
+                light->shadowCamera.recalculatePlanes();
+                shadowViews.push_back(FrustumCuller(light->shadowCamera.planes));
+            }
+        }
+    }
+    for(auto &light : boxLights){
+        if(light->shouldCalculateShadowMap()){
+            shadowViews.push_back(FrustumCuller(light->shadowCamera.planes));
+        }
+    }
+    for(auto &light : spotLights){
+        if(light->shouldCalculateShadowMap()){
+            shadowViews.push_back(FrustumCuller(light->shadowCamera.planes));
         }
     }
+    for(auto &light : pointLights){
+        if(light->shouldCalculateShadowMap()){
+            for(int i = 0 ; i < 6 ; ++i){
+                light->calculateCamera(i);
+                light->shadowCamera.recalculatePlanes();
+                shadowViews.push_back(FrustumCuller(light->shadowCamera.planes));
+            }
+        }
+    }
+
+    shadowDrawLists.resize(shadowViews.size());
+    parallelFor(defaultTaskScheduler(),0,shadowViews.size(),1,[this](int i){
+        DynamicAABBTree::QueryBuffer buffer;
+        shadowCasters->cull(shadowViews[i],shadowDrawLists[i],buffer);
+    });
+
+    timer.stop();
+    shadowCullTime = timer.getTimeMS();
 }
 
 void DeferredLighting::printTimings()
@@ -141,6 +223,10 @@ void DeferredLighting::printTimings()
     for(int i = 0 ;i < 5 ;++i){
         cout<<"\t "<< getTime(i)<<"ms "<<timerStrings[i]<<endl;
     }
+    if(shadowCasters){
+        cout<<"\t "<< shadowCullTime<<"ms Shadow Caster Culling (CPU)"<<endl;
+        cout<<"\t "<< shadowSubmitTime<<"ms Shadow Caster Submission (CPU)"<<endl;
+    }
 }
 
 
@@ -168,8 +254,22 @@ void DeferredLighting::renderDepthMaps(Program *renderer){
 
 
     shadowCameraBuffer.bind(CAMERA_DATA_BINDING_POINT);
+    currentShadowView = 0;
+    shadowSubmitTime = 0;
+    shadowCasterDraws = 0;
     DepthFunction depthFunc = [&](Camera* cam) -> void{
         renderedDepthmaps++;
+        if(shadowCasters && currentShadowView < (int)shadowViews.size()){
+            Timer timer;
+            timer.start();
+            const ShadowDrawList& list = shadowDrawLists[currentShadowView++];
+            for(const ShadowDrawList::Batch& b : list.batches){
+                b.asset->renderDepth(cam,list.models.data() + b.first,b.count);
+            }
+            shadowCasterDraws += list.numDraws();
+            timer.stop();
+            shadowSubmitTime += timer.getTimeMS();
+        }
         renderer->renderDepth(cam);
     };
     for(auto &light : directionalLights){
@@ -627,6 +727,11 @@ void DeferredLighting::renderImGui(bool *p_open)
     for(int i = 0 ;i < 5 ;++i){
         ImGui::Text("  %f ms %s",getTime(i),timerStrings[i].c_str());
     }
+    if(shadowCasters){
+        ImGui::Text("Shadow casters: %d, draws: %d",shadowCasters->size(),shadowCasterDraws);
+        ImGui::Text("  %f ms culling (CPU)",shadowCullTime);
+        ImGui::Text("  %f ms submission (CPU)",shadowSubmitTime);
+    }
     ImGui::Checkbox("backFaceShadows",&backFaceShadows);
     ImGui::InputFloat("shadowOffsetFactor",&shadowOffsetFactor,0.1,1);
     ImGui::InputFloat("shadowOffsetUnits",&shadowOffsetUnits,0.1,1);
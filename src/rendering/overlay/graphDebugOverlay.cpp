@@ -32,18 +32,13 @@ GraphDebugOverlay::GraphDebugOverlay(int width, int height, int numGraphs, int n
 
     //graphs
     for (int k = 0; k < numGraphs; ++k){
-        std::vector<Vertex> dataPoints;
-        dataPoints.resize(numDataPoints);
-
-
-        for(unsigned int i=0;i<dataPoints.size();++i){
-            dataPoints[i].position = vec4(i/(float)dataPoints.size(),glm::linearRand(0.f,1.f),0,1);
-        }
-
         graphs[k].data.resize(numDataPoints);
-        graphs[k].buffer.set(dataPoints,GL_DYNAMIC_DRAW);
-        graphs[k].buffer.setDrawMode(GL_LINE_STRIP);
+        for(float& d : graphs[k].data){
+            d = glm::linearRand(0.f,1.f);
+        }
     }
+    graphBuffer.create(numGraphs * numDataPoints);
+    graphBuffer.setDrawMode(GL_LINE_STRIP);
 
 
 
@@ -77,16 +72,8 @@ void GraphDebugOverlay::update()
 
     //    min = 0.f;
 
-        std::vector<Vertex> dataPoints(g.data.size());
-
-        for(int i = 0; i < (int)dataPoints.size(); ++i){
-            dataPoints[i].position.x = i/(float)dataPoints.size();
-            //scale to [0,1]
-            dataPoints[i].position.y = (g.data[i]-min) / (max-min);
-        }
-
-        g.buffer.updateBuffer(&dataPoints[0],dataPoints.size(),0);
-
+        g.min = min;
+        g.max = max;
     }
 }
 
@@ -107,10 +94,25 @@ void GraphDebugOverlay::render(float interpolation){
     shader->uploadModel(model);
 //    shader->uploadProj(proj);
 
+    //the vertices are written directly to the mapped buffer
+    graphBuffer.stream.beginFrame();
+    graphBuffer.bind();
     for (Graph& g : graphs){
+        int count = g.data.size();
+        int first;
+        Vertex* v = graphBuffer.allocate(count,first);
+        SAIGA_ASSERT(v);
+        for(int i = 0; i < count; ++i){
+            //scale to [0,1]
+            v[i].position = vec4(i/(float)count,(g.data[i]-g.min) / (g.max-g.min),0,1);
+        }
+        graphBuffer.stream.flush();
+
         shader->uploadColor(vec4(g.color));
-        g.buffer.bindAndDraw();
+        graphBuffer.draw(first,count);
     }
+    graphBuffer.unbind();
+    graphBuffer.stream.endFrame();
 
 
     shader->uploadColor(vec4(1,1,1,1));
@@ -0,0 +1,142 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/rendering/renderQueue.h"
+#include "saiga/assets/asset.h"
+#include "saiga/camera/camera.h"
+#include "saiga/util/assert.h"
+
+#include <algorithm>
+
+namespace Saiga {
+
+void RenderQueue::begin(Camera *cam)
+{
+    begin(cam->view,cam->zFar);
+}
+
+void RenderQueue::begin(const mat4 &view, float zFar)
+{
+    this->view = view;
+    depthScale = float((1 << depthBits) - 1) / zFar;
+    keys.clear();
+    values.clear();
+    models.clear();
+}
+
+void RenderQueue::submit(Asset *asset, const mat4 &model, uint16_t material)
+{
+    uint32_t id;
+    auto it = assetIds.find(asset);
+    if(it == assetIds.end()){
+        id = assets.size();
+        SAIGA_ASSERT(id < (1u << assetBits));
+        assetIds[asset] = id;
+        assets.push_back(asset);
+    }else{
+        id = it->second;
+    }
+
+    //view space z of the object origin
+    const vec4& p = model[3];
+    float z = -(view[0][2] * p.x + view[1][2] * p.y + view[2][2] * p.z + view[3][2]);
+    float d = std::min(std::max(z * depthScale,0.0f),float((1 << depthBits) - 1));
+
+    keys.push_back((uint64_t(material) << (assetBits + depthBits)) | (uint64_t(id) << depthBits) | uint64_t(d));
+    values.push_back(models.size());
+    models.push_back(model);
+}
+
+void RenderQueue::radixSort(std::vector<uint64_t> &keys, std::vector<uint32_t> &values, std::vector<uint64_t> &tmpKeys, std::vector<uint32_t> &tmpValues)
+{
+    int n = keys.size();
+    tmpKeys.resize(n);
+    tmpValues.resize(n);
+
+    //11 bit digits -> 6 passes
+    const int bits = 11;
+    const int buckets = 1 << bits;
+    std::vector<int> histograms(6 * buckets,0);
+    for(int i = 0 ; i < n ; ++i){
+        uint64_t k = keys[i];
+        for(int p = 0 ; p < 6 ; ++p){
+            histograms[p * buckets + ((k >> (p * bits)) & (buckets - 1))]++;
+        }
+    }
+
+    for(int p = 0 ; p < 6 ; ++p){
+        int* h = histograms.data() + p * buckets;
+        //skip the pass if all keys have the same digit (typical for the upper bits)
+        if(n == 0 || h[(keys[0] >> (p * bits)) & (buckets - 1)] == n)
+            continue;
+
+        int sum = 0;
+        for(int b = 0 ; b < buckets ; ++b){
+            int c = h[b];
+            h[b] = sum;
+            sum += c;
+        }
+        for(int i = 0 ; i < n ; ++i){
+            int dst = h[(keys[i] >> (p * bits)) & (buckets - 1)]++;
+            tmpKeys[dst] = keys[i];
+            tmpValues[dst] = values[i];
+        }
+        keys.swap(tmpKeys);
+        values.swap(tmpValues);
+    }
+}
+
+void RenderQueue::sort()
+{
+    int n = keys.size();
+    radixSort(keys,values,tmpKeys,tmpValues);
+
+    batches.clear();
+    sortedModels.resize(n);
+    const int stateShift = depthBits;
+    for(int i = 0 ; i < n ; ++i){
+        sortedModels[i] = models[values[i]];
+
+        if(i == 0 || (keys[i] >> stateShift) != (keys[i - 1] >> stateShift)){
+            Batch b;
+            b.asset = assets[(keys[i] >> depthBits) & ((1u << assetBits) - 1)];
+            b.material = keys[i] >> (assetBits + depthBits);
+            b.first = i;
+            b.count = 0;
+            batches.push_back(b);
+        }
+        batches.back().count++;
+    }
+}
+
+void RenderQueue::render(Camera *cam, const MaterialFunction &bindMaterial)
+{
+    for(int i = 0 ; i < (int)batches.size() ; ++i){
+        Batch& b = batches[i];
+        if(bindMaterial && (i == 0 || b.material != batches[i - 1].material))
+            bindMaterial(b.material);
+        b.asset->renderInstanced(cam,sortedModels.data() + b.first,b.count);
+    }
+}
+
+void RenderQueue::renderDepth(Camera *cam)
+{
+    for(Batch& b : batches){
+        b.asset->renderDepth(cam,sortedModels.data() + b.first,b.count);
+    }
+}
+
+void RenderQueue::clearAssets()
+{
+    assetIds.clear();
+    assets.clear();
+    keys.clear();
+    values.clear();
+    models.clear();
+    batches.clear();
+}
+
+}
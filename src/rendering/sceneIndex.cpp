@@ -0,0 +1,81 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/rendering/sceneIndex.h"
+#include "saiga/camera/camera.h"
+
+namespace Saiga {
+
+int SceneIndex::add(Object3D *object, const AABB &localBounds)
+{
+    int handle;
+    if(freeHandles.empty()){
+        handle = entries.size();
+        entries.push_back(Entry());
+    }else{
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+    }
+    Entry& e = entries[handle];
+    e.object = object;
+    e.localBounds = localBounds;
+    e.proxy = tree.insert(transformAABB(localBounds,object->model),handle);
+    return handle;
+}
+
+void SceneIndex::remove(int handle)
+{
+    Entry& e = entries[handle];
+    SAIGA_ASSERT(e.object);
+    tree.remove(e.proxy);
+    e = Entry();
+    freeHandles.push_back(handle);
+}
+
+void SceneIndex::update(int handle)
+{
+    const Entry& e = entries[handle];
+    SAIGA_ASSERT(e.object);
+    tree.move(e.proxy,transformAABB(e.localBounds,e.object->model));
+}
+
+void SceneIndex::updateAll()
+{
+    for(const Entry& e : entries){
+        if(e.object)
+            tree.move(e.proxy,transformAABB(e.localBounds,e.object->model));
+    }
+}
+
+void SceneIndex::cull(Camera *cam, std::vector<Object3D *> &visible) const
+{
+    cull(FrustumCuller(cam->planes),visible);
+}
+
+void SceneIndex::cull(const FrustumCuller &culler, std::vector<Object3D *> &visible) const
+{
+    visibleHandles.clear();
+    tree.query(culler,visibleHandles);
+    visible.resize(visibleHandles.size());
+    for(int i = 0 ; i < (int)visibleHandles.size() ; ++i){
+        visible[i] = entries[visibleHandles[i]].object;
+    }
+}
+
+AABB SceneIndex::transformAABB(const AABB &local, const mat4 &model)
+{
+    //Arvo's method: transform the center and project the extends onto the world axes
+    vec3 center = (local.min + local.max) * 0.5f;
+    vec3 extends = (local.max - local.min) * 0.5f;
+    vec3 worldCenter = vec3(model * vec4(center,1));
+    vec3 worldExtends;
+    for(int i = 0 ; i < 3 ; ++i){
+        worldExtends[i] = glm::abs(model[0][i]) * extends.x + glm::abs(model[1][i]) * extends.y + glm::abs(model[2][i]) * extends.z;
+    }
+    return AABB(worldCenter - worldExtends,worldCenter + worldExtends);
+}
+
+}
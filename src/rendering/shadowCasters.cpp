@@ -0,0 +1,57 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/rendering/shadowCasters.h"
+
+#include <algorithm>
+
+namespace Saiga {
+
+int ShadowCasterIndex::add(Object3D *object, Asset *asset, const AABB &localBounds)
+{
+    SAIGA_ASSERT(asset);
+    int handle = scene.add(object,localBounds);
+    if(handle >= (int)assets.size())
+        assets.resize(handle + 1,nullptr);
+    assets[handle] = asset;
+    return handle;
+}
+
+void ShadowCasterIndex::remove(int handle)
+{
+    scene.remove(handle);
+    assets[handle] = nullptr;
+}
+
+void ShadowCasterIndex::cull(const FrustumCuller &culler, ShadowDrawList &list, DynamicAABBTree::QueryBuffer &buffer) const
+{
+    list.clear();
+
+    std::vector<int> handles;
+    scene.query(culler,handles,buffer);
+
+    //sort by asset, so every asset is one batch
+    std::vector<std::pair<Asset*,int>> draws(handles.size());
+    for(int i = 0 ; i < (int)handles.size() ; ++i){
+        draws[i] = std::make_pair(assets[handles[i]],handles[i]);
+    }
+    std::sort(draws.begin(),draws.end());
+
+    list.models.resize(draws.size());
+    for(int i = 0 ; i < (int)draws.size() ; ++i){
+        if(i == 0 || draws[i].first != draws[i - 1].first){
+            ShadowDrawList::Batch b;
+            b.asset = draws[i].first;
+            b.first = i;
+            b.count = 0;
+            list.batches.push_back(b);
+        }
+        list.batches.back().count++;
+        list.models[i] = scene.getObject(draws[i].second)->model;
+    }
+}
+
+}
@@ -0,0 +1,166 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include <saiga/tests/test.h>
+#include <saiga/tests/testAnimation.h>
+
+#include "saiga/animation/animation.h"
+#include "saiga/animation/skeleton.h"
+#include "saiga/animation/compressedAnimation.h"
+#include "saiga/time/timer.h"
+#include <saiga/util/assert.h>
+
+#include <random>
+
+namespace Saiga {
+namespace Tests {
+
+using namespace std;
+
+//Smooth motion like a motion captured clip. Some channels are constant.
+static void smoothAnimation(Animation& anim, int nodeCount, int boneCount, int frameCount, std::mt19937& gen){
+    std::uniform_real_distribution<float> dis(-1,1);
+    std::vector<vec3> axis(nodeCount), offset(nodeCount);
+    std::vector<float> speed(nodeCount);
+    for(int i = 0 ; i < nodeCount ; ++i){
+        axis[i] = glm::normalize(vec3(dis(gen),dis(gen),dis(gen)));
+        offset[i] = vec3(dis(gen),dis(gen),dis(gen));
+        speed[i] = 2 + dis(gen);
+    }
+
+    createTestAnimation(anim,nodeCount,boneCount,frameCount,gen,[&](AnimationNode& n, float t){
+        int i = n.index;
+        //only the root motion and a few nodes translate, the joints only rotate
+        vec3 p = offset[i];
+        if(i % 7 == 2)
+            p += vec3(glm::sin(t * speed[i]),0,glm::cos(t * speed[i])) * 0.5f;
+        n.position = vec4(p,1);
+        n.rotation = glm::angleAxis(0.8f * glm::sin(t * speed[i]),axis[i]);
+        n.scaling = vec4(1);
+    });
+}
+
+static size_t frameMemory(const Animation& anim){
+    size_t size = 0;
+    for(const AnimationFrame& frame : anim.keyFrames){
+        size += sizeof(AnimationFrame) + frame.nodes.capacity() * sizeof(AnimationNode);
+        for(const AnimationNode& n : frame.nodes)
+            size += n.name.capacity() + n.children.capacity() * sizeof(int);
+    }
+    return size;
+}
+
+static size_t skeletonMemory(const SkeletonAnimation& anim){
+    return anim.times.size() * sizeof(tickd_t) + anim.positions.size() * sizeof(vec4)
+            + anim.rotations.size() * sizeof(quat) + anim.scalings.size() * sizeof(vec4);
+}
+
+static float maxError(const std::vector<std::vector<mat4>>& a, const std::vector<std::vector<mat4>>& b){
+    float error = 0;
+    for(int i = 0 ; i < (int)a.size() ; ++i){
+        for(int j = 0 ; j < (int)a[i].size() ; ++j){
+            for(int c = 0 ; c < 4 ; ++c){
+                vec4 d = glm::abs(a[i][j][c] - b[i][j][c]);
+                error = glm::max(error,glm::max(glm::max(d.x,d.y),glm::max(d.z,d.w)));
+            }
+        }
+    }
+    return error;
+}
+
+void animationCompressionBenchmark(int numInstances){
+    std::mt19937 gen(9231);
+    Animation anim;
+    smoothAnimation(anim,80,60,121,gen);
+
+    SkeletonAnimation skeletonAnim;
+    skeletonAnim.create(anim);
+
+    CompressedAnimation compressed;
+    compressed.create(anim);
+
+    AnimationCompressionSettings lossless;
+    lossless.positionTolerance = 0;
+    lossless.rotationTolerance = 0;
+    lossless.scaleTolerance = 0;
+    lossless.quantize = false;
+    CompressedAnimation uncompressed;
+    uncompressed.create(anim,lossless);
+
+    //every instance plays the animation from a different start time with 60 fps
+    const int steps = 5;
+    const double dt = 1.0 / 60.0;
+    std::vector<double> startTimes(numInstances);
+    std::uniform_real_distribution<double> timeDis(0,anim.duration.count());
+    for(double& t : startTimes)
+        t = timeDis(gen);
+    auto timeAt = [&](int instance, int step){
+        return animationtime_t(std::fmod(startTimes[instance] + step * dt,anim.duration.count()));
+    };
+
+    std::vector<std::vector<mat4>> reference(numInstances), flat(numInstances,std::vector<mat4>(anim.boneCount));
+    std::vector<std::vector<mat4>> result(numInstances,std::vector<mat4>(anim.boneCount));
+    std::vector<std::vector<mat4>> losslessResult(numInstances,std::vector<mat4>(anim.boneCount));
+    Timer timer;
+
+    timer.start();
+    for(int s = 0 ; s < steps ; ++s){
+        for(int i = 0 ; i < numInstances ; ++i){
+            AnimationFrame frame;
+            anim.getFrame(timeAt(i,s),frame);
+            reference[i] = frame.getBoneMatrices(anim);
+        }
+    }
+    timer.stop();
+    double t0 = timer.getTimeMS();
+
+    std::vector<mat4> worldMatrices;
+    timer.start();
+    for(int s = 0 ; s < steps ; ++s){
+        for(int i = 0 ; i < numInstances ; ++i){
+            skeletonAnim.evaluate(timeAt(i,s),flat[i].data(),worldMatrices);
+        }
+    }
+    timer.stop();
+    double t1 = timer.getTimeMS();
+
+    std::vector<AnimationCursor> cursors(numInstances);
+    for(AnimationCursor& c : cursors)
+        compressed.initCursor(c);
+    SkeletonPose pose;
+    timer.start();
+    for(int s = 0 ; s < steps ; ++s){
+        for(int i = 0 ; i < numInstances ; ++i){
+            compressed.evaluate(timeAt(i,s),cursors[i],pose,result[i].data(),worldMatrices);
+        }
+    }
+    timer.stop();
+    double t2 = timer.getTimeMS();
+
+    for(AnimationCursor& c : cursors)
+        uncompressed.initCursor(c);
+    for(int s = 0 ; s < steps ; ++s){
+        for(int i = 0 ; i < numInstances ; ++i){
+            uncompressed.evaluate(timeAt(i,s),cursors[i],pose,losslessResult[i].data(),worldMatrices);
+        }
+    }
+
+    float compressedError = maxError(reference,result);
+    float losslessError = maxError(reference,losslessResult);
+    bool success = compressedError < 0.01f && losslessError < 1e-4f;
+
+    int keys = skeletonAnim.frameCount * skeletonAnim.skeleton.animatedCount * 3;
+    cout << "Animation compression, " << numInstances << " instances, " << steps << " steps, "
+         << skeletonAnim.skeleton.nodeCount << " nodes, " << anim.frameCount << " frames" << endl;
+    cout << "  memory AnimationFrame: " << frameMemory(anim) / 1024 << "kb, SkeletonAnimation: " << skeletonMemory(skeletonAnim) / 1024
+         << "kb, compressed: " << compressed.memoryUsage() / 1024 << "kb (" << compressed.numKeys() << " of " << keys << " keys)" << endl;
+    cout << "  sample AnimationFrame: " << t0 << "ms, SkeletonAnimation: " << t1 << "ms, compressed: " << t2 << "ms" << endl;
+    cout << "  max error compressed: " << compressedError << ", lossless: " << losslessError << endl;
+    cout << "Animation compression test: " << (success ? "Success" : "Fail") << endl;
+}
+
+}
+}
@@ -0,0 +1,143 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include <saiga/tests/test.h>
+
+#include "saiga/camera/camera.h"
+#include "saiga/geometry/frustumCulling.h"
+#include "saiga/rendering/sceneIndex.h"
+#include "saiga/time/timer.h"
+#include <saiga/util/assert.h>
+
+#include <random>
+#include <algorithm>
+
+namespace Saiga {
+namespace Tests {
+
+using namespace std;
+
+void cullingBenchmark(int numObjects, int numLights){
+    std::mt19937 gen(3462);
+    std::uniform_real_distribution<float> posDis(-1000,1000);
+    std::uniform_real_distribution<float> dis(-1,1);
+
+    PerspectiveCamera cam;
+    cam.setProj(60.0f,16.0f / 9.0f,0.1f,500.0f);
+    cam.setView(vec3(0,20,0),vec3(100,0,50),vec3(0,1,0));
+    cam.recalculatePlanes();
+    FrustumCuller culler(cam.planes);
+
+    bool success = true;
+    Timer timer;
+
+    //====================== lights ======================
+
+    std::vector<Sphere> lights(numLights);
+    SphereArray lightArray;
+    lightArray.resize(numLights);
+    for(int i = 0 ; i < numLights ; ++i){
+        lights[i] = Sphere(vec3(posDis(gen),10 * dis(gen),posDis(gen)),5 + 20 * (dis(gen) + 1));
+        lightArray.set(i,lights[i]);
+    }
+
+    std::vector<unsigned char> reference(numLights), visible(numLights);
+    timer.start();
+    for(int i = 0 ; i < numLights ; ++i){
+        reference[i] = cam.sphereInFrustum(lights[i]) != Camera::OUTSIDE;
+    }
+    timer.stop();
+    double tLightScalar = timer.getTimeMS();
+
+    timer.start();
+    int visibleLights = culler.cullSpheres(lightArray,visible.data());
+    timer.stop();
+    double tLightBatch = timer.getTimeMS();
+    success &= reference == visible;
+
+    //====================== objects ======================
+
+    std::vector<Object3D> objects(numObjects);
+    AABB localBounds(vec3(-1),vec3(1));
+    for(Object3D& obj : objects){
+        obj.setPosition(vec3(posDis(gen),10 * dis(gen),posDis(gen)));
+        obj.rot = glm::normalize(quat(dis(gen),dis(gen),dis(gen),dis(gen)));
+        obj.setScale(vec3(1.5f + dis(gen)));
+        obj.calculateModel();
+    }
+
+    SceneIndex index;
+    timer.start();
+    std::vector<int> handles(numObjects);
+    for(int i = 0 ; i < numObjects ; ++i)
+        handles[i] = index.add(&objects[i],localBounds);
+    timer.stop();
+    double tBuild = timer.getTimeMS();
+
+    std::vector<Object3D*> visibleObjects;
+    double tScalar = 0, tBatch = 0, tTree = 0, tUpdate = 0;
+    int visibleCount = 0;
+    int frames = 3;
+    for(int frame = 0 ; frame < frames ; ++frame){
+        //move 10% of the objects
+        if(frame > 0){
+            timer.start();
+            for(int i = 0 ; i < numObjects ; i += 10){
+                int id = (i + frame) % numObjects;
+                objects[id].translateGlobal(vec3(dis(gen),0,dis(gen)) * (frame == 2 ? 10.0f : 0.05f));
+                objects[id].calculateModel();
+                index.update(handles[id]);
+            }
+            timer.stop();
+            tUpdate += timer.getTimeMS();
+        }
+
+        std::vector<AABB> boxes(numObjects);
+        AABBArray boxArray;
+        boxArray.resize(numObjects);
+        for(int i = 0 ; i < numObjects ; ++i){
+            boxes[i] = SceneIndex::transformAABB(localBounds,objects[i].model);
+            boxArray.set(i,boxes[i]);
+        }
+
+        //reference: one scalar test per object
+        std::vector<Object3D*> ref;
+        timer.start();
+        for(int i = 0 ; i < numObjects ; ++i){
+            if(culler.aabbVisible(boxes[i]))
+                ref.push_back(&objects[i]);
+        }
+        timer.stop();
+        tScalar += timer.getTimeMS();
+
+        std::vector<unsigned char> objectVisible(numObjects);
+        timer.start();
+        int count = culler.cullAABBs(boxArray,objectVisible.data());
+        timer.stop();
+        tBatch += timer.getTimeMS();
+        success &= count == (int)ref.size();
+
+        timer.start();
+        index.cull(&cam,visibleObjects);
+        timer.stop();
+        tTree += timer.getTimeMS();
+
+        std::sort(ref.begin(),ref.end());
+        std::sort(visibleObjects.begin(),visibleObjects.end());
+        success &= ref == visibleObjects;
+        visibleCount = ref.size();
+    }
+
+    cout << "Light culling, " << numLights << " lights, " << visibleLights << " visible" << endl;
+    cout << "  Camera::sphereInFrustum: " << tLightScalar << "ms, batched: " << tLightBatch << "ms" << endl;
+    cout << "Object culling, " << numObjects << " objects, " << visibleCount << " visible, tree height " << index.tree.height() << endl;
+    cout << "  build: " << tBuild << "ms, update 10%: " << tUpdate / (frames - 1) << "ms" << endl;
+    cout << "  scalar: " << tScalar / frames << "ms, batched: " << tBatch / frames << "ms, tree: " << tTree / frames << "ms" << endl;
+    cout << "Culling test: " << (success ? "Success" : "Fail") << endl;
+}
+
+}
+}
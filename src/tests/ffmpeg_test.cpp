@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include <saiga/tests/test.h>
+
+#ifdef SAIGA_USE_FFMPEG
+
+#include "saiga/ffmpeg/ffmpegEncoder.h"
+#include "saiga/time/timer.h"
+#include <saiga/util/assert.h>
+
+#include <algorithm>
+
+namespace Saiga {
+namespace Tests {
+
+using namespace std;
+
+//A moving color gradient. Each row has one color, so generating the image is only limited by the memory bandwidth.
+static void syntheticFrame(uint8_t* data, int linesize, int width, int height, int frame){
+    for(int y = 0 ; y < height ; ++y){
+        uint8_t c = (y + frame * 4) & 255;
+        uint32_t color = c | ((255 - c) << 8) | ((c / 2) << 16) | (255u << 24);
+        uint32_t* row = reinterpret_cast<uint32_t*>(data + y * linesize);
+        std::fill(row, row + width, color);
+    }
+}
+
+static double encodeFrames(int width, int height, int frames, int scaleThreads, bool zeroCopy){
+    FFMPEGEncoder encoder(50, scaleThreads);
+    encoder.startEncoding("encoderBenchmark.mp4", width, height, width, height, 60, 40000000, AV_CODEC_ID_MPEG4);
+
+    Timer timer;
+    timer.start();
+    for(int i = 0 ; i < frames ; ++i){
+        if(zeroCopy){
+            AVFrame* frame = encoder.getInputFrame();
+            syntheticFrame(frame->data[0], frame->linesize[0], width, height, i);
+            encoder.addFrame(frame);
+        }else{
+            auto img = encoder.getFrameBuffer();
+            syntheticFrame(img->getRawData(), img->getBytesPerRow(), width, height, i);
+            encoder.addFrame(img);
+        }
+    }
+    encoder.finishEncoding();
+    timer.stop();
+
+    SAIGA_ASSERT(encoder.encodedFrames() == frames);
+    return timer.getTimeMS();
+}
+
+void videoEncoderBenchmark(int width, int height, int frames){
+    cout << "Video encoding " << frames << " frames of " << width << "x" << height << " (MPEG4)" << endl;
+
+    double t1 = encodeFrames(width, height, frames, 1, false);
+    cout << "  1 scale context,  Image:   " << t1 << "ms (" << frames / (t1 / 1000.0) << " fps)" << endl;
+
+    double t2 = encodeFrames(width, height, frames, -1, false);
+    cout << "  n scale contexts, Image:   " << t2 << "ms (" << frames / (t2 / 1000.0) << " fps)" << endl;
+
+    double t3 = encodeFrames(width, height, frames, -1, true);
+    cout << "  n scale contexts, AVFrame: " << t3 << "ms (" << frames / (t3 / 1000.0) << " fps)" << endl;
+}
+
+}
+}
+
+#else
+
+namespace Saiga {
+namespace Tests {
+
+void videoEncoderBenchmark(int width, int height, int frames){
+    std::cout << "videoEncoderBenchmark: Saiga was compiled without ffmpeg." << std::endl;
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,150 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include <saiga/tests/test.h>
+
+#include "saiga/text/skylinePacker.h"
+#include "saiga/text/codePointTable.h"
+#include "saiga/time/timer.h"
+#include <saiga/util/assert.h>
+
+#include <random>
+#include <map>
+#include <climits>
+
+namespace Saiga {
+namespace Tests {
+
+using namespace std;
+
+//Checks that every rectangle is inside [0,width)x[0,height) and that no two rectangles overlap.
+static bool validPacking(const std::vector<glm::ivec2>& sizes, const std::vector<glm::ivec2>& positions, int width, int height){
+    std::vector<unsigned char> used(width * height, 0);
+    for(int i = 0 ; i < (int)sizes.size() ; ++i){
+        glm::ivec2 p = positions[i], s = sizes[i];
+        if(p.x < 0 || p.y < 0 || p.x + s.x > width || p.y + s.y > height)
+            return false;
+        for(int y = p.y ; y < p.y + s.y ; ++y){
+            for(int x = p.x ; x < p.x + s.x ; ++x){
+                if(used[y * width + x])
+                    return false;
+                used[y * width + x] = 1;
+            }
+        }
+    }
+    return true;
+}
+
+void glyphAtlasBenchmark(int numGlyphs){
+    //sizes of sdf glyphs of a 40px font, some of them very wide or flat
+    std::mt19937 gen(6271);
+    std::uniform_int_distribution<int> sizeDis(8,60);
+    std::vector<glm::ivec2> sizes(numGlyphs);
+    long long area = 0;
+    for(glm::ivec2& s : sizes){
+        s = glm::ivec2(sizeDis(gen),sizeDis(gen));
+        area += s.x * s.y;
+    }
+
+    bool success = true;
+    Timer timer;
+
+    //all at once, like TextureAtlas::loadFont
+    int width = 1024;
+    int height = 64;
+    std::vector<glm::ivec2> positions;
+    timer.start();
+    while(!SkylinePacker(width,height).pack(sizes,positions))
+        height *= 2;
+    timer.stop();
+    double t0 = timer.getTimeMS();
+    int usedHeight = 0;
+    for(int i = 0 ; i < numGlyphs ; ++i)
+        usedHeight = std::max(usedHeight,positions[i].y + sizes[i].y);
+    success &= validPacking(sizes,positions,width,height);
+
+    //one by one until the atlas is full, like TextureAtlas::loadFontDynamic
+    SkylinePacker packer(width,width);
+    std::vector<glm::ivec2> incrementalSizes, incrementalPositions;
+    long long incrementalArea = 0;
+    timer.start();
+    for(glm::ivec2 s : sizes){
+        glm::ivec2 p;
+        if(!packer.pack(s.x,s.y,p))
+            break;
+        incrementalSizes.push_back(s);
+        incrementalPositions.push_back(p);
+        incrementalArea += s.x * s.y;
+    }
+    timer.stop();
+    double t1 = timer.getTimeMS();
+    success &= validPacking(incrementalSizes,incrementalPositions,width,width);
+    //a rectangle that can never fit
+    glm::ivec2 p;
+    success &= !packer.pack(width + 1,1,p);
+
+    cout << "Skyline packing of " << numGlyphs << " glyphs into width " << width << endl;
+    cout << "  all at once: " << t0 << "ms, used height " << usedHeight
+         << ", fill rate " << double(area) / (double(width) * usedHeight) << endl;
+    cout << "  one by one: " << incrementalSizes.size() << " glyphs in " << t1 << "ms until the "
+         << width << "x" << width << " atlas was full, fill rate " << double(incrementalArea) / (double(width) * width) << endl;
+
+    //code points of a few blocks: latin, cyrillic, cjk, emoji
+    int blocks[4][2] = { {0,0x24F}, {0x400,0x4FF}, {0x4E00,0x9FFF}, {0x1F600,0x1F64F} };
+    CodePointTable table;
+    std::map<int,int> reference;
+    std::uniform_int_distribution<int> blockDis(0,3);
+    for(int i = 0 ; i < numGlyphs ; ++i){
+        int* b = blocks[blockDis(gen)];
+        int c = std::uniform_int_distribution<int>(b[0],b[1])(gen);
+        success &= table.set(c,i);
+        reference[c] = i;
+    }
+
+    //invalid code points are rejected and do not allocate pages
+    int pages = table.allocatedPages();
+    int invalid[] = {-1, -256, INT_MIN, CodePointTable::maxCodePoint + 1, INT_MAX};
+    for(int c : invalid){
+        success &= !table.set(c,0);
+        success &= table.get(c) == -1;
+    }
+    success &= table.allocatedPages() == pages;
+    //only the pages of the used blocks: 3 latin, 1 cyrillic, 82 cjk, 1 emoji
+    success &= pages <= 3 + 1 + 82 + 1;
+
+    int numLookups = 1000000;
+    std::uniform_int_distribution<int> lookupDis(-1000,0x1F700);
+    std::vector<int> lookups(numLookups);
+    for(int& c : lookups)
+        c = lookupDis(gen);
+
+    long long sum0 = 0, sum1 = 0;
+    timer.start();
+    for(int c : lookups){
+        auto it = reference.find(c);
+        sum0 += it == reference.end() ? -1 : it->second;
+    }
+    timer.stop();
+    double t2 = timer.getTimeMS();
+
+    timer.start();
+    for(int c : lookups)
+        sum1 += table.get(c);
+    timer.stop();
+    double t3 = timer.getTimeMS();
+    success &= sum0 == sum1;
+
+    for(auto& r : reference)
+        success &= table.get(r.first) == r.second;
+
+    cout << "Code point lookup of " << reference.size() << " characters in " << pages << " pages, " << numLookups << " lookups" << endl;
+    cout << "  std::map: " << t2 << "ms, CodePointTable: " << t3 << "ms" << endl;
+
+    cout << "Glyph atlas test: " << (success ? "Success" : "Fail") << endl;
+}
+
+}
+}
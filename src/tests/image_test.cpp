@@ -0,0 +1,248 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include <saiga/tests/test.h>
+
+#include "saiga/image/templatedImage.h"
+#include "saiga/time/timer.h"
+#include <saiga/util/assert.h>
+
+#include <random>
+#include <algorithm>
+
+namespace Saiga {
+namespace Tests {
+
+using namespace std;
+
+typedef TemplatedImage<3,8,ImageElementFormat::UnsignedNormalized> rgb8_t;
+typedef TemplatedImage<4,8,ImageElementFormat::UnsignedNormalized> rgba8_t;
+typedef TemplatedImage<4,32,ImageElementFormat::FloatingPoint> rgbaf_t;
+
+//The texel wise conversion, which was used before the row kernels.
+//All conversions write to preallocated images, so the page faults are not measured.
+template<typename SRC, typename DST>
+static void referenceConvert(SRC& src, DST& dst){
+    for(int y = 0 ; y < src.height ; ++y){
+        for(int x = 0 ; x < src.width ; ++x){
+            dst.getTexel(x,y).fromVec4(src.getTexel(x,y).toVec4());
+        }
+    }
+}
+
+template<typename IMG, typename OP>
+static void referenceColorSpace(IMG& img, OP op){
+    for(int y = 0 ; y < img.height ; ++y){
+        for(int x = 0 ; x < img.width ; ++x){
+            auto& t = img.getTexel(x,y);
+            vec4 c = t.toVec4();
+            t.fromVec4(vec4(op(vec3(c)),c.w));
+        }
+    }
+}
+
+template<typename IMG>
+static bool sameColors(IMG& a, IMG& b, int channels){
+    for(int y = 0 ; y < a.height ; ++y){
+        auto* ra = reinterpret_cast<typename IMG::TexelType::elementType*>(a.rowPointer(y));
+        auto* rb = reinterpret_cast<typename IMG::TexelType::elementType*>(b.rowPointer(y));
+        int stride = sizeof(typename IMG::TexelType) / sizeof(*ra);
+        for(int x = 0 ; x < a.width ; ++x){
+            for(int c = 0 ; c < channels ; ++c){
+                if(ra[x * stride + c] != rb[x * stride + c])
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
+template<typename IMG>
+static void randomImage(IMG& img, std::mt19937& gen){
+    std::uniform_int_distribution<int> dis(0,255);
+    for(auto& d : img.data)
+        d = dis(gen);
+}
+
+static void printResult(const char* name, double reference, double serial, double parallel, bool correct){
+    cout << "  " << name << ": texel wise " << reference << "ms, rows " << serial << "ms, parallel rows " << parallel << "ms"
+         << (correct ? "" : " (WRONG RESULT)") << endl;
+}
+
+void imageConversionBenchmark(int width, int height){
+    std::mt19937 gen(8736);
+    bool success = true;
+    Timer timer;
+
+    cout << "Image conversion " << width << "x" << height << endl;
+
+    rgba8_t rgba(width,height);
+    rgb8_t rgb(width,height);
+    randomImage(rgba,gen);
+    randomImage(rgb,gen);
+
+    {
+        //the simd kernels against the scalar versions for all remainder lengths.
+        //the floats are partly outside of [0,1] to test the clamping.
+        std::uniform_real_distribution<float> fdis(-0.5f,1.5f);
+        std::uniform_int_distribution<int> dis(0,255);
+        bool correct = true;
+        for(int n = 0 ; n < 70 ; ++n){
+            std::vector<uint8_t> bytes(n * 4), b1(n * 4), b2(n * 4);
+            std::vector<float> floats(n * 4), f1(n * 4), f2(n * 4);
+            for(auto& b : bytes) b = dis(gen);
+            for(auto& f : floats) f = fdis(gen);
+
+            PixelConversion::u8ToFloat(bytes.data(),f1.data(),n * 4);
+            PixelConversion::Scalar::u8ToFloat(bytes.data(),f2.data(),n * 4);
+            correct &= f1 == f2;
+
+            PixelConversion::floatToU8(floats.data(),b1.data(),n * 4);
+            PixelConversion::Scalar::floatToU8(floats.data(),b2.data(),n * 4);
+            correct &= b1 == b2;
+
+            PixelConversion::rgbToRgba(bytes.data(),b1.data(),n,17);
+            PixelConversion::Scalar::rgbToRgba(bytes.data(),b2.data(),n,17);
+            correct &= b1 == b2;
+
+            PixelConversion::rgbaToRgb(bytes.data(),b1.data(),n);
+            PixelConversion::Scalar::rgbaToRgb(bytes.data(),b2.data(),n);
+            correct &= std::equal(b1.begin(),b1.begin() + n * 3,b2.begin());
+
+            b1 = bytes; b2 = bytes;
+            PixelConversion::flipRBRgba(b1.data(),n);
+            PixelConversion::Scalar::flipRBRgba(b2.data(),n);
+            correct &= b1 == b2;
+        }
+        success &= correct;
+        cout << "  simd kernels == scalar kernels: " << (correct ? "yes" : "no") << endl;
+    }
+
+    //u8 -> float
+    rgbaf_t floatRef(width,height);
+    {
+        timer.start(); referenceConvert(rgba,floatRef); timer.stop();
+        double t0 = timer.getTimeMS();
+        rgbaf_t a(width,height), b(width,height);
+        timer.start(); rgba.convertImage(a); timer.stop();
+        double t1 = timer.getTimeMS();
+        timer.start(); rgba.convertImage(b,true); timer.stop();
+        double t2 = timer.getTimeMS();
+        bool correct = a.data == floatRef.data && b.data == floatRef.data;
+        success &= correct;
+        printResult("RGBA8 -> RGBA32F",t0,t1,t2,correct);
+    }
+
+    //float -> u8
+    {
+        rgba8_t ref(width,height);
+        timer.start(); referenceConvert(floatRef,ref); timer.stop();
+        double t0 = timer.getTimeMS();
+        rgba8_t a(width,height), b(width,height);
+        timer.start(); floatRef.convertImage(a); timer.stop();
+        double t1 = timer.getTimeMS();
+        timer.start(); floatRef.convertImage(b,true); timer.stop();
+        double t2 = timer.getTimeMS();
+        bool correct = a.data == ref.data && b.data == ref.data;
+        success &= correct;
+        printResult("RGBA32F -> RGBA8",t0,t1,t2,correct);
+    }
+
+    //rgb -> rgba
+    {
+        rgba8_t ref(width,height);
+        timer.start(); referenceConvert(rgb,ref); timer.stop();
+        double t0 = timer.getTimeMS();
+        rgba8_t a(width,height), b(width,height);
+        timer.start(); rgb.convertImage(a); timer.stop();
+        double t1 = timer.getTimeMS();
+        timer.start(); rgb.convertImage(b,true); timer.stop();
+        double t2 = timer.getTimeMS();
+        bool correct = a.data == ref.data && b.data == ref.data;
+        success &= correct;
+        printResult("RGB8 -> RGBA8   ",t0,t1,t2,correct);
+    }
+
+    //rgba -> rgb
+    {
+        rgb8_t ref(width,height);
+        timer.start(); referenceConvert(rgba,ref); timer.stop();
+        double t0 = timer.getTimeMS();
+        rgb8_t a(width,height), b(width,height);
+        timer.start(); rgba.convertImage(a); timer.stop();
+        double t1 = timer.getTimeMS();
+        timer.start(); rgba.convertImage(b,true); timer.stop();
+        double t2 = timer.getTimeMS();
+        bool correct = sameColors(a,ref,3) && sameColors(b,ref,3);
+        success &= correct;
+        printResult("RGBA8 -> RGB8   ",t0,t1,t2,correct);
+    }
+
+    //flip red and blue
+    {
+        rgba8_t ref = rgba, a = rgba;
+        timer.start();
+        for(int y = 0 ; y < height ; ++y){
+            for(int x = 0 ; x < width ; ++x){
+                auto& t = ref.getTexel(x,y);
+                std::swap(t.r,t.b);
+            }
+        }
+        timer.stop();
+        double t0 = timer.getTimeMS();
+        timer.start(); a.flipRB(); timer.stop();
+        double t1 = timer.getTimeMS();
+        timer.start(); a.flipRB(true); timer.stop();
+        double t2 = timer.getTimeMS();
+        a.flipRB();
+        bool correct = a.data == ref.data;
+        success &= correct;
+        printResult("flipRB RGBA8    ",t0,t1,t2,correct);
+    }
+
+    //srgb <-> linear. The alpha channel is not compared, because the texel wise version can change it by rounding.
+    {
+        rgba8_t ref = rgba, a = rgba, b = rgba;
+        timer.start(); referenceColorSpace(ref,[](vec3 c){ return Color::linearrgb2srgb(c); }); timer.stop();
+        double t0 = timer.getTimeMS();
+        timer.start(); a.toSRGB(); timer.stop();
+        double t1 = timer.getTimeMS();
+        timer.start(); b.toSRGB(true); timer.stop();
+        double t2 = timer.getTimeMS();
+        bool correct = sameColors(a,ref,3) && sameColors(b,ref,3);
+        success &= correct;
+        printResult("toSRGB RGBA8    ",t0,t1,t2,correct);
+
+        timer.start(); referenceColorSpace(ref,[](vec3 c){ return Color::srgb2linearrgb(c); }); timer.stop();
+        t0 = timer.getTimeMS();
+        timer.start(); a.toLinearRGB(); timer.stop();
+        t1 = timer.getTimeMS();
+        timer.start(); b.toLinearRGB(true); timer.stop();
+        t2 = timer.getTimeMS();
+        correct = sameColors(a,ref,3) && sameColors(b,ref,3);
+        success &= correct;
+        printResult("toLinear RGBA8  ",t0,t1,t2,correct);
+    }
+
+    {
+        //float images use the exact formula, only the parallel mode is faster
+        rgbaf_t ref = floatRef, a = floatRef, b = floatRef;
+        timer.start(); referenceColorSpace(ref,[](vec3 c){ return Color::linearrgb2srgb(c); }); timer.stop();
+        double t0 = timer.getTimeMS();
+        timer.start(); a.toSRGB(); timer.stop();
+        double t1 = timer.getTimeMS();
+        timer.start(); b.toSRGB(true); timer.stop();
+        double t2 = timer.getTimeMS();
+        bool correct = a.data == ref.data && b.data == ref.data;
+        success &= correct;
+        printResult("toSRGB RGBA32F  ",t0,t1,t2,correct);
+    }
+
+    cout << "Image conversion test: " << (success ? "Success" : "Fail") << endl;
+}
+
+}
+}
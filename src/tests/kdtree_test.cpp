@@ -0,0 +1,210 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include <saiga/tests/test.h>
+
+#include "saiga/geometry/kdtree.h"
+#include "saiga/time/timer.h"
+#include <saiga/util/assert.h>
+
+#include <random>
+
+namespace Saiga {
+namespace Tests {
+
+using namespace std;
+
+void kdtreeBenchmark(int numPoints, int numQueries, int k){
+    std::mt19937 mt(9542);
+    std::uniform_real_distribution<float> dis(-100.0f,100.0f);
+
+    std::vector<vec3> points(numPoints);
+    for(vec3& p : points){
+        p = vec3(dis(mt),dis(mt),dis(mt));
+    }
+
+    std::vector<vec3> queries(numQueries);
+    for(vec3& p : queries){
+        p = vec3(dis(mt),dis(mt),dis(mt));
+    }
+
+    Timer timer;
+    KDTree<3,vec3> tree;
+
+    timer.start();
+    tree.createTree(points,1);
+    timer.stop();
+    cout << "KDTree construction (" << numPoints << " points) single threaded: " << timer.getTimeMS() << "ms" << endl;
+
+    timer.start();
+    tree.createTree(points);
+    timer.stop();
+    cout << "KDTree construction (" << numPoints << " points) parallel: " << timer.getTimeMS() << "ms" << endl;
+
+    std::vector<int> indices(numQueries * k);
+    std::vector<float> distances(numQueries * k);
+
+    timer.start();
+    for(int i = 0 ; i < numQueries ; ++i){
+        tree.nearestNeighbours(queries[i],k,indices.data() + i * k,distances.data() + i * k);
+    }
+    timer.stop();
+    double singleTime = timer.getTimeMS();
+
+    std::vector<int> indicesBatch(numQueries * k);
+    std::vector<float> distancesBatch(numQueries * k);
+
+    timer.start();
+    tree.nearestNeighbours(queries.data(),numQueries,k,indicesBatch.data(),distancesBatch.data());
+    timer.stop();
+    double batchTime = timer.getTimeMS();
+
+    cout << k << "-NN queries: " << numQueries << endl;
+    cout << "  Single:  " << singleTime << "ms " << numQueries / (singleTime / 1000.0) << " queries/s" << endl;
+    cout << "  Batched: " << batchTime << "ms " << numQueries / (batchTime / 1000.0) << " queries/s" << endl;
+
+    bool success = indices == indicesBatch && distances == distancesBatch;
+
+    //k = 0 finds nothing
+    success &= tree.nearestNeighbours(queries[0],0,indices.data(),distances.data()) == 0;
+    success &= tree.nearestNeighbours(queries[0],0).empty();
+
+    //compare the distances of a few queries with a linear search
+    std::vector<float> ref(numPoints);
+    for(int i = 0 ; i < std::min(numQueries,100) ; ++i){
+        for(int j = 0 ; j < numPoints ; ++j){
+            vec3 d = points[j] - queries[i];
+            ref[j] = glm::dot(d,d);
+        }
+        std::partial_sort(ref.begin(),ref.begin() + k,ref.end());
+        for(int j = 0 ; j < k ; ++j){
+            if(ref[j] != distances[i * k + j])
+                success = false;
+        }
+        vec3 d = tree.getPoint(indices[i * k]) - queries[i];
+        if(glm::dot(d,d) != ref[0])
+            success = false;
+    }
+
+    cout << "KDTree test: " << (success ? "Success" : "Fail") << endl;
+}
+
+void kdtreeApproximationBenchmark(int numPoints, int numQueries, int k){
+    std::mt19937 mt(2356);
+    std::uniform_real_distribution<float> dis(-100.0f,100.0f);
+
+    std::vector<vec3> points(numPoints);
+    for(vec3& p : points){
+        p = vec3(dis(mt),dis(mt),dis(mt));
+    }
+
+    std::vector<vec3> queries(numQueries);
+    for(vec3& p : queries){
+        p = vec3(dis(mt),dis(mt),dis(mt));
+    }
+
+    KDTree<3,vec3> tree(points);
+    Timer timer;
+
+    std::vector<int> exactIndices(numQueries * k);
+    std::vector<float> exactDistances(numQueries * k);
+    timer.start();
+    for(int i = 0 ; i < numQueries ; ++i){
+        tree.nearestNeighbours(queries[i],k,exactIndices.data() + i * k,exactDistances.data() + i * k);
+    }
+    timer.stop();
+    double exactTime = timer.getTimeMS();
+
+    cout << "KDTree approximate " << k << "-NN (" << numPoints << " points, " << numQueries << " queries)" << endl;
+    cout << "  exact:             " << exactTime / numQueries * 1000.0 << "us/query" << endl;
+
+    std::vector<int> indices(numQueries * k);
+    std::vector<float> distances(numQueries * k);
+    bool success = true;
+
+    //recall: fraction of the exact k nearest neighbours which are also found by the approximate search
+    //distance ratio: average ratio between the approximate and the exact k-th distance
+    auto measure = [&](const std::string& name, const KDTree<3,vec3>::Approximation& approx, double minRecall){
+        timer.start();
+        for(int i = 0 ; i < numQueries ; ++i){
+            tree.nearestNeighbours(queries[i],k,indices.data() + i * k,distances.data() + i * k,approx);
+        }
+        timer.stop();
+        double time = timer.getTimeMS();
+
+        long found = 0;
+        double ratio = 0;
+        std::vector<int> exact(k), approxRes(k), both(k);
+        for(int i = 0 ; i < numQueries ; ++i){
+            exact.assign(exactIndices.begin() + i * k,exactIndices.begin() + (i + 1) * k);
+            approxRes.assign(indices.begin() + i * k,indices.begin() + (i + 1) * k);
+            std::sort(exact.begin(),exact.end());
+            std::sort(approxRes.begin(),approxRes.end());
+            found += std::set_intersection(exact.begin(),exact.end(),approxRes.begin(),approxRes.end(),both.begin()) - both.begin();
+            ratio += sqrt(distances[i * k + k - 1] / exactDistances[i * k + k - 1]);
+
+            for(int j = 0 ; j < k ; ++j){
+                float d = distances[i * k + j], e = exactDistances[i * k + j];
+                //the j-th approximate neighbour can not be closer than the exact one
+                success &= d >= e;
+                //the eps guarantee: at most (1+eps) times the exact distance (the distances are squared)
+                if(approx.maxVisits < 0)
+                    success &= d <= e * (1 + approx.eps) * (1 + approx.eps) * 1.0001f;
+            }
+        }
+        double recall = double(found) / (double(numQueries) * k);
+        success &= recall >= minRecall;
+
+        cout << "  " << name << time / numQueries * 1000.0 << "us/query, speedup " << exactTime / time
+             << ", recall " << recall << ", distance ratio " << ratio / numQueries << endl;
+    };
+
+    //the recall bounds are well below the measured values for uniform points
+    KDTree<3,vec3>::Approximation approx;
+    approx.eps = 0.5f;
+    measure("eps = 0.5:         ",approx,0.9);
+    approx.eps = 1.0f;
+    measure("eps = 1:           ",approx,0.8);
+    approx.eps = 0;
+    approx.maxVisits = 256;
+    measure("maxVisits = 256:   ",approx,0.9);
+    approx.maxVisits = 64;
+    measure("maxVisits = 64:    ",approx,0.5);
+
+    //the radius is chosen so that every query finds about k points
+    float volume = 200.0f * 200.0f * 200.0f;
+    float radius = pow(3.0f * k * volume / (4.0f * glm::pi<float>() * numPoints), 1.0f / 3.0f);
+    std::vector<int> result;
+    long total = 0;
+    timer.start();
+    for(int i = 0 ; i < numQueries ; ++i){
+        result.clear();
+        total += tree.radiusSearch(queries[i],radius,result);
+    }
+    timer.stop();
+    cout << "  radius search:     " << timer.getTimeMS() / numQueries * 1000.0 << "us/query, "
+         << double(total) / numQueries << " points/query" << endl;
+
+    //compare the radius search of a few queries with a linear search
+    std::vector<int> ref;
+    for(int i = 0 ; i < std::min(numQueries,100) ; ++i){
+        ref.clear();
+        for(int j = 0 ; j < numPoints ; ++j){
+            vec3 d = points[j] - queries[i];
+            if(glm::dot(d,d) <= radius * radius)
+                ref.push_back(j);
+        }
+        result.clear();
+        tree.radiusSearch(queries[i],radius,result);
+        std::sort(result.begin(),result.end());
+        success &= result == ref;
+    }
+
+    cout << "KDTree approximation test: " << (success ? "Success" : "Fail") << endl;
+}
+
+}
+}
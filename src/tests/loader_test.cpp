@@ -0,0 +1,193 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include <saiga/tests/test.h>
+
+#include "saiga/util/loader.h"
+#include "saiga/time/timer.h"
+#include <saiga/util/assert.h>
+
+#include <random>
+#include <tuple>
+#include <atomic>
+
+namespace Saiga {
+namespace Tests {
+
+using namespace std;
+
+struct DummyParams{
+    int lod;
+    DummyParams(int lod = 0) : lod(lod){}
+};
+
+static bool operator==(const DummyParams& lhs, const DummyParams& rhs) {
+    return lhs.lod == rhs.lod;
+}
+
+static size_t loaderHash(const DummyParams& params) {
+    return std::hash<int>()(params.lod);
+}
+
+struct DummyAsset{
+    std::string path;
+    size_t bytes;
+};
+
+//Creates the objects without any file access.
+class DummyLoader : public Loader<std::shared_ptr<DummyAsset>,DummyParams>{
+public:
+    std::atomic<int> decoded;
+    DummyLoader() : decoded(0) { addPath("dummy"); }
+    ~DummyLoader(){ waitAsync(); }
+protected:
+    std::shared_ptr<DummyAsset> loadFromFile(const std::string &name, const DummyParams &params){
+        if(name.find("missing") != std::string::npos)
+            return nullptr;
+        decoded++;
+        auto a = std::make_shared<DummyAsset>();
+        a->path = name;
+        a->bytes = 1000 >> params.lod;
+        return a;
+    }
+    size_t memorySize(const std::shared_ptr<DummyAsset>& object){
+        return object->bytes;
+    }
+};
+
+static std::shared_ptr<DummyAsset> dummyAsset(size_t bytes){
+    auto a = std::make_shared<DummyAsset>();
+    a->bytes = bytes;
+    return a;
+}
+
+static std::string assetName(int i){
+    return "asset" + std::to_string(i) + ".dat";
+}
+
+void loaderBenchmark(int numAssets, int numLookups){
+    bool success = true;
+    Timer timer;
+
+    std::mt19937 gen(1243);
+    std::uniform_int_distribution<int> dis(0,numAssets-1);
+    std::vector<int> lookups(numLookups);
+    for(int& l : lookups)
+        l = dis(gen);
+    std::vector<std::string> names(numAssets);
+    for(int i = 0 ; i < numAssets ; ++i)
+        names[i] = assetName(i);
+
+    //the linear search of the previous implementation
+    {
+        std::vector<std::tuple<std::string,DummyParams,std::shared_ptr<DummyAsset>>> objects;
+        for(int i = 0 ; i < numAssets ; ++i)
+            objects.emplace_back(names[i],DummyParams(),std::make_shared<DummyAsset>());
+
+        int linearLookups = std::min(numLookups,10000);
+        size_t found = 0;
+        timer.start();
+        for(int i = 0 ; i < linearLookups ; ++i){
+            const std::string& name = names[lookups[i]];
+            for(auto& o : objects){
+                if(std::get<0>(o) == name && std::get<1>(o) == DummyParams()){
+                    found += std::get<2>(o) != nullptr;
+                    break;
+                }
+            }
+        }
+        timer.stop();
+        success &= found == size_t(linearLookups);
+        cout << "Loader lookup, " << numAssets << " assets" << endl;
+        cout << "  linear search: " << timer.getTimeMS() / linearLookups * 1000 << "us per lookup" << endl;
+    }
+
+    {
+        DummyLoader loader;
+        for(int i = 0 ; i < numAssets ; ++i)
+            loader.put(names[i],dummyAsset(1000));
+        size_t found = 0;
+        timer.start();
+        for(int i = 0 ; i < numLookups ; ++i)
+            found += loader.getLoaded(names[lookups[i]]) != nullptr;
+        timer.stop();
+        success &= found == size_t(numLookups);
+        cout << "  hashed: " << timer.getTimeMS() / numLookups * 1000 << "us per lookup" << endl;
+
+        //same name with different parameters
+        auto a = loader.load(names[0],DummyParams{1});
+        success &= a != loader.getLoaded(names[0]);
+        success &= a == loader.getLoaded(names[0],DummyParams{1});
+    }
+
+    //asynchronous loading
+    {
+        DummyLoader loader;
+        //one more name is needed for the synchronous load below
+        SAIGA_ASSERT(numAssets >= 2);
+        int numAsync = std::min(numAssets - 1,1000);
+        std::vector<std::shared_future<std::shared_ptr<DummyAsset>>> futures;
+        timer.start();
+        for(int i = 0 ; i < numAsync ; ++i)
+            futures.push_back(loader.loadAsync(names[i]));
+        //requests of pending objects share the future
+        auto again = loader.loadAsync(names[0]);
+        auto missing = loader.loadAsync("missing.dat");
+        loader.waitAsync();
+        timer.stop();
+        cout << "  " << numAsync << " asynchronous loads: " << timer.getTimeMS() << "ms" << endl;
+
+        success &= loader.decoded == numAsync;
+        success &= again.get() == futures[0].get();
+        success &= missing.get() == nullptr;
+        success &= loader.numLoadedObjects() == numAsync;
+        for(int i = 0 ; i < numAsync ; ++i){
+            success &= futures[i].get() && futures[i].get() == loader.getLoaded(names[i]);
+        }
+
+        //a synchronous load waits for the pending asynchronous one
+        auto f = loader.loadAsync(names[numAsync]);
+        auto s = loader.load(names[numAsync]);
+        success &= s && f.get() == s;
+
+        //after all futures are gone the asynchronously loaded objects can be evicted
+        futures.clear();
+        again = f = std::shared_future<std::shared_ptr<DummyAsset>>();
+        s = nullptr;
+        loader.setMemoryBudget(1);
+        success &= loader.numLoadedObjects() == 0;
+    }
+
+    //lru eviction
+    {
+        DummyLoader loader;
+        loader.put(names[0],dummyAsset(1000));
+        loader.setPinned(names[0]);
+        auto inUse = dummyAsset(1000);
+        loader.put(names[1],inUse);
+        for(int i = 2 ; i < 100 ; ++i)
+            loader.put(names[i],dummyAsset(1000));
+        success &= loader.getMemoryUsage() == 100 * 1000;
+
+        //touch asset 2, so asset 3 is the least recently used one
+        loader.getLoaded(names[2]);
+        loader.setMemoryBudget(50 * 1000);
+        success &= loader.getMemoryUsage() <= 50 * 1000;
+        success &= loader.numLoadedObjects() == 50;
+        //pinned, in use and recently used objects are kept
+        success &= loader.getLoaded(names[0]) && loader.getLoaded(names[1]) && loader.getLoaded(names[2]);
+        success &= loader.getLoaded(names[99]) != nullptr;
+
+        loader.load(names[3]);
+        success &= loader.getMemoryUsage() <= 50 * 1000;
+        success &= loader.getLoaded(names[3]) != nullptr;
+    }
+
+    cout << "Loader test: " << (success ? "Success" : "Fail") << endl;
+}
+
+}
+}
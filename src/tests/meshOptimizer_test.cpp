@@ -0,0 +1,128 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include <saiga/tests/test.h>
+
+#include "saiga/geometry/triangle_mesh_optimizer.h"
+#include "saiga/time/timer.h"
+#include <saiga/util/assert.h>
+
+#include <random>
+#include <algorithm>
+
+namespace Saiga {
+namespace Tests {
+
+using namespace std;
+
+typedef TriangleMesh<VertexNT,GLuint> Mesh;
+
+//the triangles as sorted position tuples, independent of vertex and face order
+static std::vector<std::vector<float>> triangleSet(const Mesh& mesh){
+    std::vector<std::vector<float>> result;
+    for(const Mesh::Face& f : mesh.faces){
+        GLuint idx[3] = {f.v1,f.v2,f.v3};
+        //rotate the vertex with the smallest position (x, then z) to the front to keep the winding
+        int first = 0;
+        for(int k = 1 ; k < 3 ; ++k){
+            if(mesh.vertices[idx[k]].position.x < mesh.vertices[idx[first]].position.x ||
+                    (mesh.vertices[idx[k]].position.x == mesh.vertices[idx[first]].position.x &&
+                     mesh.vertices[idx[k]].position.z < mesh.vertices[idx[first]].position.z))
+                first = k;
+        }
+        std::vector<float> t;
+        for(int k = 0 ; k < 3 ; ++k){
+            const vec4& p = mesh.vertices[idx[(first + k) % 3]].position;
+            t.push_back(p.x);
+            t.push_back(p.z);
+        }
+        result.push_back(t);
+    }
+    std::sort(result.begin(),result.end());
+    return result;
+}
+
+static bool optimizeAndCheck(const std::string& name, Mesh mesh){
+    std::vector<std::vector<float>> before = triangleSet(mesh);
+    VertexCacheStatistics s16 = vertexCacheStatistics(mesh,16);
+    VertexCacheStatistics s32 = vertexCacheStatistics(mesh,32);
+
+    Timer timer;
+    timer.start();
+    optimizeVertexCache(mesh);
+    timer.stop();
+    double tCache = timer.getTimeMS();
+    timer.start();
+    optimizeVertexFetch(mesh);
+    timer.stop();
+    double tFetch = timer.getTimeMS();
+
+    VertexCacheStatistics o16 = vertexCacheStatistics(mesh,16);
+    VertexCacheStatistics o32 = vertexCacheStatistics(mesh,32);
+
+    //the vertices must be in the order of their first use
+    bool success = triangleSet(mesh) == before;
+    GLuint next = 0;
+    for(const Mesh::Face& f : mesh.faces){
+        GLuint idx[3] = {f.v1,f.v2,f.v3};
+        for(int k = 0 ; k < 3 ; ++k){
+            success &= idx[k] <= next;
+            if(idx[k] == next)
+                next++;
+        }
+    }
+    //a regular grid has 2 triangles per vertex, so the optimum is an ACMR of 0.5
+    success &= o16.acmr() < 0.8 && o32.acmr() < 0.75;
+    success &= o16.acmr() <= s16.acmr() + 0.01;
+
+    cout << "  " << name << ":" << endl;
+    cout << "    before:    " << s16 << endl;
+    cout << "               " << s32 << endl;
+    cout << "    optimized: " << o16 << endl;
+    cout << "               " << o32 << endl;
+    cout << "    time: vertex cache " << tCache << "ms (" << mesh.faces.size() / (tCache * 1000) << " MTriangles/s), vertex fetch " << tFetch << "ms" << endl;
+    return success;
+}
+
+void meshOptimizerBenchmark(int gridSize){
+    Mesh grid;
+    for(int y = 0 ; y < gridSize ; ++y){
+        for(int x = 0 ; x < gridSize ; ++x){
+            grid.addVertex(VertexNT(vec3(x,0,y),vec3(0,1,0),vec2(x,y)));
+        }
+    }
+    for(int y = 0 ; y < gridSize - 1 ; ++y){
+        for(int x = 0 ; x < gridSize - 1 ; ++x){
+            GLuint i = y * gridSize + x;
+            grid.addFace(i,i + gridSize,i + 1);
+            grid.addFace(i + 1,i + gridSize,i + gridSize + 1);
+        }
+    }
+
+    //same mesh in the order of a badly exported file
+    std::mt19937 gen(9835);
+    Mesh shuffled = grid;
+    std::shuffle(shuffled.faces.begin(),shuffled.faces.end(),gen);
+    std::vector<GLuint> perm(grid.vertices.size());
+    for(int i = 0 ; i < (int)perm.size() ; ++i)
+        perm[i] = i;
+    std::shuffle(perm.begin(),perm.end(),gen);
+    for(int i = 0 ; i < (int)perm.size() ; ++i)
+        shuffled.vertices[perm[i]] = grid.vertices[i];
+    for(Mesh::Face& f : shuffled.faces){
+        f.v1 = perm[f.v1];
+        f.v2 = perm[f.v2];
+        f.v3 = perm[f.v3];
+    }
+
+    cout << "Mesh optimizer, " << grid.vertices.size() << " vertices, " << grid.faces.size() << " triangles" << endl;
+    bool success = optimizeAndCheck("row major grid",grid);
+    success &= optimizeAndCheck("shuffled grid",shuffled);
+    cout << "Mesh optimizer test: " << (success ? "Success" : "Fail") << endl;
+}
+
+}
+}
@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include <saiga/tests/test.h>
+
+#include "saiga/geometry/triangle_mesh_simplifier.h"
+#include "saiga/time/timer.h"
+#include <saiga/util/assert.h>
+
+#include <cmath>
+
+namespace Saiga {
+namespace Tests {
+
+using namespace std;
+
+//A unit sphere as triangle soup (3 vertices per face), like the output of ObjLoader2::separateVerticesByGroup.
+//The texture seam is at u = 0 / u = 1 and the poles have a constant texture coordinate.
+static TriangleMesh<VertexNT,GLuint> sphereSoup(int rings, int sectors){
+    auto vertex = [rings,sectors](int r, int s){
+        double theta = M_PI * r / rings;
+        double phi = 2 * M_PI * (s % sectors) / sectors;
+        vec3 p(std::cos(phi) * std::sin(theta),-std::cos(theta),std::sin(phi) * std::sin(theta));
+        if(r == 0 || r == rings)
+            p = vec3(0,r == 0 ? -1 : 1,0);
+        float u = (r == 0 || r == rings) ? 0.5f : float(s) / sectors;
+        return VertexNT(p,p,vec2(u,float(r) / rings));
+    };
+
+    TriangleMesh<VertexNT,GLuint> mesh;
+    for(int r = 0 ; r < rings ; ++r){
+        for(int s = 0 ; s < sectors ; ++s){
+            if(r != rings - 1){
+                int i = mesh.addVertex(vertex(r + 1,s));
+                mesh.addVertex(vertex(r + 1,s + 1));
+                mesh.addVertex(vertex(r,s + 1));
+                mesh.addFace(i,i + 1,i + 2);
+            }
+            if(r != 0){
+                int i = mesh.addVertex(vertex(r + 1,s));
+                mesh.addVertex(vertex(r,s + 1));
+                mesh.addVertex(vertex(r,s));
+                mesh.addFace(i,i + 1,i + 2);
+            }
+        }
+    }
+    //jitter below the weld tolerance, like the rounding errors of an exported file
+    for(int i = 0 ; i < (int)mesh.vertices.size() ; ++i){
+        mesh.vertices[i].position += vec4(((uint32_t(i) * 7919u) % 17u) * 1e-7f,0,0,0);
+    }
+    return mesh;
+}
+
+void meshSimplificationBenchmark(int sectors){
+    int rings = sectors / 2;
+    TriangleMesh<VertexNT,GLuint> soup = sphereSoup(rings,sectors);
+    bool success = true;
+
+    Timer timer;
+
+    //positions and normals only: the seam is closed
+    TriangleMesh<VertexN,GLuint> mesh;
+    mesh.addMesh(soup);
+    int soupVertices = mesh.vertices.size();
+    timer.start();
+    weldVertices(mesh,1e-5f);
+    timer.stop();
+    double tWeld = timer.getTimeMS();
+    int expectedVertices = (rings - 1) * sectors + 2;
+    success &= (int)mesh.vertices.size() == expectedVertices;
+    success &= mesh.faces.size() == soup.faces.size();
+
+    //with texture coordinates the seam vertices are duplicated
+    TriangleMesh<VertexNT,GLuint> textured = soup;
+    weldVertices(textured,1e-5f);
+    success &= (int)textured.vertices.size() == expectedVertices + rings - 1;
+
+    cout << "Mesh simplification, " << mesh.faces.size() << " triangles" << endl;
+    cout << "  weld: " << soupVertices << " -> " << mesh.vertices.size() << " vertices (" << textured.vertices.size()
+         << " with texture seam) in " << tWeld << "ms (" << soupVertices / (tWeld * 1000) << " MVertices/s)" << endl;
+
+    int triangles = mesh.faces.size();
+    std::vector<int> targets = {triangles / 2,triangles / 4,triangles / 10,triangles / 100,triangles / 1000};
+    std::vector<float> errors;
+    timer.start();
+    std::vector<TriangleMesh<VertexN,GLuint>> lods = createLODs(mesh,targets,&errors);
+    timer.stop();
+    double tLod = timer.getTimeMS();
+
+    cout << "  lod chain in " << tLod << "ms (" << triangles / (tLod * 1000) << " MTriangles/s)" << endl;
+    float lastDeviation = 0;
+    for(int l = 0 ; l < (int)lods.size() ; ++l){
+        //distance of the triangles to the unit sphere, measured at the centroids
+        float deviation = 0;
+        for(auto& f : lods[l].faces){
+            vec3 c = (vec3(lods[l].vertices[f.v1].position) + vec3(lods[l].vertices[f.v2].position) + vec3(lods[l].vertices[f.v3].position)) / 3.0f;
+            deviation = std::max(deviation,1 - glm::length(c));
+        }
+        int n = lods[l].faces.size();
+        success &= n <= targets[l] && n >= targets[l] * 0.95;
+        success &= deviation >= lastDeviation * 0.5f;
+        lastDeviation = deviation;
+        cout << "    lod " << l + 1 << ": " << n << " triangles (target " << targets[l] << "), " << lods[l].vertices.size()
+             << " vertices, quadric error " << errors[l] << ", max deviation " << deviation << endl;
+    }
+    //1000 triangles are still a decent sphere
+    success &= lastDeviation < 0.05f;
+
+    cout << "Mesh simplification test: " << (success ? "Success" : "Fail") << endl;
+}
+
+}
+}
@@ -0,0 +1,169 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include <saiga/tests/test.h>
+
+#include "saiga/animation/objLoader2.h"
+#include "saiga/time/timer.h"
+#include <saiga/util/assert.h>
+
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <thread>
+#include <chrono>
+
+namespace Saiga {
+namespace Tests {
+
+using namespace std;
+
+static vec3 gridPosition(int x, int y, int gridSize){
+    return vec3(x / float(gridSize), 0.25f * (x % 3), -y / float(gridSize) + 1e-4f);
+}
+
+//A grid of quads in two material groups. Every second row uses relative indices.
+static void writeGridObj(const std::string& file, const std::string& mtlFile, int gridSize){
+    std::ofstream mtl(mtlFile);
+    mtl << "newmtl first" << endl << "Kd 1 0 0" << endl << "newmtl second" << endl << "Kd 0 1 0" << endl;
+
+    std::ofstream obj(file);
+    obj << "# saiga obj loader test" << endl;
+    obj << "mtllib " << mtlFile.substr(mtlFile.find_last_of("/\\") + 1) << endl;
+    int n = gridSize + 1;
+    for(int y = 0 ; y < n ; ++y){
+        for(int x = 0 ; x < n ; ++x){
+            vec3 p = gridPosition(x,y,gridSize);
+            obj << "v " << p.x << " " << p.y << " " << p.z << endl;
+            obj << "vt " << x / float(gridSize) << " " << y / float(gridSize) << endl;
+            obj << "vn 0 1 0" << endl;
+        }
+    }
+    int total = n * n;
+    for(int y = 0 ; y < gridSize ; ++y){
+        if(y == 0)
+            obj << "usemtl first" << endl;
+        if(y == gridSize / 2)
+            obj << "usemtl second\r" << endl;
+        for(int x = 0 ; x < gridSize ; ++x){
+            int corners[4] = {y * n + x, y * n + x + 1, (y + 1) * n + x + 1, (y + 1) * n + x};
+            obj << "f";
+            for(int c : corners){
+                int i = (y % 2 == 0) ? c + 1 : c - total;
+                obj << " " << i << "/" << i << "/" << i;
+            }
+            obj << endl;
+        }
+    }
+}
+
+//line by line parsing with string streams, like the previous loader did it
+static int referenceParse(const std::string& file){
+    std::ifstream stream(file);
+    std::vector<vec3> vertices;
+    std::vector<int> faces;
+    std::string line, header, corner;
+    while(std::getline(stream,line)){
+        std::stringstream sstream(line);
+        header.clear();
+        sstream >> header;
+        if(header == "v"){
+            vec3 v;
+            sstream >> v.x >> v.y >> v.z;
+            vertices.push_back(v);
+        }else if(header == "f"){
+            while(sstream >> corner)
+                faces.push_back(std::atoi(corner.c_str()));
+        }
+    }
+    return vertices.size();
+}
+
+void objLoaderBenchmark(int gridSize){
+    bool success = true;
+    Timer timer;
+    std::string file = "objLoaderBenchmark.obj";
+    std::string mtlFile = "objLoaderBenchmark.mtl";
+
+    writeGridObj(file,mtlFile,gridSize);
+
+    timer.start();
+    int referenceVertices = referenceParse(file);
+    timer.stop();
+    double t0 = timer.getTimeMS();
+    success &= referenceVertices == (gridSize + 1) * (gridSize + 1);
+
+    //removes a cache of a previous run
+    std::remove((file + ".cache").c_str());
+
+    timer.start();
+    ObjLoader2 loader(file,true);
+    timer.stop();
+    double t1 = timer.getTimeMS();
+
+    timer.start();
+    ObjLoader2 cached(file,true);
+    timer.stop();
+    double t2 = timer.getTimeMS();
+
+    //2 triangles per quad, 2 material groups + the empty default group
+    int n = gridSize + 1;
+    success &= (int)loader.outTriangles.size() == gridSize * gridSize * 2;
+    success &= loader.triangleGroups.size() == 3 && loader.triangleGroups[0].faces == 0;
+    success &= loader.triangleGroups[1].material.name == "first" && loader.triangleGroups[2].material.name == "second";
+    success &= loader.triangleGroups[1].faces == (gridSize / 2) * gridSize * 2;
+
+    for(int y = 0 ; y < gridSize ; ++y){
+        for(int x = 0 ; x < gridSize ; ++x){
+            int corners[4] = {y * n + x, y * n + x + 1, (y + 1) * n + x + 1, (y + 1) * n + x};
+            int expected[6] = {corners[0],corners[1],corners[2],corners[2],corners[3],corners[0]};
+            for(int i = 0 ; i < 6 ; ++i){
+                ObjTriangle& t = loader.outTriangles[(y * gridSize + x) * 2 + i / 3];
+                vec3 p = vec3(loader.outVertices[t.v[i % 3]].position);
+                success &= glm::length(p - gridPosition(expected[i] % n,expected[i] / n,gridSize)) < 1e-4f;
+            }
+        }
+    }
+
+    //the cache contains the same data
+    success &= cached.outVertices.size() == loader.outVertices.size() && cached.outTriangles.size() == loader.outTriangles.size();
+    success &= memcmp(cached.outVertices.data(),loader.outVertices.data(),loader.outVertices.size() * sizeof(VertexNT)) == 0;
+    success &= memcmp(cached.outTriangles.data(),loader.outTriangles.data(),loader.outTriangles.size() * sizeof(ObjTriangle)) == 0;
+    success &= cached.triangleGroups.size() == loader.triangleGroups.size();
+    for(int i = 0 ; i < (int)cached.triangleGroups.size() && i < (int)loader.triangleGroups.size() ; ++i){
+        success &= cached.triangleGroups[i].startFace == loader.triangleGroups[i].startFace;
+        success &= cached.triangleGroups[i].faces == loader.triangleGroups[i].faces;
+        success &= cached.triangleGroups[i].material.name == loader.triangleGroups[i].material.name;
+    }
+
+    cout << "Obj loader " << loader.outVertices.size() << " vertices, " << loader.outTriangles.size() << " triangles" << endl;
+    cout << "  stringstream parsing only " << t0 << "ms, ObjLoader2 " << t1 << "ms, ObjLoader2 from cache " << t2 << "ms" << endl;
+
+    {
+        //an edit with the same file size in the same second invalidates the cache.
+        //the short sleep is for file systems that update the time only once per timer tick.
+        std::string small = "objLoaderCacheTime.obj";
+        std::remove((small + ".cache").c_str());
+        std::ofstream(small) << "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n";
+        ObjLoader2 first(small,true);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        std::ofstream(small) << "v 0 0 0\nv 2 0 0\nv 0 1 0\nf 1 2 3\n";
+        ObjLoader2 second(small,true);
+        success &= first.outVertices.size() == 3 && second.outVertices.size() == 3;
+        success &= first.outVertices[1].position.x == 1 && second.outVertices[1].position.x == 2;
+        std::remove(small.c_str());
+        std::remove((small + ".cache").c_str());
+    }
+
+    std::remove(file.c_str());
+    std::remove(mtlFile.c_str());
+    std::remove((file + ".cache").c_str());
+
+    cout << "Obj loader test: " << (success ? "Success" : "Fail") << endl;
+}
+
+}
+}
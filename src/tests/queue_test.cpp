@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include <saiga/tests/test.h>
+
+#include "saiga/util/lockfreeQueue.h"
+#include "saiga/util/synchronizedBuffer.h"
+#include "saiga/time/timer.h"
+#include <saiga/util/assert.h>
+
+#include <thread>
+#include <vector>
+#include <iostream>
+
+namespace Saiga {
+namespace Tests {
+
+using namespace std;
+
+//Every producer adds the values [1,itemsPerProducer]. The consumers sum up everything they get.
+//Returns the time in ms and checks the sum.
+template<typename Q>
+static double measureQueue(Q& queue, int producers, int consumers, int numItems, bool& success){
+    int itemsPerProducer = numItems / producers;
+    int totalItems = itemsPerProducer * producers;
+    long long expected = (long long)itemsPerProducer * (itemsPerProducer + 1) / 2 * producers;
+
+    std::vector<long long> sums(consumers, 0);
+    std::vector<std::thread> threads;
+
+    Timer timer;
+    timer.start();
+    for(int c = 0 ; c < consumers ; ++c){
+        //distribute the items on the consumers
+        int count = totalItems / consumers + (c < totalItems % consumers ? 1 : 0);
+        threads.emplace_back([&queue,&sums,c,count](){
+            long long sum = 0;
+            for(int i = 0 ; i < count ; ++i){
+                sum += queue.get();
+            }
+            sums[c] = sum;
+        });
+    }
+    for(int p = 0 ; p < producers ; ++p){
+        threads.emplace_back([&queue,itemsPerProducer](){
+            for(int i = 1 ; i <= itemsPerProducer ; ++i){
+                queue.add(i);
+            }
+        });
+    }
+    for(auto& t : threads)
+        t.join();
+    timer.stop();
+
+    long long sum = 0;
+    for(long long s : sums)
+        sum += s;
+    if(sum != expected)
+        success = false;
+    return timer.getTimeMS();
+}
+
+static void printResult(const char* name, int numItems, double time){
+    cout << "  " << name << ": " << time << "ms (" << (numItems / time / 1000.0) << "M items/s)" << endl;
+}
+
+void queueBenchmark(int numItems){
+    const int capacity = 1024;
+    bool success = true;
+
+    {
+        //the single threaded interface
+        SPSCQueue<int> spsc(capacity);
+        MPMCQueue<int> mpmc(capacity);
+        int v;
+        SAIGA_ASSERT(spsc.capacity() == 1024 && mpmc.capacity() == 1024);
+        for(int i = 0 ; i < 1024 ; ++i){
+            success &= spsc.tryAdd(i);
+            success &= mpmc.tryAdd(i);
+        }
+        success &= !spsc.tryAdd(0) && !mpmc.tryAdd(0);
+        for(int i = 0 ; i < 1024 ; ++i){
+            success &= spsc.tryGet(v) && v == i;
+            success &= mpmc.tryGet(v) && v == i;
+        }
+        success &= !spsc.tryGet(v) && !mpmc.tryGet(v);
+        success &= spsc.empty();
+    }
+
+    cout << "Queue throughput with " << numItems << " items, capacity " << capacity << endl;
+
+    cout << " 1 producer, 1 consumer" << endl;
+    {
+        SynchronizedBuffer<int> q(capacity);
+        printResult("SynchronizedBuffer",numItems,measureQueue(q,1,1,numItems,success));
+    }
+    {
+        SPSCQueue<int> q(capacity);
+        printResult("SPSCQueue         ",numItems,measureQueue(q,1,1,numItems,success));
+    }
+    {
+        MPMCQueue<int> q(capacity);
+        printResult("MPMCQueue         ",numItems,measureQueue(q,1,1,numItems,success));
+    }
+
+    cout << " 4 producers, 4 consumers" << endl;
+    {
+        SynchronizedBuffer<int> q(capacity);
+        printResult("SynchronizedBuffer",numItems,measureQueue(q,4,4,numItems,success));
+    }
+    {
+        MPMCQueue<int> q(capacity);
+        printResult("MPMCQueue         ",numItems,measureQueue(q,4,4,numItems,success));
+    }
+
+    cout << "Queue test: " << (success ? "Success" : "Fail") << endl;
+}
+
+}
+}
@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include <saiga/tests/test.h>
+
+#include "saiga/geometry/raytracer.h"
+#include "saiga/time/timer.h"
+#include <saiga/util/assert.h>
+
+#include <random>
+
+namespace Saiga {
+namespace Tests {
+
+using namespace std;
+
+void raytracerBenchmark(int numTriangles, int numRays){
+    std::mt19937 mt(3465);
+    std::uniform_real_distribution<float> pos(-100.0f,100.0f);
+    std::uniform_real_distribution<float> offset(-1.0f,1.0f);
+
+    //small random triangles in a big box
+    std::vector<Triangle> triangles(numTriangles);
+    for(Triangle& t : triangles){
+        vec3 p(pos(mt),pos(mt),pos(mt));
+        t.a = p + vec3(offset(mt),offset(mt),offset(mt));
+        t.b = p + vec3(offset(mt),offset(mt),offset(mt));
+        t.c = p + vec3(offset(mt),offset(mt),offset(mt));
+    }
+
+    std::vector<Ray> rays(numRays);
+    for(Ray& r : rays){
+        vec3 dir = glm::normalize(vec3(offset(mt),offset(mt),offset(mt)));
+        r = Ray(dir,vec3(pos(mt),pos(mt),pos(mt)));
+    }
+
+    Timer timer;
+
+    timer.start();
+    Raytracer rt(triangles);
+    timer.stop();
+    cout << "BVH construction (" << numTriangles << " triangles): " << timer.getTimeMS() << "ms, "
+         << rt.bvh.nodes.size() << " nodes, depth " << rt.bvh.depth() << endl;
+
+
+    std::vector<Raytracer::Result> resBvh(numRays), resBrute(numRays);
+
+    timer.start();
+    for(int i = 0 ; i < numRays ; ++i){
+        resBvh[i] = rt.trace(rays[i]);
+    }
+    timer.stop();
+    double bvhTime = timer.getTimeMS();
+
+    timer.start();
+    for(int i = 0 ; i < numRays ; ++i){
+        resBrute[i] = rt.traceBruteForce(rays[i]);
+    }
+    timer.stop();
+    double bruteTime = timer.getTimeMS();
+
+    std::vector<Raytracer::Result> resBatch(numRays);
+    timer.start();
+    rt.trace(rays.data(),rays.size(),resBatch.data());
+    timer.stop();
+    double batchTime = timer.getTimeMS();
+
+    int hits = 0;
+    bool success = true;
+    for(int i = 0 ; i < numRays ; ++i){
+        if(resBvh[i].valid != resBrute[i].valid || resBatch[i].valid != resBrute[i].valid){
+            success = false;
+            continue;
+        }
+        if(resBvh[i].valid){
+            hits++;
+            if(resBvh[i].distance != resBrute[i].distance || resBvh[i].triangle != resBrute[i].triangle)
+                success = false;
+            if(resBatch[i].distance != resBrute[i].distance || resBatch[i].triangle != resBrute[i].triangle)
+                success = false;
+        }
+    }
+
+    //all hits
+    std::vector<Raytracer::Result> allBvh, allBrute;
+    for(int i = 0 ; i < numRays ; ++i){
+        if(rt.trace(rays[i],allBvh) != rt.traceBruteForce(rays[i],allBrute))
+            success = false;
+    }
+
+    cout << "Closest hit: " << numRays << " rays, " << hits << " hits" << endl;
+    cout << "  Brute force: " << bruteTime << "ms " << numRays / (bruteTime / 1000.0) << " rays/s" << endl;
+    cout << "  BVH:         " << bvhTime << "ms " << numRays / (bvhTime / 1000.0) << " rays/s" << endl;
+    cout << "  BVH batched: " << batchTime << "ms " << numRays / (batchTime / 1000.0) << " rays/s" << endl;
+    cout << "Raytracer test: " << (success ? "Success" : "Fail") << endl;
+}
+
+}
+}
@@ -0,0 +1,166 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include <saiga/tests/test.h>
+
+#include "saiga/rendering/renderQueue.h"
+#include "saiga/assets/asset.h"
+#include "saiga/time/timer.h"
+#include <saiga/util/assert.h>
+
+#include <random>
+#include <algorithm>
+
+namespace Saiga {
+namespace Tests {
+
+using namespace std;
+
+//Counts the draw calls instead of rendering, so the queue can be tested without an OpenGL context.
+class CountingAsset : public Asset{
+public:
+    int calls = 0;
+    int depthCalls = 0;
+    std::vector<int> drawn;
+
+    virtual void render(Camera*, const mat4 &model) override { calls++; drawn.push_back(model[0][3]); }
+    virtual void renderForward(Camera*, const mat4&) override {}
+    virtual void renderDepth(Camera*, const mat4&) override {}
+    virtual void renderWireframe(Camera*, const mat4&) override {}
+    virtual void renderRaw() override {}
+
+    virtual void renderDepth(Camera*, const mat4*, int) override { depthCalls++; }
+
+    virtual void renderInstanced(Camera*, const mat4* models, int count) override{
+        calls++;
+        for(int i = 0 ; i < count ; ++i)
+            drawn.push_back(models[i][0][3]);
+    }
+};
+
+void renderQueueBenchmark(int numObjects, int numAssets, int numMaterials){
+    std::mt19937 gen(8123);
+    std::uniform_real_distribution<float> dis(-500,500);
+    std::uniform_real_distribution<float> depthDis(-1000,0);
+
+    std::vector<CountingAsset> assets(numAssets);
+    std::vector<int> objectAsset(numObjects), objectMaterial(numObjects);
+    std::vector<mat4> objectModel(numObjects);
+    for(int i = 0 ; i < numObjects ; ++i){
+        objectAsset[i] = std::uniform_int_distribution<int>(0,numAssets - 1)(gen);
+        objectMaterial[i] = std::uniform_int_distribution<int>(0,numMaterials - 1)(gen);
+        mat4 m(1);
+        m[3] = vec4(dis(gen),dis(gen),depthDis(gen),1);
+        //the object id is stored in an unused entry of the affine matrix
+        m[0][3] = i;
+        objectModel[i] = m;
+    }
+
+    RenderQueue queue;
+    Timer timer;
+
+    //first frame assigns the asset ids and allocates the buffers
+    queue.begin();
+    for(int i = 0 ; i < numObjects ; ++i)
+        queue.submit(&assets[objectAsset[i]],objectModel[i],objectMaterial[i]);
+    queue.sort();
+
+    timer.start();
+    queue.begin();
+    for(int i = 0 ; i < numObjects ; ++i)
+        queue.submit(&assets[objectAsset[i]],objectModel[i],objectMaterial[i]);
+    timer.stop();
+    double tSubmit = timer.getTimeMS();
+
+    timer.start();
+    queue.sort();
+    timer.stop();
+    double tSort = timer.getTimeMS();
+
+    //reference: std::sort of the same keys
+    std::vector<std::pair<uint64_t,int>> reference(numObjects);
+    {
+        RenderQueue q2;
+        q2.begin();
+        for(int i = 0 ; i < numObjects ; ++i)
+            q2.submit(&assets[objectAsset[i]],objectModel[i],objectMaterial[i]);
+        for(int i = 0 ; i < numObjects ; ++i)
+            reference[i] = std::make_pair(q2.getKey(i),i);
+    }
+    std::vector<uint64_t> keys(numObjects), tmpKeys;
+    std::vector<uint32_t> values(numObjects), tmpValues;
+    for(int i = 0 ; i < numObjects ; ++i){
+        keys[i] = reference[i].first;
+        values[i] = i;
+    }
+    timer.start();
+    RenderQueue::radixSort(keys,values,tmpKeys,tmpValues);
+    timer.stop();
+    double tRadix = timer.getTimeMS();
+
+    timer.start();
+    std::sort(reference.begin(),reference.end());
+    timer.stop();
+    double tStdSort = timer.getTimeMS();
+
+    bool success = true;
+    for(int i = 0 ; i < numObjects ; ++i){
+        success &= queue.getKey(i) == reference[i].first;
+    }
+
+    //the material is bound once for every material that is used
+    std::vector<int> materialBinds(numMaterials,0);
+    timer.start();
+    queue.render(nullptr,[&](uint16_t material){ materialBinds[material]++; });
+    timer.stop();
+    double tRender = timer.getTimeMS();
+    for(int m = 0 ; m < numMaterials ; ++m){
+        bool used = std::find(objectMaterial.begin(),objectMaterial.end(),m) != objectMaterial.end();
+        success &= materialBinds[m] == (used ? 1 : 0);
+    }
+
+    queue.renderDepth(nullptr);
+
+    //every object is drawn exactly once by its own asset
+    int calls = 0, depthCalls = 0;
+    std::vector<int> drawCount(numObjects,0);
+    for(int a = 0 ; a < numAssets ; ++a){
+        calls += assets[a].calls;
+        depthCalls += assets[a].depthCalls;
+        for(int id : assets[a].drawn){
+            drawCount[id]++;
+            success &= objectAsset[id] == a;
+        }
+    }
+    for(int c : drawCount)
+        success &= c == 1;
+
+    //one batch per material and asset, objects sorted front to back inside
+    const std::vector<RenderQueue::Batch>& batches = queue.getBatches();
+    success &= calls == (int)batches.size() && (int)batches.size() <= numAssets * numMaterials;
+    success &= depthCalls == (int)batches.size();
+    for(const RenderQueue::Batch& b : batches){
+        float lastDepth = 0;
+        for(int i = b.first ; i < b.first + b.count ; ++i){
+            int id = queue.getModels()[i][0][3];
+            success &= objectMaterial[id] == b.material;
+            float depth = objectModel[id][3].z;
+            success &= depth <= lastDepth + 1e-3f;
+            lastDepth = depth;
+        }
+    }
+
+    cout << "Render queue, " << numObjects << " objects, " << numAssets << " assets, " << numMaterials << " materials" << endl;
+    cout << "  submit: " << tSubmit << "ms" << endl;
+    cout << "  sort and batch: " << tSort << "ms" << endl;
+    cout << "  keys only: radix sort " << tRadix << "ms, std::sort " << tStdSort << "ms" << endl;
+    cout << "  dispatch: " << tRender << "ms" << endl;
+    cout << "  draw calls: " << calls << " (" << numObjects << " without the queue)" << endl;
+    cout << "Render queue test: " << (success ? "Success" : "Fail") << endl;
+}
+
+}
+}
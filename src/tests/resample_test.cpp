@@ -0,0 +1,138 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include <saiga/tests/test.h>
+
+#include "saiga/image/imageResampler.h"
+#include "saiga/time/timer.h"
+#include <saiga/util/assert.h>
+
+#include <random>
+
+namespace Saiga {
+namespace Tests {
+
+using namespace std;
+
+typedef TemplatedImage<4,8,ImageElementFormat::UnsignedNormalized> rgba8_t;
+
+static const char* filterName(ResampleFilter f){
+    switch(f){
+    case ResampleFilter::Box: return "Box     ";
+    case ResampleFilter::Bilinear: return "Bilinear";
+    case ResampleFilter::Lanczos: return "Lanczos ";
+    case ResampleFilter::Kaiser: return "Kaiser  ";
+    }
+    return "";
+}
+
+static int maxDifference(rgba8_t& a, rgba8_t& b){
+    int diff = 0;
+    for(int y = 0 ; y < a.height ; ++y){
+        for(int x = 0 ; x < a.width ; ++x){
+            auto& ta = a.getTexel(x,y);
+            auto& tb = b.getTexel(x,y);
+            diff = std::max(diff,std::abs(ta.r - tb.r));
+            diff = std::max(diff,std::abs(ta.g - tb.g));
+            diff = std::max(diff,std::abs(ta.b - tb.b));
+            diff = std::max(diff,std::abs(ta.a - tb.a));
+        }
+    }
+    return diff;
+}
+
+void resampleBenchmark(int width, int height){
+    ResampleFilter filters[] = {ResampleFilter::Box, ResampleFilter::Bilinear, ResampleFilter::Lanczos, ResampleFilter::Kaiser};
+    std::mt19937 gen(2365);
+    std::uniform_int_distribution<int> dis(0,255);
+    bool success = true;
+    Timer timer;
+
+    rgba8_t img(width,height);
+    for(auto& d : img.data)
+        d = dis(gen);
+
+    {
+        //box 2:1 is the rounded 2x2 average
+        rgba8_t even(256,128);
+        for(auto& d : even.data)
+            d = dis(gen);
+        rgba8_t half(128,64);
+        resample(even,half,ResampleFilter::Box);
+        rgba8_t ref(128,64);
+        for(int y = 0 ; y < ref.height ; ++y){
+            for(int x = 0 ; x < ref.width ; ++x){
+                vec4 sum = even.getTexel(2*x,2*y).toVec4() + even.getTexel(2*x+1,2*y).toVec4()
+                        + even.getTexel(2*x,2*y+1).toVec4() + even.getTexel(2*x+1,2*y+1).toVec4();
+                ref.getTexel(x,y).fromVec4(sum * 0.25f + vec4(0.5f / 255.0f));
+            }
+        }
+        success &= maxDifference(half,ref) <= 1;
+    }
+
+    {
+        //a constant image stays constant with all filters
+        rgba8_t constant(123,77);
+        for(int i = 0 ; i < (int)constant.data.size() ; ++i)
+            constant.data[i] = 17 + (i % 4) * 50;
+        for(ResampleFilter f : filters){
+            rgba8_t smaller(50,31), larger(300,190);
+            resample(constant,smaller,f);
+            resample(constant,larger,f);
+            for(int i = 0 ; i < (int)smaller.data.size() ; ++i)
+                success &= smaller.data[i] == 17 + (i % 4) * 50;
+            for(int i = 0 ; i < (int)larger.data.size() ; ++i)
+                success &= larger.data[i] == 17 + (i % 4) * 50;
+        }
+    }
+
+    {
+        //the tiled box mip chain matches the level by level resampling
+        int n = 256;
+        std::vector<std::vector<float>> tiled(1), reference;
+        tiled[0].resize(n * n * 4);
+        for(auto& f : tiled[0])
+            f = dis(gen) / 255.0f;
+        reference = tiled;
+        ImageResampler::generateMipChain(tiled,n,n,4,ResampleFilter::Box,false);
+        int levels = ImageResampler::mipLevelCount(n,n);
+        success &= (int)tiled.size() == levels && levels == 9;
+        reference.resize(levels);
+        for(int l = 1 ; l < levels ; ++l){
+            int s = n >> l;
+            reference[l].resize(s * s * 4);
+            ImageResampler::resample(reference[l-1].data(),2*s,2*s,reference[l].data(),s,s,4,ResampleFilter::Box,false);
+            for(int i = 0 ; i < s * s * 4 ; ++i)
+                success &= std::abs(reference[l][i] - tiled[l][i]) < 1e-6f;
+        }
+    }
+
+    cout << "Resampling " << width << "x" << height << " RGBA8" << endl;
+    for(ResampleFilter f : filters){
+        rgba8_t half(width / 2, height / 2), quarter(width / 3, height / 3);
+
+        timer.start(); resample(img,half,f,false); timer.stop();
+        double t1 = timer.getTimeMS();
+        timer.start(); resample(img,quarter,f,true); timer.stop();
+        double t2 = timer.getTimeMS();
+
+        timer.start(); auto chain = generateMipChain(img,f,false); timer.stop();
+        double t3 = timer.getTimeMS();
+        timer.start(); auto chain2 = generateMipChain(img,f,true); timer.stop();
+        double t4 = timer.getTimeMS();
+        success &= chain.size() == chain2.size();
+        for(int i = 0 ; i < (int)chain.size() ; ++i){
+            success &= chain[i].data == chain2[i].data;
+        }
+
+        cout << "  " << filterName(f) << ": 1/2 " << t1 << "ms, 1/3 (parallel) " << t2 << "ms, mip chain " << t3 << "ms, mip chain (parallel) " << t4 << "ms" << endl;
+    }
+
+    cout << "Resample test: " << (success ? "Success" : "Fail") << endl;
+}
+
+}
+}
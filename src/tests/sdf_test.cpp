@@ -0,0 +1,147 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include <saiga/tests/test.h>
+
+#include "saiga/image/distanceTransform.h"
+#include "saiga/util/taskScheduler.h"
+#include "saiga/time/timer.h"
+#include <saiga/util/assert.h>
+
+#include <random>
+#include <algorithm>
+
+namespace Saiga {
+namespace Tests {
+
+using namespace std;
+
+//The brute force conversion, which was used by the TextureAtlas before.
+static std::vector<glm::ivec2> generateSDFsamples(int searchRadius)
+{
+    std::vector<glm::ivec2> samplePositions;
+    for(int x = -searchRadius ; x <= searchRadius ; ++x){
+        for(int y = -searchRadius ; y <= searchRadius ; ++y){
+            if((x!=0 || y!=0) && glm::sqrt((float)(x*x+y*y)) <= searchRadius)
+                samplePositions.emplace_back(x,y);
+        }
+    }
+    std::sort(samplePositions.begin(),samplePositions.end(),[](const glm::ivec2 &a,const glm::ivec2 &b)->bool
+    {
+        return (a.x*a.x+a.y*a.y)<(b.x*b.x+b.y*b.y);
+    });
+    return samplePositions;
+}
+
+static void referenceSDF(Image& bitmap, Image& sdf, int divisor, int searchRadius, const std::vector<glm::ivec2>& samplePositions){
+    int halfDivisor = divisor / 2;
+    sdf.width = bitmap.width / divisor;
+    sdf.height = bitmap.height / divisor;
+    sdf.Format() = bitmap.Format();
+    sdf.create();
+    for(int y = 0 ; y < sdf.height ; ++y){
+        for(int x = 0 ; x < sdf.width ; ++x){
+            int bx = x * divisor + halfDivisor;
+            int by = y * divisor + halfDivisor;
+            float d = 12345;
+            unsigned char current = bitmap.getPixel<unsigned char>(bx,by);
+            for(glm::ivec2 s : samplePositions){
+                glm::ivec2 ps = glm::ivec2(bx,by) + s;
+                ps = glm::clamp(ps,glm::ivec2(0),glm::ivec2(bitmap.width-1,bitmap.height-1));
+                if(current != bitmap.getPixel<unsigned char>(ps.x,ps.y)){
+                    d = glm::sqrt((float)(s.x*s.x+s.y*s.y));
+                    break;
+                }
+            }
+            d = glm::clamp(d / (float)searchRadius,0.0f,1.0f) * 0.5f;
+            d = current ? d + 0.5f : 0.5f - d;
+            unsigned char out = d * 255.0f;
+            sdf.setPixel(x,y,out);
+        }
+    }
+}
+
+//Random strokes and rings with the size and padding of a 40px glyph at quality 4 (9x supersampling, search range 5).
+static void randomGlyph(Image& img, std::mt19937& gen, int divisor, int padding){
+    std::uniform_int_distribution<int> sizeDis(60,360);
+    int w = sizeDis(gen) + 2 * padding;
+    int h = sizeDis(gen) + 2 * padding;
+    w += (divisor - (w % divisor)) % divisor;
+    h += (divisor - (h % divisor)) % divisor;
+    img.width = w;
+    img.height = h;
+    img.Format() = ImageFormat(1,8);
+    img.create();
+    img.makeZero();
+
+    std::uniform_real_distribution<float> dis(0,1);
+    for(int s = 0 ; s < 4 ; ++s){
+        vec2 center(padding + dis(gen) * (w - 2 * padding), padding + dis(gen) * (h - 2 * padding));
+        float outer = 10 + dis(gen) * 60;
+        float inner = outer * dis(gen) * 0.8f;
+        for(int y = padding ; y < h - padding ; ++y){
+            for(int x = padding ; x < w - padding ; ++x){
+                float d = glm::length(vec2(x,y) - center);
+                if(d <= outer && d >= inner)
+                    img.setPixel(x,y,(uint8_t)255);
+            }
+        }
+    }
+}
+
+void sdfBenchmark(int numGlyphs){
+    int quality = 4 * 2 + 1;
+    int searchRange = 5;
+    int searchRadius = quality * searchRange;
+    int padding = (1 + quality) * searchRange;
+    //number of glyphs of the basic latin block
+    int referenceGlyphs = std::min(numGlyphs,95);
+
+    std::mt19937 gen(936);
+    std::vector<Image> glyphs(numGlyphs);
+    for(Image& g : glyphs)
+        randomGlyph(g,gen,quality,padding);
+
+    bool success = true;
+    Timer timer;
+
+    std::vector<Image> reference(referenceGlyphs), edt(numGlyphs), edtParallel(numGlyphs);
+    auto samples = generateSDFsamples(searchRadius);
+    timer.start();
+    for(int i = 0 ; i < referenceGlyphs ; ++i)
+        referenceSDF(glyphs[i],reference[i],quality,searchRadius,samples);
+    timer.stop();
+    double t0 = timer.getTimeMS();
+
+    timer.start();
+    for(int i = 0 ; i < referenceGlyphs ; ++i)
+        DistanceTransform::bitmapToSDF(glyphs[i],edt[i],quality,searchRadius);
+    timer.stop();
+    double t1 = timer.getTimeMS();
+
+    for(int i = 0 ; i < referenceGlyphs ; ++i)
+        success &= reference[i].data == edt[i].data;
+
+    timer.start();
+    parallelFor(defaultTaskScheduler(),0,numGlyphs,1,[&](int i){
+        DistanceTransform::bitmapToSDF(glyphs[i],edtParallel[i],quality,searchRadius);
+    });
+    timer.stop();
+    double t2 = timer.getTimeMS();
+
+    for(int i = 0 ; i < referenceGlyphs ; ++i)
+        success &= reference[i].data == edtParallel[i].data;
+
+    //the brute force version is only measured on the first glyphs and extrapolated
+    cout << "SDF atlas generation, quality 4, search range 5" << endl;
+    cout << "  " << referenceGlyphs << " glyphs (BasicLatin): brute force " << t0 << "ms, distance transform " << t1 << "ms" << endl;
+    cout << "  " << numGlyphs << " glyphs: brute force (estimated) " << t0 / referenceGlyphs * numGlyphs << "ms, parallel distance transform " << t2 << "ms" << endl;
+
+    cout << "SDF test: " << (success ? "Success" : "Fail") << endl;
+}
+
+}
+}
@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include <saiga/tests/test.h>
+#include <saiga/tests/testAnimation.h>
+
+#include "saiga/animation/animation.h"
+#include "saiga/animation/skeleton.h"
+#include "saiga/time/timer.h"
+#include <saiga/util/assert.h>
+
+#include <random>
+
+namespace Saiga {
+namespace Tests {
+
+using namespace std;
+
+//Random keyframes without any coherence.
+static void randomAnimation(Animation& anim, int nodeCount, int boneCount, int frameCount, std::mt19937& gen){
+    std::uniform_real_distribution<float> dis(-1,1);
+    createTestAnimation(anim,nodeCount,boneCount,frameCount,gen,[&](AnimationNode& n, float){
+        n.position = vec4(dis(gen),dis(gen),dis(gen),1);
+        n.rotation = glm::normalize(quat(dis(gen),dis(gen),dis(gen),dis(gen)));
+        n.scaling = vec4(1 + 0.1f * dis(gen),1 + 0.1f * dis(gen),1 + 0.1f * dis(gen),1);
+    });
+}
+
+void skeletonBenchmark(int numInstances){
+    std::mt19937 gen(6324);
+    Animation anim;
+    randomAnimation(anim,80,60,31,gen);
+
+    SkeletonAnimation skeletonAnim;
+    skeletonAnim.create(anim);
+
+    bool success = true;
+
+    //compare with the tree traversal at random times and exactly on the keyframes
+    std::vector<animationtime_t> times(numInstances);
+    std::uniform_real_distribution<double> timeDis(-0.1,anim.duration.count() + 0.1);
+    for(int i = 0 ; i < numInstances ; ++i){
+        times[i] = i % 10 == 0 ? animationtime_t(anim.keyFrames[i % anim.frameCount].time) : animationtime_t(timeDis(gen));
+    }
+
+    std::vector<std::vector<mat4>> reference(numInstances), flat(numInstances,std::vector<mat4>(anim.boneCount));
+    Timer timer;
+
+    timer.start();
+    for(int i = 0 ; i < numInstances ; ++i){
+        AnimationFrame frame;
+        anim.getFrame(times[i],frame);
+        reference[i] = frame.getBoneMatrices(anim);
+    }
+    timer.stop();
+    double t0 = timer.getTimeMS();
+
+    std::vector<SkeletonEvaluation> evaluations(numInstances);
+    for(int i = 0 ; i < numInstances ; ++i){
+        evaluations[i].animation = &skeletonAnim;
+        evaluations[i].time = times[i];
+        evaluations[i].boneMatrices = flat[i].data();
+    }
+
+    timer.start();
+    evaluateSkeletons(evaluations,false);
+    timer.stop();
+    double t1 = timer.getTimeMS();
+
+    for(int i = 0 ; i < numInstances ; ++i)
+        success &= reference[i] == flat[i];
+
+    for(std::vector<mat4>& f : flat)
+        std::fill(f.begin(),f.end(),mat4(0));
+
+    timer.start();
+    evaluateSkeletons(evaluations,true);
+    timer.stop();
+    double t2 = timer.getTimeMS();
+
+    for(int i = 0 ; i < numInstances ; ++i)
+        success &= reference[i] == flat[i];
+
+    cout << "Skeleton evaluation, " << numInstances << " instances, " << skeletonAnim.skeleton.nodeCount << " nodes, " << anim.boneCount << " bones" << endl;
+    cout << "  AnimationFrame traversal: " << t0 << "ms" << endl;
+    cout << "  flat: " << t1 << "ms, flat parallel: " << t2 << "ms" << endl;
+    cout << "Skeleton test: " << (success ? "Success" : "Fail") << endl;
+}
+
+}
+}
@@ -0,0 +1,112 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include <saiga/tests/test.h>
+
+#include "saiga/animation/cpuSkinning.h"
+#include "saiga/time/timer.h"
+#include <saiga/util/assert.h>
+
+#include <random>
+
+namespace Saiga {
+namespace Tests {
+
+using namespace std;
+
+void skinningBenchmark(int numMeshes, int verticesPerMesh){
+    std::mt19937 gen(2351);
+    std::uniform_real_distribution<float> dis(-1,1);
+    std::uniform_real_distribution<float> weightDis(0.05f,1);
+    const int numBones = 60;
+
+    std::vector<mat4> boneMatrices(numBones);
+    for(mat4& m : boneMatrices){
+        quat q = glm::normalize(quat(dis(gen),dis(gen),dis(gen),dis(gen)));
+        m = createTRSmatrix(vec4(dis(gen),dis(gen),dis(gen),1),q,vec4(1 + 0.2f * dis(gen)));
+    }
+    BonePalette palette;
+    palette.set(boneMatrices);
+
+    std::vector<std::vector<BoneVertex>> vertices(numMeshes);
+    std::vector<SkinnedMesh> meshes(numMeshes);
+    for(int j = 0 ; j < numMeshes ; ++j){
+        vertices[j].resize(verticesPerMesh);
+        for(BoneVertex& v : vertices[j]){
+            v.position = vec4(dis(gen),dis(gen),dis(gen),1);
+            v.normal = vec4(glm::normalize(vec3(dis(gen),dis(gen),dis(gen))),0);
+            int bones = std::uniform_int_distribution<int>(1,MAX_BONES_PER_VERTEX)(gen);
+            for(int k = 0 ; k < bones ; ++k)
+                v.addBone(std::uniform_int_distribution<int>(0,numBones - 1)(gen),weightDis(gen));
+            v.normalizeWeights();
+        }
+        meshes[j].create(vertices[j]);
+    }
+
+    Timer timer;
+    double totalVertices = double(numMeshes) * verticesPerMesh;
+
+    //reference: BoneVertex::apply
+    std::vector<std::vector<BoneVertex>> reference = vertices;
+    timer.start();
+    for(std::vector<BoneVertex>& mesh : reference){
+        for(BoneVertex& v : mesh)
+            v.apply(boneMatrices);
+    }
+    timer.stop();
+    double t0 = timer.getTimeMS();
+
+    std::vector<VertexStreams> out(numMeshes);
+    std::vector<SkinningJob> jobs(numMeshes);
+    for(int j = 0 ; j < numMeshes ; ++j){
+        jobs[j].mesh = &meshes[j];
+        jobs[j].palette = &palette;
+        jobs[j].out = &out[j];
+    }
+
+    //allocates the output streams
+    skinMeshes(jobs,false);
+
+    timer.start();
+    skinMeshes(jobs,false);
+    timer.stop();
+    double t1 = timer.getTimeMS();
+
+    float error = 0;
+    for(int j = 0 ; j < numMeshes ; ++j){
+        for(int i = 0 ; i < verticesPerMesh ; ++i){
+            const BoneVertex& r = reference[j][i];
+            vec3 p(out[j].px[i],out[j].py[i],out[j].pz[i]);
+            vec3 n(out[j].nx[i],out[j].ny[i],out[j].nz[i]);
+            vec3 dp = glm::abs(p - vec3(r.position));
+            vec3 dn = glm::abs(n - vec3(r.normal));
+            error = std::max(error,std::max(std::max(dp.x,dp.y),dp.z));
+            error = std::max(error,std::max(std::max(dn.x,dn.y),dn.z));
+        }
+    }
+
+    std::vector<VertexStreams> serial = out;
+
+    timer.start();
+    skinMeshes(jobs,true);
+    timer.stop();
+    double t2 = timer.getTimeMS();
+
+    bool success = error < 1e-4f;
+    for(int j = 0 ; j < numMeshes ; ++j){
+        success &= out[j].px == serial[j].px && out[j].nz == serial[j].nz;
+    }
+
+    cout << "CPU skinning, " << numMeshes << " meshes, " << verticesPerMesh << " vertices per mesh, " << numBones << " bones" << endl;
+    cout << "  BoneVertex::apply: " << t0 << "ms (" << totalVertices / (t0 * 1000) << " MVertices/s)" << endl;
+    cout << "  batched: " << t1 << "ms (" << totalVertices / (t1 * 1000) << " MVertices/s)" << endl;
+    cout << "  batched parallel: " << t2 << "ms (" << totalVertices / (t2 * 1000) << " MVertices/s)" << endl;
+    cout << "  max error: " << error << endl;
+    cout << "Skinning test: " << (success ? "Success" : "Fail") << endl;
+}
+
+}
+}
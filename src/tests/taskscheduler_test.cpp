@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include <saiga/tests/test.h>
+
+#include "saiga/util/taskScheduler.h"
+#include "saiga/util/threadPool.h"
+#include "saiga/time/timer.h"
+#include <saiga/util/assert.h>
+
+namespace Saiga {
+namespace Tests {
+
+using namespace std;
+
+void taskSchedulerBenchmark(int numTasks){
+    int threadCounts[] = {1,4,16};
+    bool success = true;
+
+    for(int threads : threadCounts){
+        Timer timer;
+        std::atomic<int> counter(0);
+
+        {
+            ThreadPool pool(threads);
+            std::vector<std::future<void>> results;
+            results.reserve(numTasks);
+
+            timer.start();
+            for(int i = 0 ; i < numTasks ; ++i){
+                results.push_back(pool.enqueue([&counter](){ counter++; }));
+            }
+            for(auto& r : results)
+                r.get();
+            timer.stop();
+        }
+        double poolTime = timer.getTimeMS();
+        if(counter != numTasks)
+            success = false;
+
+        TaskScheduler scheduler(threads);
+
+        counter = 0;
+        timer.start();
+        {
+            TaskGroup group(scheduler);
+            for(int i = 0 ; i < numTasks ; ++i){
+                group.run([&counter](){ counter++; });
+            }
+            group.wait();
+        }
+        timer.stop();
+        double groupTime = timer.getTimeMS();
+        if(counter != numTasks)
+            success = false;
+
+        //recursive task creation: every task spawns two children until the leaves are reached
+        counter = 0;
+        timer.start();
+        {
+            std::function<void(int)> spawn = [&](int n){
+                if(n <= 1){
+                    counter++;
+                    return;
+                }
+                TaskGroup group(scheduler);
+                group.run([&spawn,n](){ spawn(n / 2); });
+                spawn(n - n / 2);
+                group.wait();
+            };
+            spawn(numTasks);
+        }
+        timer.stop();
+        double recursiveTime = timer.getTimeMS();
+        if(counter != numTasks)
+            success = false;
+
+        std::vector<int> data(numTasks,0);
+        timer.start();
+        parallelFor(scheduler,0,numTasks,0,[&data](int i){ data[i] = i; });
+        timer.stop();
+        double forTime = timer.getTimeMS();
+        for(int i = 0 ; i < numTasks ; ++i){
+            if(data[i] != i)
+                success = false;
+        }
+
+        cout << "Task benchmark, " << threads << " threads, " << numTasks << " tasks" << endl;
+        cout << "  ThreadPool:                " << numTasks / (poolTime / 1000.0) << " tasks/s" << endl;
+        cout << "  TaskScheduler (TaskGroup): " << numTasks / (groupTime / 1000.0) << " tasks/s" << endl;
+        cout << "  TaskScheduler (recursive): " << numTasks / (recursiveTime / 1000.0) << " tasks/s" << endl;
+        cout << "  parallelFor:               " << numTasks / (forTime / 1000.0) << " iterations/s" << endl;
+    }
+
+    cout << "TaskScheduler test: " << (success ? "Success" : "Fail") << endl;
+}
+
+}
+}
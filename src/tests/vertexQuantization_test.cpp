@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include <saiga/tests/test.h>
+
+#include "saiga/geometry/vertexQuantization.h"
+#include "saiga/time/timer.h"
+#include <saiga/util/assert.h>
+
+#include <cmath>
+
+namespace Saiga {
+namespace Tests {
+
+using namespace std;
+
+void vertexQuantizationBenchmark(int gridSize){
+    //a large height field with smooth normals
+    TriangleMesh<VertexNT,GLuint> mesh;
+    mesh.vertices.reserve(gridSize * gridSize);
+    for(int y = 0 ; y < gridSize ; ++y){
+        for(int x = 0 ; x < gridSize ; ++x){
+            float fx = x * 0.1f, fy = y * 0.1f;
+            float h = std::sin(fx) * std::cos(fy) * 5.0f;
+            vec3 n = glm::normalize(vec3(-std::cos(fx) * std::cos(fy) * 5.0f,1,std::sin(fx) * std::sin(fy) * 5.0f));
+            vec2 t(float(x) / (gridSize - 1),float(y) / (gridSize - 1));
+            mesh.addVertex(VertexNT(vec3(fx - 50,h,fy - 50),n,t * 8.0f));
+        }
+    }
+    for(int y = 0 ; y < gridSize - 1 ; ++y){
+        for(int x = 0 ; x < gridSize - 1 ; ++x){
+            GLuint i = y * gridSize + x;
+            mesh.addFace(i,i + gridSize,i + 1);
+            mesh.addFace(i + 1,i + gridSize,i + gridSize + 1);
+        }
+    }
+
+    Timer timer;
+    TriangleMesh<VertexNTQ,GLuint> qmesh;
+    //allocate once, so only the conversion is timed
+    quantizeMesh(mesh,qmesh);
+    timer.start();
+    quantizeMesh(mesh,qmesh);
+    timer.stop();
+    double t = timer.getTimeMS();
+
+    VertexQuantizer quantizer(mesh.boundingBox);
+    vec3 maxPositionError = quantizer.maxError();
+    float positionError = 0, normalError = 0, texError = 0;
+    bool success = true;
+    for(int i = 0 ; i < (int)mesh.vertices.size() ; ++i){
+        VertexNT v = quantizer.dequantize(qmesh.vertices[i]);
+        const VertexNT& r = mesh.vertices[i];
+        for(int c = 0 ; c < 3 ; ++c){
+            float e = std::abs(v.position[c] - r.position[c]);
+            positionError = std::max(positionError,e);
+            success &= e <= maxPositionError[c] * 1.01f + 1e-6f;
+        }
+        //acos(dot) is too inaccurate for small angles
+        vec3 c = glm::cross(vec3(v.normal),vec3(r.normal));
+        normalError = std::max(normalError,std::atan2(glm::length(c),glm::dot(vec3(v.normal),vec3(r.normal))));
+        texError = std::max(texError,std::max(std::abs(v.texture.x - r.texture.x),std::abs(v.texture.y - r.texture.y)));
+    }
+    //16 bit octahedral: less than 0.01 degree, half floats in [0,8]: 11 bit mantissa
+    success &= normalError < 2e-4f;
+    success &= texError <= 8.0f / 2048;
+
+    //a zero length normal is encoded as a valid unit normal
+    VertexN zeroNormal(vec3(0),vec3(0));
+    VertexNQ zq;
+    quantizer.quantize(&zeroNormal,&zq,1);
+    success &= std::abs(glm::length(vec3(quantizer.dequantize(zq).normal)) - 1.0f) < 1e-5f;
+
+    //all finite half floats must survive a round trip
+    for(int h = 0 ; h < 65536 ; ++h){
+        if((h & 0x7c00) == 0x7c00 && (h & 0x3ff))
+            continue;
+        success &= floatToHalf(halfToFloat(h)) == h;
+    }
+
+    double n = mesh.vertices.size();
+    double indexBytes = mesh.faces.size() * 3 * sizeof(GLuint);
+    double before = n * sizeof(VertexNT) + indexBytes;
+    double after = n * sizeof(VertexNTQ) + indexBytes;
+    cout << "Vertex quantization, " << n << " vertices, " << mesh.faces.size() << " faces" << endl;
+    cout << "  vertex size: " << sizeof(VertexNT) << " -> " << sizeof(VertexNTQ) << " bytes" << endl;
+    cout << "  memory with indices: " << before / (1024 * 1024) << "mb -> " << after / (1024 * 1024) << "mb (" << before / after << "x)" << endl;
+    cout << "  conversion: " << t << "ms (" << n / (t * 1000) << " MVertices/s)" << endl;
+    cout << "  max error: position " << positionError << ", normal " << glm::degrees(normalError) << " degrees, texture " << texError << endl;
+    cout << "Vertex quantization test: " << (success ? "Success" : "Fail") << endl;
+}
+
+}
+}
@@ -0,0 +1,42 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/text/codePointTable.h"
+
+namespace Saiga {
+
+int CodePointTable::get(int c) const
+{
+    if(!validCodePoint(c))
+        return -1;
+    int page = c / pageSize;
+    if(page >= (int)pages.size() || pages[page].empty())
+        return -1;
+    return pages[page][c % pageSize];
+}
+
+bool CodePointTable::set(int c, int index)
+{
+    if(!validCodePoint(c))
+        return false;
+    int page = c / pageSize;
+    if(page >= (int)pages.size())
+        pages.resize(page + 1);
+    if(pages[page].empty())
+        pages[page].resize(pageSize,-1);
+    pages[page][c % pageSize] = index;
+    return true;
+}
+
+int CodePointTable::allocatedPages() const
+{
+    int count = 0;
+    for(const std::vector<int>& p : pages)
+        count += !p.empty();
+    return count;
+}
+
+}
@@ -57,7 +57,13 @@ void FontLoader::loadMonochromatic(int fontSize, int glyphPadding)
 
 }
 
-void FontLoader::loadAndAddGlyph(int charCode, int glyphPadding)
+bool FontLoader::loadGlyph(int charCode, int glyphPadding)
+{
+    SAIGA_ASSERT(face);
+    return loadAndAddGlyph(charCode,glyphPadding);
+}
+
+bool FontLoader::loadAndAddGlyph(int charCode, int glyphPadding)
 {
 //    std::cout << "loadAndAddGlyph "<<charCode << std::endl;
     FT_UInt  glyph_index;
@@ -68,17 +74,18 @@ void FontLoader::loadAndAddGlyph(int charCode, int glyphPadding)
     //0 glyph index means undefined character code
     if(glyph_index == 0){
 //        std::cerr << "can't find glyph for charcode: " << std::hex << charCode << std::endl;
-        return;
+        return false;
     }
 
 //        error = FT_Load_Glyph( face, glyph_index, FT_LOAD_DEFAULT );
     FT_Error error = FT_Load_Glyph( face, glyph_index, FT_LOAD_TARGET_MONO );
     if ( error ){
         std::cerr << "random error"<< std::endl;
-        return;  /* ignore errors */
+        return false;  /* ignore errors */
     }
 
     addGlyph(charCode,glyphPadding);
+    return true;
 }
 
 void FontLoader::addGlyph(int charCode, int glyphPadding)
@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/text/skylinePacker.h"
+#include "saiga/util/assert.h"
+
+//only the declarations, the implementation is in imgui_draw.cpp
+#include "saiga/imgui/stb_rect_pack.h"
+
+namespace Saiga {
+
+struct SkylinePacker::Context{
+    stbrp_context context;
+    std::vector<stbrp_node> nodes;
+};
+
+SkylinePacker::SkylinePacker(int width, int height)
+    : width(width), height(height), context(new Context())
+{
+    SAIGA_ASSERT(width > 0 && height > 0);
+    context->nodes.resize(width);
+    stbrp_init_target(&context->context,width,height,context->nodes.data(),context->nodes.size());
+}
+
+SkylinePacker::~SkylinePacker()
+{
+}
+
+bool SkylinePacker::pack(int w, int h, glm::ivec2 &position)
+{
+    stbrp_rect r;
+    r.id = 0;
+    r.w = w;
+    r.h = h;
+    stbrp_pack_rects(&context->context,&r,1);
+    position = glm::ivec2(r.x,r.y);
+    return r.was_packed != 0;
+}
+
+bool SkylinePacker::pack(const std::vector<glm::ivec2> &sizes, std::vector<glm::ivec2> &positions)
+{
+    std::vector<stbrp_rect> rects(sizes.size());
+    for(int i = 0 ; i < (int)sizes.size() ; ++i){
+        rects[i].id = i;
+        rects[i].w = sizes[i].x;
+        rects[i].h = sizes[i].y;
+    }
+    stbrp_pack_rects(&context->context,rects.data(),rects.size());
+
+    //stb_rect_pack restores the input order
+    positions.resize(sizes.size());
+    bool packed = true;
+    for(int i = 0 ; i < (int)rects.size() ; ++i){
+        positions[i] = glm::ivec2(rects[i].x,rects[i].y);
+        packed &= rects[i].was_packed != 0;
+    }
+    return packed;
+}
+
+}
@@ -18,9 +18,25 @@ Text::Text(TextureAtlas *textureAtlas, const std::string &label, bool normalize)
     size = this->label.size();
     capacity = this->label.size();
 
+    atlasVersion = textureAtlas->getVersion();
     addTextToMesh(this->label);
     updateGLBuffer(0,true);
     calculateNormalizationMatrix();
+    checkAtlasVersion();
+}
+
+void Text::checkAtlasVersion()
+{
+    //creating the mesh can add characters to a dynamic atlas, so this is repeated until nothing changes
+    while(atlasVersion != textureAtlas->getVersion()){
+        atlasVersion = textureAtlas->getVersion();
+        mesh.vertices.clear();
+        mesh.faces.clear();
+        lines = 1;
+        addTextToMesh(label,startPos);
+        updateGLBuffer(0,false);
+        calculateNormalizationMatrix();
+    }
 }
 
 void Text::calculateNormalizationMatrix()
@@ -56,6 +72,7 @@ void Text::calculateNormalizationMatrix()
 }
 
 void Text::updateText(const std::string &l, int startIndex){
+    checkAtlasVersion();
 //    cout<<"Text::updateText: '"<<l<<"' Start:"<<startIndex<<" old: '"<<this->label<<"'"<<endl;
 //    std::string label(l);
     utf32string label = Encoding::UTF8toUTF32(l);
@@ -101,6 +118,7 @@ void Text::updateText(const std::string &l, int startIndex){
     this->updateGLBuffer(startIndex,resize);
 
     calculateNormalizationMatrix();
+    checkAtlasVersion();
 }
 
 std::string Text::getText(){
@@ -114,6 +132,7 @@ std::string Text::getText(){
 
 
 void Text::render(std::shared_ptr<TextShader>  shader){
+    checkAtlasVersion();
 
     shader->uploadTextureAtlas(textureAtlas->getTexture());
 
@@ -9,6 +9,8 @@
 #include "saiga/opengl/texture/textureLoader.h"
 #include "saiga/geometry/triangle_mesh.h"
 #include "saiga/text/fontLoader.h"
+#include "saiga/image/distanceTransform.h"
+#include "saiga/util/taskScheduler.h"
 #include <algorithm>
 #include <fstream>
 #include "saiga/util/assert.h"
@@ -39,8 +41,15 @@ void TextureAtlas::loadFont(const std::string &font, int fontSize, int quality,
 
     uniqueFontString = font+"."+std::to_string(fontSize)+"_"+std::to_string(quality)+"_"+std::to_string(searchRange)+"_"+blockString+".sdf";
 
+    dynamic = false;
+    characters.clear();
+    characterLookup.clear();
+
     //add an 'empty' character for new line
-    characterInfoMap['\n'] = character_info();
+    character_info newLine;
+    newLine.character = '\n';
+    characters.push_back(newLine);
+    characterLookup.set('\n',0);
 
     if(bufferToFile && readAtlasFromFiles()){
         initFont();
@@ -75,19 +84,184 @@ void TextureAtlas::loadFont(const std::string &font, int fontSize, int quality,
 }
 
 
+void TextureAtlas::loadFontDynamic(const std::string &font, int fontSize, int quality, int searchRange, int initialAtlasSize)
+{
+    dynamic = true;
+    characters.clear();
+    characterLookup.clear();
+    textureAtlas = nullptr;
+    version++;
+
+    character_info newLine;
+    newLine.character = '\n';
+    characters.push_back(newLine);
+    characterLookup.set('\n',0);
+
+    glyphQuality = quality*2+1;
+    glyphSearchRadius = glyphQuality*searchRange;
+    glyphPadding = (1+glyphQuality)*searchRange;
+
+    fontLoader = std::make_shared<FontLoader>(font);
+    fontLoader->loadFace(fontSize*glyphQuality);
+
+    atlasWidth = initialAtlasSize;
+    atlasHeight = initialAtlasSize;
+    atlasImage.Format() = ImageFormat(1,8);
+    atlasImage.width = atlasWidth;
+    atlasImage.height = atlasHeight;
+    atlasImage.create();
+    atlasImage.makeZero();
+    dirtyStart = dirtyEnd = 0;
+    packer = std::make_shared<SkylinePacker>(atlasWidth,atlasHeight);
+
+    maxCharacter.makeNegative();
+
+    initFont();
+}
+
+
 void TextureAtlas::initFont()
 {
     invalidCharacter = getCharacterInfo('?');
 }
 
+std::shared_ptr<Texture> TextureAtlas::getTexture()
+{
+    if(dynamic){
+        if(!textureAtlas){
+            textureAtlas = std::make_shared<Texture>();
+            textureAtlas->fromImage(atlasImage);
+            textureAtlas->generateMipmaps();
+        }else if(dirtyEnd > dirtyStart){
+            //complete rows, so the data is continuous
+            textureAtlas->uploadSubImage(0,dirtyStart,atlasWidth,dirtyEnd-dirtyStart,atlasImage.positionPtr(0,dirtyStart));
+            textureAtlas->generateMipmaps();
+        }
+        dirtyStart = dirtyEnd = 0;
+    }
+    return textureAtlas;
+}
+
 
 const TextureAtlas::character_info &TextureAtlas::getCharacterInfo(int c){
-    auto it = characterInfoMap.find(c);
-    if(it==characterInfoMap.end()){
-        cerr<<"TextureAtlas::getCharacterInfo: Invalid character '"<<std::hex<<c<<"'"<<endl;
+    if(!CodePointTable::validCodePoint(c)){
+        cerr<<"TextureAtlas::getCharacterInfo: Invalid code point "<<c<<endl;
+        return invalidCharacter;
+    }
+    int index = findCharacter(c);
+    if(index == -1 && dynamic){
+        index = createCharacter(c);
+    }
+    if(index < 0){
+        //missing characters of a dynamic font are only reported once
+        if(index == -1)
+            cerr<<"TextureAtlas::getCharacterInfo: Invalid character '"<<std::hex<<c<<"'"<<endl;
         return invalidCharacter;
     }
-    return (*it).second;
+    return characters[index];
+}
+
+TextureAtlas::character_info& TextureAtlas::addCharacterInfo(FontLoader::Glyph &g)
+{
+    character_info info;
+
+    info.character = g.character;
+    info.advance.x = g.advance.x;
+    info.advance.y = g.advance.y;
+
+    info.size.x = g.size.x;
+    info.size.y = g.size.y;
+
+    info.offset.x = g.offset.x;
+    info.offset.y = g.offset.y - info.size.y; //freetype uses an y inverted glyph coordinate system
+
+    maxCharacter.min = glm::min(maxCharacter.min,vec3(info.offset.x,info.offset.y,0));
+    maxCharacter.max = glm::max(maxCharacter.max,vec3(info.offset.x+info.size.x,info.offset.y+info.size.y,0));
+
+    SAIGA_ASSERT(CodePointTable::validCodePoint(g.character));
+    characterLookup.set(g.character,characters.size());
+    characters.push_back(info);
+    return characters.back();
+}
+
+void TextureAtlas::calculateTextureCoordinates(character_info &info)
+{
+    float tx = (float)info.atlasPos.x / (float)atlasWidth;
+    float ty = (float)info.atlasPos.y / (float)atlasHeight;
+
+    info.tcMin = vec2(tx,ty);
+    info.tcMax = vec2(tx+(float)info.size.x/(float)atlasWidth,ty+(float)info.size.y/(float)atlasHeight);
+}
+
+void TextureAtlas::copyGlyphToAtlas(Image &outImg, FontLoader::Glyph &g, const character_info &info)
+{
+    //Image::setSubImage copies the row padding of the glyph, which could overwrite the neighbours
+    for(int y = 0 ; y < g.bitmap->height ; ++y){
+        memcpy(outImg.positionPtr(info.atlasPos.x,info.atlasPos.y+y),g.bitmap->positionPtr(0,y),g.bitmap->width);
+    }
+}
+
+int TextureAtlas::createCharacter(int c)
+{
+    if(!fontLoader->loadGlyph(c,glyphPadding)){
+        cerr<<"TextureAtlas::getCharacterInfo: Invalid character '"<<std::hex<<c<<"'"<<endl;
+        characterLookup.set(c,-2);
+        return -2;
+    }
+
+    std::vector<FontLoader::Glyph> glyphs(1,fontLoader->glyphs.back());
+    fontLoader->glyphs.pop_back();
+    padGlyphsToDivisor(glyphs,glyphQuality);
+    convertToSDF(glyphs,glyphQuality,glyphSearchRadius);
+    FontLoader::Glyph &g = glyphs[0];
+
+    int w = g.bitmap->width + charPaddingX;
+    int h = g.bitmap->height + charPaddingY;
+    SAIGA_ASSERT(w <= atlasWidth);
+    glm::ivec2 position;
+    while(!packer->pack(w,h,position)){
+        growAtlas();
+    }
+
+    AABB oldMax = maxCharacter;
+    character_info &info = addCharacterInfo(g);
+    info.atlasPos = position;
+    calculateTextureCoordinates(info);
+    copyGlyphToAtlas(atlasImage,g,info);
+
+    if(dirtyEnd == dirtyStart){
+        dirtyStart = position.y;
+        dirtyEnd = position.y + h;
+    }else{
+        dirtyStart = std::min(dirtyStart,position.y);
+        dirtyEnd = std::max(dirtyEnd,position.y + h);
+    }
+
+    //the line spacing and bounding boxes of texts depend on the max character
+    if(oldMax.min != maxCharacter.min || oldMax.max != maxCharacter.max)
+        version++;
+
+    delete g.bitmap;
+    return characters.size() - 1;
+}
+
+void TextureAtlas::growAtlas()
+{
+    //The existing characters are kept at their position and the packer continues above them.
+    //Only the y texture coordinates change.
+    int oldHeight = atlasHeight;
+    atlasHeight *= 2;
+    atlasImage.resizeCopy(atlasWidth,atlasHeight);
+
+    packer = std::make_shared<SkylinePacker>(atlasWidth,atlasHeight);
+    glm::ivec2 position;
+    packer->pack(atlasWidth,oldHeight,position);
+
+    for(character_info &info : characters){
+        calculateTextureCoordinates(info);
+    }
+    textureAtlas = nullptr;
+    version++;
 }
 
 
@@ -111,71 +285,48 @@ void TextureAtlas::createTextureAtlas(Image &outImg, std::vector<FontLoader::Gly
     cout<<"AtlasWidth "<<atlasWidth<<" AtlasHeight "<<atlasHeight<<endl;
 
     for(FontLoader::Glyph &g : glyphs) {
-        character_info &info = characterInfoMap[g.character];
-        outImg.setSubImage(info.atlasPos.x,info.atlasPos.y,*g.bitmap);
+        copyGlyphToAtlas(outImg,g,characters[findCharacter(g.character)]);
     }
-    numCharacters = characterInfoMap.size();
+    numCharacters = characters.size();
 }
 
 void TextureAtlas::calculateTextureAtlasLayout(std::vector<FontLoader::Glyph> &glyphs)
 {
-    int charsPerRow = glm::ceil(glm::sqrt((float)glyphs.size()));
-
-    atlasHeight = charPaddingY;
-    atlasWidth = 0;
-
     maxCharacter.makeNegative();
 
-    for(int cy = 0 ; cy < charsPerRow ; ++cy){
-        int currentW = charPaddingX;
-        int currentH = charPaddingY;
-
-        for(int cx = 0 ; cx < charsPerRow ; ++cx){
-            int i = cy * charsPerRow + cx;
-            if(i>=(int)glyphs.size())
-                break;
-
-            FontLoader::Glyph &g = glyphs[i];
-
-            character_info info;
-
-            info.character = g.character;
-            info.advance.x = g.advance.x;
-            info.advance.y = g.advance.y;
-
-            info.size.x = g.size.x;
-            info.size.y = g.size.y;
-
-            info.offset.x = g.offset.x;
-            info.offset.y = g.offset.y - info.size.y; //freetype uses an y inverted glyph coordinate system
-
-            maxCharacter.min = glm::min(maxCharacter.min,vec3(info.offset.x,info.offset.y,0));
-            maxCharacter.max = glm::max(maxCharacter.max,vec3(info.offset.x+info.size.x,info.offset.y+info.size.y,0));
-
-
-
-            info.atlasPos.x = currentW;
-            info.atlasPos.y = atlasHeight;
-
-            characterInfoMap[g.character] = info;
-
-            currentW += g.bitmap->width+charPaddingX;
-            currentH = std::max(currentH, (int)g.bitmap->height);
+    //power of two width, which gives an almost quadratic atlas
+    size_t area = 0;
+    int maxWidth = 1;
+    for(FontLoader::Glyph &g : glyphs) {
+        area += (g.bitmap->width+charPaddingX) * (g.bitmap->height+charPaddingY);
+        maxWidth = std::max(maxWidth,g.bitmap->width+charPaddingX);
+    }
+    int width = 64;
+    while((size_t)width * width < area || width < maxWidth)
+        width *= 2;
 
+    std::vector<glm::ivec2> sizes(glyphs.size());
+    for(int i = 0 ; i < (int)glyphs.size() ; ++i){
+        sizes[i] = glm::ivec2(glyphs[i].bitmap->width+charPaddingX,glyphs[i].bitmap->height+charPaddingY);
+    }
+    std::vector<glm::ivec2> positions;
+    for(int height = width / 2 ; ; height *= 2){
+        SkylinePacker packer(width,height);
+        if(packer.pack(sizes,positions))
+            break;
+    }
 
-        }
-        atlasWidth = std::max(currentW, atlasWidth);
-        atlasHeight += currentH+charPaddingY;
+    atlasWidth = width;
+    atlasHeight = charPaddingY;
+    for(int i = 0 ; i < (int)glyphs.size() ; ++i){
+        character_info &info = addCharacterInfo(glyphs[i]);
+        info.atlasPos = positions[i] + glm::ivec2(charPaddingX,charPaddingY);
+        atlasHeight = std::max(atlasHeight,positions[i].y+sizes[i].y+charPaddingY);
     }
 
     //calculate the texture coordinates
-    for(FontLoader::Glyph &g : glyphs) {
-        character_info &info = characterInfoMap[g.character];
-        float tx = (float)info.atlasPos.x / (float)atlasWidth;
-        float ty = (float)info.atlasPos.y / (float)atlasHeight;
-
-        info.tcMin = vec2(tx,ty);
-        info.tcMax = vec2(tx+(float)info.size.x/(float)atlasWidth,ty+(float)info.size.y/(float)atlasHeight);
+    for(character_info &info : characters) {
+        calculateTextureCoordinates(info);
     }
 }
 
@@ -200,90 +351,19 @@ void TextureAtlas::padGlyphsToDivisor(std::vector<FontLoader::Glyph> &glyphs, in
 void TextureAtlas::convertToSDF(std::vector<FontLoader::Glyph> &glyphs, int divisor, int searchRadius)
 {
     SAIGA_ASSERT(divisor%2==1);
-    int halfDivisor = (divisor / 2);
 
-    std::vector<glm::ivec2> samplePositions = generateSDFsamples(searchRadius);
-    for(FontLoader::Glyph &g : glyphs) {
+    parallelFor(defaultTaskScheduler(),0,glyphs.size(),1,[&](int i){
+        FontLoader::Glyph &g = glyphs[i];
         Image* sdfGlyph = new Image();
-        sdfGlyph->width = g.bitmap->width / divisor;
-        sdfGlyph->height = g.bitmap->height / divisor;
-//        sdfGlyph->channels = g.bitmap->channels;
-//        sdfGlyph->bitDepth = g.bitmap->bitDepth;
-        sdfGlyph->Format() = g.bitmap->Format();
-        sdfGlyph->create();
-        sdfGlyph->makeZero();
+        DistanceTransform::bitmapToSDF(*g.bitmap,*sdfGlyph,divisor,searchRadius);
 
         g.advance /= divisor;
         g.offset /= divisor;
         g.size /= divisor;
 
-
-        for(int y = 0 ; y < (int)sdfGlyph->height ; ++y){
-            for(int x = 0 ; x < (int)sdfGlyph->width ; ++x){
-
-                //center of sdftexel in original image
-                int bx = x * divisor + halfDivisor;
-                int by = y * divisor + halfDivisor;
-                float d = 12345;
-                unsigned char current = g.bitmap->getPixel<unsigned char>(bx,by);
-                for(glm::ivec2 s : samplePositions){
-                    glm::ivec2 ps = glm::ivec2(bx,by) + s;
-                    ps = glm::clamp(ps,glm::ivec2(0),glm::ivec2(g.bitmap->width-1,g.bitmap->height-1));
-                    unsigned char other = g.bitmap->getPixel<unsigned char>(ps.x,ps.y);
-                    if(current!=other){
-                        d = glm::sqrt((float)(s.x*s.x+s.y*s.y));
-                        break;
-                    }
-                }
-
-                //map to 0-1
-                d = d / (float)searchRadius;
-                d = glm::clamp(d,0.0f,1.0f);
-                d = d * 0.5f;
-
-                //set 0.5 to border and >0.5 to inside and <0.5 to outside
-                if(current){
-                    d = d + 0.5f;
-                }else{
-                    d = 0.5f - d;
-                }
-
-                unsigned char out = d * 255.0f;
-                sdfGlyph->setPixel(x,y,out);
-            }
-        }
-
         delete g.bitmap;
         g.bitmap = sdfGlyph;
-    }
-}
-
-std::vector<glm::ivec2> TextureAtlas::generateSDFsamples(int searchRadius)
-{
-
-    std::vector<glm::ivec2> samplePositions;
-    for(int x = -searchRadius ; x <= searchRadius ; ++x){
-        for(int y = -searchRadius ; y <= searchRadius ; ++y){
-            if(x!=0 || y!=0)
-                samplePositions.emplace_back(x,y);
-        }
-    }
-    std::sort(samplePositions.begin(),samplePositions.end(),[](const glm::ivec2 &a,const glm::ivec2 &b)->bool
-    {
-        return (a.x*a.x+a.y*a.y)<(b.x*b.x+b.y*b.y);
     });
-
-    //remove samples further away then searchRadius
-    int samples = 0;
-    for(;samples<(int)samplePositions.size();samples++){
-        glm::ivec2 a = samplePositions[samples];
-        if(glm::sqrt((float)(a.x*a.x+a.y*a.y))>searchRadius){
-            break;
-        }
-    }
-    samplePositions.resize(samples);
-
-    return samplePositions;
 }
 
 void TextureAtlas::writeAtlasToFiles(Image& img)
@@ -296,8 +376,8 @@ void TextureAtlas::writeAtlasToFiles(Image& img)
     std::ofstream stream (uniqueFontString,std::ofstream::binary);
     stream.write((char*)&numCharacters,sizeof(uint32_t));
     int i = 0;
-    for(std::pair<const int,character_info> ci : characterInfoMap){
-        stream.write((char*)&ci.second,sizeof(character_info));
+    for(character_info &ci : characters){
+        stream.write((char*)&ci,sizeof(character_info));
         i ++;
     }
 //    cout << i << " Characters written to file." << endl;
@@ -317,7 +397,17 @@ bool TextureAtlas::readAtlasFromFiles()
     for(int i = 0 ; i < numCharacters ; ++i){
         character_info ci;
         stream.read((char*)&ci,sizeof(character_info));
-        characterInfoMap[ci.character] = ci;
+        if(!CodePointTable::validCodePoint(ci.character)){
+            cerr<<"TextureAtlas::readAtlasFromFiles: Invalid code point in "<<uniqueFontString<<endl;
+            return false;
+        }
+        int index = findCharacter(ci.character);
+        if(index >= 0){
+            characters[index] = ci;
+        }else{
+            characterLookup.set(ci.character,characters.size());
+            characters.push_back(ci);
+        }
     }
 //    cout << numCharacters << " Characters read from file." << endl;
     stream.read((char*)&maxCharacter,sizeof(AABB));
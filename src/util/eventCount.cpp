@@ -0,0 +1,60 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/util/eventCount.h"
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <climits>
+#endif
+
+namespace Saiga {
+
+#ifdef __linux__
+
+static_assert(sizeof(std::atomic<unsigned int>) == sizeof(int), "The futex requires a 32 bit word.");
+
+void EventCount::wait(unsigned int key)
+{
+    //the kernel only puts the thread to sleep if the epoch still equals the key
+    while(epoch.load() == key){
+        syscall(SYS_futex, reinterpret_cast<int*>(&epoch), FUTEX_WAIT_PRIVATE, key, nullptr, nullptr, 0);
+    }
+    waiters.fetch_sub(1);
+}
+
+void EventCount::notify(bool all)
+{
+    epoch.fetch_add(1);
+    syscall(SYS_futex, reinterpret_cast<int*>(&epoch), FUTEX_WAKE_PRIVATE, all ? INT_MAX : 1, nullptr, nullptr, 0);
+}
+
+#else
+
+void EventCount::wait(unsigned int key)
+{
+    std::unique_lock<std::mutex> l(lock);
+    cv.wait(l, [this,key](){ return epoch.load() != key; });
+    waiters.fetch_sub(1);
+}
+
+void EventCount::notify(bool all)
+{
+    {
+        std::unique_lock<std::mutex> l(lock);
+        epoch.fetch_add(1);
+    }
+    if(all)
+        cv.notify_all();
+    else
+        cv.notify_one();
+}
+
+#endif
+
+}
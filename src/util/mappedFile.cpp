@@ -0,0 +1,134 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/util/mappedFile.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Saiga {
+
+#if defined(_WIN32)
+
+bool MappedFile::open(const std::string &file)
+{
+    close();
+    HANDLE f = CreateFileA(file.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if(f == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(f, &fileSize)){
+        CloseHandle(f);
+        return false;
+    }
+    fileHandle = f;
+    length = fileSize.QuadPart;
+    opened = true;
+    if(length == 0)
+        return true;
+
+    mappingHandle = CreateFileMappingA(f, NULL, PAGE_READONLY, 0, 0, NULL);
+    if(mappingHandle)
+        ptr = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if(!ptr){
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::close()
+{
+    if(ptr)
+        UnmapViewOfFile(ptr);
+    if(mappingHandle)
+        CloseHandle(mappingHandle);
+    if(fileHandle)
+        CloseHandle(fileHandle);
+    ptr = nullptr;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+    length = 0;
+    opened = false;
+}
+
+#else
+
+bool MappedFile::open(const std::string &file)
+{
+    close();
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+
+    struct stat st;
+    if(fstat(fd, &st) != 0){
+        ::close(fd);
+        return false;
+    }
+    length = st.st_size;
+    if(length > 0){
+        void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(p == MAP_FAILED){
+            ::close(fd);
+            length = 0;
+            return false;
+        }
+        //the file is usually read from front to back
+        madvise(p, length, MADV_SEQUENTIAL);
+        ptr = static_cast<const char*>(p);
+    }
+    //the mapping stays valid after closing the descriptor
+    ::close(fd);
+    opened = true;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if(ptr)
+        munmap(const_cast<char*>(ptr), length);
+    ptr = nullptr;
+    length = 0;
+    opened = false;
+}
+
+#endif
+
+bool MappedFile::fileStats(const std::string &file, uint64_t &size, int64_t &modificationTime)
+{
+#if defined(_WIN32)
+    //the last write time is given in 100ns intervals
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if(!GetFileAttributesExA(file.c_str(), GetFileExInfoStandard, &data))
+        return false;
+    size = (uint64_t(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+    modificationTime = int64_t((uint64_t(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime) * 100;
+#else
+    struct stat st;
+    if(stat(file.c_str(), &st) != 0)
+        return false;
+    size = st.st_size;
+    //st_mtime has only a resolution of one second, which misses edits in the same second as the last load
+#if defined(__APPLE__)
+    modificationTime = int64_t(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+    modificationTime = int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+#endif
+    return true;
+}
+
+}
@@ -0,0 +1,210 @@
+/**
+ * Copyright (c) 2017 Darius Rückert
+ * Licensed under the MIT License.
+ * See LICENSE file for more information.
+ */
+
+#include "saiga/util/taskScheduler.h"
+
+namespace Saiga {
+
+//the scheduler and queue of the current thread, if it is a worker thread
+static thread_local TaskScheduler* currentScheduler = nullptr;
+static thread_local int currentWorker = -1;
+//number of nested TaskGroup::wait calls in this thread
+static thread_local int waitDepth = 0;
+
+//A waiting thread only steals tasks from other queues up to this nesting depth.
+//Stolen tasks can be large and wait themselves, so unlimited stealing could overflow the stack.
+//The own queue is always processed, which guarantees progress.
+#define TASK_MAX_STEAL_DEPTH 8
+
+
+void TaskScheduler::WorkQueue::pushBack(Job &job)
+{
+    std::unique_lock<std::mutex> l(lock);
+    if(count == jobs.size()){
+        //grow and unwrap the ring buffer
+        std::vector<Job> newJobs(std::max<size_t>(64, jobs.size() * 2));
+        for(size_t i = 0 ; i < count ; ++i){
+            newJobs[i] = std::move(jobs[(front + i) % jobs.size()]);
+        }
+        jobs.swap(newJobs);
+        front = 0;
+    }
+    jobs[(front + count) % jobs.size()] = std::move(job);
+    count++;
+}
+
+bool TaskScheduler::WorkQueue::popBack(Job &job)
+{
+    std::unique_lock<std::mutex> l(lock);
+    if(count == 0)
+        return false;
+    count--;
+    job = std::move(jobs[(front + count) % jobs.size()]);
+    return true;
+}
+
+bool TaskScheduler::WorkQueue::popFront(Job &job)
+{
+    std::unique_lock<std::mutex> l(lock);
+    if(count == 0)
+        return false;
+    job = std::move(jobs[front]);
+    front = (front + 1) % jobs.size();
+    count--;
+    return true;
+}
+
+
+TaskScheduler::TaskScheduler(int threads)
+    : queuedJobs(0), nextQueue(0), sleepingWorkers(0)
+{
+    if(threads <= 0)
+        threads = std::thread::hardware_concurrency();
+    threads = std::max(threads,1);
+
+    for(int i = 0 ; i < threads ; ++i){
+        queues.push_back(new WorkQueue());
+    }
+    for(int i = 0 ; i < threads ; ++i){
+        workers.emplace_back(&TaskScheduler::workerFunc,this,i);
+    }
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        std::unique_lock<std::mutex> l(sleepLock);
+        stop = true;
+    }
+    sleepCondition.notify_all();
+    for(std::thread &worker: workers)
+        worker.join();
+    for(WorkQueue* q : queues)
+        delete q;
+}
+
+void TaskScheduler::submit(Task task, TaskGroup *group)
+{
+    Job job;
+    job.task = std::move(task);
+    job.group = group;
+
+    int q;
+    if(currentScheduler == this){
+        q = currentWorker;
+    }else{
+        q = nextQueue++ % queues.size();
+    }
+    queues[q]->pushBack(job);
+    queuedJobs++;
+
+    //the sleeping workers check 'queuedJobs' while holding the lock,
+    //so no wake up can be lost here
+    if(sleepingWorkers > 0){
+        std::unique_lock<std::mutex> l(sleepLock);
+        sleepCondition.notify_one();
+    }
+}
+
+bool TaskScheduler::getJob(int id, Job &job, bool allowSteal)
+{
+    int n = queues.size();
+
+    //first look in the own queue
+    if(id >= 0 && queues[id]->popBack(job)){
+        queuedJobs--;
+        return true;
+    }
+
+    if(!allowSteal)
+        return false;
+
+    //steal from the others, starting at the right neighbour
+    int start = id >= 0 ? id + 1 : nextQueue.load();
+    for(int i = 0 ; i < n ; ++i){
+        int victim = (start + i) % n;
+        if(victim != id && queues[victim]->popFront(job)){
+            queuedJobs--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::execute(Job &job)
+{
+    job.task();
+    //destroy the callable before the group is notified, because it may reference data of the waiting thread
+    job.task.reset();
+    if(job.group)
+        job.group->taskFinished();
+}
+
+bool TaskScheduler::tryRunOne()
+{
+    Job job;
+    int id = currentScheduler == this ? currentWorker : -1;
+    if(!getJob(id,job,waitDepth <= TASK_MAX_STEAL_DEPTH))
+        return false;
+    execute(job);
+    return true;
+}
+
+void TaskScheduler::workerFunc(int id)
+{
+    currentScheduler = this;
+    currentWorker = id;
+
+    Job job;
+    for(;;){
+        if(getJob(id,job,true)){
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> l(sleepLock);
+        if(stop && queuedJobs == 0)
+            return;
+        sleepingWorkers++;
+        sleepCondition.wait(l,[this](){ return stop || queuedJobs > 0; });
+        sleepingWorkers--;
+    }
+}
+
+
+TaskScheduler &defaultTaskScheduler()
+{
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+
+void TaskGroup::taskFinished()
+{
+    //under the lock, so the waiting thread can not miss the notification
+    std::unique_lock<std::mutex> l(lock);
+    if(--pending == 0)
+        finished.notify_all();
+}
+
+void TaskGroup::wait()
+{
+    //help executing tasks and only block if there is nothing to do
+    waitDepth++;
+    while(pending > 0){
+        if(scheduler.tryRunOne())
+            continue;
+        //the other threads are working on the remaining tasks.
+        //tasks of this group can still be added to a queue, so the thread wakes up from time to time to help.
+        std::unique_lock<std::mutex> l(lock);
+        finished.wait_for(l,std::chrono::milliseconds(1),[this](){ return pending == 0; });
+    }
+    //the last taskFinished may still hold the lock. the group can be destroyed after this.
+    std::unique_lock<std::mutex> l(lock);
+    waitDepth--;
+}
+
+}
@@ -8,6 +8,8 @@
 #include "saiga/rendering/deferred_renderer.h"
 #include "saiga/opengl/shader/shaderLoader.h"
 #include "saiga/opengl/texture/textureLoader.h"
+#include "saiga/opengl/asyncReadback.h"
+#include "saiga/util/taskScheduler.h"
 
 #include "saiga/rendering/deferred_renderer.h"
 #include "saiga/rendering/renderer.h"
@@ -231,6 +233,43 @@ void OpenGLWindow::screenshot(const std::string &file)
     TextureLoader::instance()->saveImage(file,img);
 }
 
+void OpenGLWindow::readToImageAsync(std::function<void(std::shared_ptr<Image>)> callback, std::shared_ptr<Image> out)
+{
+    if(!out){
+        out = std::make_shared<Image>();
+        out->width = renderer->windowWidth;
+        out->height = renderer->windowHeight;
+        out->Format() = ImageFormat(3,8,ImageElementFormat::UnsignedNormalized);
+        out->create();
+    }
+
+    if(!readback)
+        readback = std::make_shared<AsyncReadback>();
+    readback->request(out,callback);
+}
+
+void OpenGLWindow::screenshotAsync(const std::string &file)
+{
+    if(!screenshotTasks)
+        screenshotTasks = std::make_shared<TaskGroup>();
+    auto tasks = screenshotTasks;
+
+    readToImageAsync([tasks,file](std::shared_ptr<Image> img){
+        //the png compression takes much longer than the read
+        tasks->run([img,file](){
+            TextureLoader::instance()->saveImage(file,*img);
+        });
+    });
+}
+
+void OpenGLWindow::finishAsyncReads()
+{
+    if(readback)
+        readback->flush();
+    if(screenshotTasks)
+        screenshotTasks->wait();
+}
+
 void OpenGLWindow::screenshotRender(const std::string &file)
 {
     //    cout<<"Window::screenshotRender "<<file<<endl;
@@ -400,6 +439,9 @@ void OpenGLWindow::render(float dt, float interpolation)
     swapBuffers();
     swapBuffersTimer.stop();
 
+    if(readback)
+        readback->update();
+
     fpsTimer.stop();
     fpsTimer.start();
 }
@@ -486,7 +528,7 @@ void OpenGLWindow::startMainLoop(int updatesPerSecond, int framesPerSecond, floa
 
         if(gameTime.getTime() > nextScreenshotTick){
             string file = windowParameters.debugScreenshotPath+getTimeString()+".png";
-            this->screenshot(file);
+            this->screenshotAsync(file);
             nextScreenshotTick += ticksPerScreenshot;
         }
 
@@ -496,6 +538,10 @@ void OpenGLWindow::startMainLoop(int updatesPerSecond, int framesPerSecond, floa
     }
     running = false;
 
+    //the pack buffers are deleted here, because the context may be destroyed before the window
+    finishAsyncReads();
+    readback = nullptr;
+
     if(parallelUpdate){
         //cleanup the update thread
         cout << "Finished main loop. Exiting update thread." << endl;